@@ -0,0 +1,41 @@
+// include/benchmark.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+struct LaunchOptions;
+struct ViewCamera;
+
+// 帧时间统计(毫秒)
+struct FrameStats {
+    double min = 0.0, median = 0.0, p99 = 0.0, mean = 0.0;
+    size_t count = 0;
+
+    static FrameStats From(std::vector<double> samples);
+    nlohmann::json ToJson() const;
+};
+
+// 无头基准测试: 按固定相机路径渲染若干帧, 统计CPU/GPU帧时间
+class Benchmark {
+public:
+    static int Run(GLFWwindow* window, RenderData* data, const LaunchOptions& options);
+    // 纯CPU后端: 不创建任何GL上下文, 适用于无GPU的渲染节点
+    static int RunCpu(RenderData* data, const LaunchOptions& options);
+
+    // 收敛测试: 静止相机下各采样序列累积到options.convergence个样本, 对照高样本数参考图测量RMSE
+    static int RunConvergence(GLFWwindow* window, RenderData* data, const LaunchOptions& options);
+
+    // 尺寸桶复用检查: 在两个尺寸桶之间来回调整渲染目标, 回到访问过的尺寸时不得新建纹理; 失败时返回1
+    static int RunResizeCheck(GLFWwindow* window, RenderData* data, const LaunchOptions& options);
+
+    // 按路径名称和进度t(0~1)设置相机
+    static void ApplyCameraPath(RenderData* data, const string& path, float t);
+    // 路径上的相机基(视口尺寸为0, 由调用方填写)
+    static ViewCamera PathCamera(const string& path, float t, const vec3& worldUp);
+
+private:
+    static int WriteResults(nlohmann::json report, const LaunchOptions& options,
+        int width, int height, const std::vector<float>& pixels);
+};
+}
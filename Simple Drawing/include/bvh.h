@@ -0,0 +1,106 @@
+// include/bvh.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+class ThreadPool;
+
+// BVH缓冲区绑定点(与common/scene.glsl中的binding一致)
+enum BvhBinding {
+    BVH_BINDING_NODES = 6,
+    BVH_BINDING_PRIMITIVES = 7
+};
+
+/*
+    32字节紧凑节点, 按深度优先顺序排列: 内部节点的左子节点紧随其后(index + 1),
+    offset存放右子节点索引; 叶子节点offset为首个图元在primIndices中的位置, count为图元数.
+    GPU端以两个vec4读取, offset/count通过floatBitsToInt还原.
+*/
+struct BvhNode {
+    float boundsMin[3];
+    int offset;
+    float boundsMax[3];
+    int count;   // 大于0为叶子
+};
+static_assert(sizeof(BvhNode) == 32, "BvhNode必须为32字节");
+
+// 构建统计
+struct BvhBuildStats {
+    int primitiveCount = 0;
+    int nodeCount = 0;
+    int leafCount = 0;
+    int maxDepth = 0;
+    int maxLeafSize = 0;
+    double sahCost = 0.0;
+    double buildMs = 0.0;
+
+    nlohmann::json ToJson() const;
+};
+
+/*
+    分箱SAH(binned SAH)构建器: 每个节点在三个轴上各分16个箱计算划分代价,
+    图元数较多的子树交给其他线程并行构建, 最后展平为深度优先的节点数组.
+    叶子深度限制在kMaxStackDepth - 1以内(接近上限时改为中位数划分), 遍历栈不会溢出.
+
+    动态场景: 图元移动后只更新其包围盒, Refit()自底向上重新计算所在叶子及祖先的包围盒(拓扑不变),
+    同一深度的节点互不依赖, 按层并行. SAH代价随refit增量维护, 退化超过kRebuildThreshold倍时由调用方重建.
+*/
+class Bvh {
+public:
+    static constexpr int kBinCount = 16;
+    static constexpr int kMaxLeafSize = 8;
+    static constexpr int kParallelThreshold = 4096;   // 超过该图元数的子树异步构建
+    static constexpr int kMaxStackDepth = 48;         // 遍历栈大小(与着色器BVH_STACK_SIZE一致)
+    static constexpr double kRebuildThreshold = 1.5;  // refit后SAH代价超过构建时的倍数即需要重建
+    static constexpr int kParallelRefit = 2048;       // 同一层的脏节点超过该数时并行refit
+
+    std::vector<BvhNode> nodes;
+    std::vector<int> primIndices;
+    BvhBuildStats stats;
+
+    // 拓扑(构建时生成, refit时使用)
+    std::vector<int> parents;          // 父节点, 根为-1
+    std::vector<int> depths;           // 节点深度
+    std::vector<int> primitiveLeaf;    // 图元所在的叶子
+
+    // GPU缓冲区
+    unsigned int nodeBuffer = 0;
+    unsigned int primitiveBuffer = 0;
+
+    Bvh() = default;
+    ~Bvh();
+    Bvh(const Bvh&) = delete;
+    Bvh& operator=(const Bvh&) = delete;
+
+    // 由每个图元的包围盒构建
+    void Build(const std::vector<vec3>& boundsMin, const std::vector<vec3>& boundsMax);
+
+    // 以表面积启发式计算整棵树的代价(遍历代价与求交代价均取1)
+    double ComputeSahCost() const;
+
+    // 更新单个图元的包围盒, 记为脏, 由下一次Refit统一处理
+    void UpdatePrimitive(int primitive, const vec3& boundsMin, const vec3& boundsMax);
+    int DirtyCount() const { return static_cast<int>(m_dirtyPrimitives.size()); }
+    // 重新计算脏图元所在叶子及其祖先的包围盒, 返回被修改的节点(升序, 用于部分上传)
+    const std::vector<int>& Refit(ThreadPool* pool = nullptr);
+    // 当前SAH代价(refit时增量维护, 不遍历整棵树)
+    double SahCost() const;
+    bool NeedsRebuild() const { return SahCost() > stats.sahCost * kRebuildThreshold; }
+
+    void Upload();
+    void Bind() const;
+    void Release();
+
+private:
+    void BuildTopology();
+    double RefitNode(int node);   // 返回加权面积的变化量
+
+    std::vector<vec3> m_boundsMin, m_boundsMax;   // 各图元当前的包围盒
+    std::vector<int> m_dirtyPrimitives;
+    std::vector<unsigned int> m_marks;            // 收集脏节点时的访问标记(按代号, 无需每次清零)
+    unsigned int m_markGeneration = 0;
+    std::vector<int> m_refitNodes;
+    std::vector<double> m_refitDeltas;
+    double m_weightedArea = 0.0;                  // sum(面积 * 权重), 权重为叶子的图元数或内部节点的1
+};
+}
@@ -0,0 +1,87 @@
+// include/cpu_tracer.h
+#pragma once
+#include "sampler.h"
+
+// 光线包内核在运行时按CPU选择指令集: GCC在x86上另编译一份AVX2+FMA内核(见cpu_packet_avx2.cpp),
+// 其余代码只使用基线指令集(x86-64为SSE2), 不支持AVX2的机器(包括渲染农场的工作节点)同样可以运行
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+    #define SD_SIMD_DISPATCH_AVX2 1
+#else
+    #define SD_SIMD_DISPATCH_AVX2 0
+#endif
+
+namespace SimpleDrawingDemo {
+
+class ThreadPool;
+struct Scene;
+
+// CPU端相机/帧参数(与计算着色器uniform一致)
+struct CpuCamera {
+    vec3 pos;
+    vec3 front;
+    vec3 right;
+    vec3 up;
+    float time = 0.0f;
+    int frameIndex = 0;       // 已累积帧数
+    bool accumulate = false;  // 渐进累积模式
+    bool denoise = false;     // 输出线性颜色与G-buffer(由CpuDenoiser滤波与色调映射)
+};
+
+// 色调映射与Gamma校正(与着色器toneMap一致)
+inline vec3 ToneMap(vec3 color) {
+    color = color / (color + vec3(1.0f));
+    return glm::pow(color, vec3(1.0f / 2.2f));
+}
+
+/*
+    CPU参考光线追踪器, 逐项复刻ray_tracing.glsl(场景遍历、多次反弹、阴影与高光逻辑).
+    画面按16x16分块分发到线程池, 每块内以4x2像素的8路光线包(AVX2/SSE, 运行时选择)追踪.
+    输出为RGBA float, 行顺序与输出纹理一致, 可直接上传或写入文件.
+    denoise模式下输出色调映射前的线性颜色, 另外输出首次命中的G-buffer(布局同common/scene.glsl).
+*/
+class CpuTracer {
+public:
+    static constexpr int kTileSize = 16;
+    static constexpr int kPacketWidth = 4;     // 包内像素布局: 4x2
+    static constexpr int kPacketHeight = 2;
+
+    explicit CpuTracer(const Scene* scene, ThreadPool* pool = nullptr);
+
+    void SetMaxBounces(int bounces) { m_maxBounces = bounces; }   // 与GPU后端的MAX_BOUNCES一致
+    void SetSampler(SamplerType type) { m_sampler = type; }       // 与GPU后端的SAMPLER一致
+
+    void Render(const CpuCamera& camera, int width, int height);
+    // 只渲染width x height画面中的指定分块(按行主序编号), 其余像素保持不变(渲染农场的工作进程与本地兜底)
+    void RenderTiles(const CpuCamera& camera, int width, int height, const std::vector<int>& tiles);
+
+    const std::vector<float>& Pixels() const { return m_pixels; }
+    const std::vector<float>& NormalDepth() const { return m_normalDepth; }   // xyz=法线, w=线性深度
+    const std::vector<float>& AlbedoId() const { return m_albedoId; }         // rgb=反照率, a=命中物体的材质索引
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    int ThreadCount() const;
+    static const char* SimdName();   // 本机使用的光线包指令集
+
+private:
+    void Resize(const CpuCamera& camera, int width, int height);
+    void RenderTile(const CpuCamera& camera, int tileX, int tileY);
+    static bool UseAvx2();
+
+    // 同一内核(cpu_packet_kernel.inl)按各指令集编译的版本
+    void TracePacketBaseline(const CpuCamera& camera, int x0, int y0);
+#if SD_SIMD_DISPATCH_AVX2
+    void TracePacketAvx2(const CpuCamera& camera, int x0, int y0);
+#endif
+
+    const Scene* m_scene;
+    ThreadPool* m_pool;
+    int m_maxBounces = 3;
+    SamplerType m_sampler = SamplerType::Sobol;
+
+    std::vector<float> m_pixels;
+    std::vector<float> m_history;   // 累积历史(线性RGB)
+    std::vector<float> m_normalDepth;
+    std::vector<float> m_albedoId;
+    int m_width = 0, m_height = 0;
+};
+}
@@ -5,3 +5,14 @@
 #define VSH_PATH "../resources/shaders/vertex/"
 #define GSH_PATH "../resources/shaders/geometry/"
 #define CSH_PATH "../resources/shaders/compute/"
+#define SHADER_PATH "../resources/shaders/"
+#define SCENE_PATH "../resources/scenes/"
+#define SHADER_CACHE_PATH "../cache/shaders/"
+#define MESH_CACHE_PATH "../cache/meshes/"
+#define AUTOTUNE_PATH "../cache/autotune.json"
+#define BLUE_NOISE_PATH "../cache/blue_noise_64.bin"
+
+// 性能分析器开关: 设为0时PROFILE_*宏展开为空, 不产生任何开销
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
@@ -0,0 +1,79 @@
+// include/denoiser.h
+#pragma once
+#include "render_targets.h"
+
+namespace SimpleDrawingDemo {
+
+class ThreadPool;
+class CpuTracer;
+struct CpuCamera;
+struct RenderData;
+
+// 滤波参数(GPU与CPU实现共用)
+struct DenoiseParams {
+    static constexpr int kMinIterations = 1;
+    static constexpr int kMaxIterations = 5;
+    static constexpr int kDefaultIterations = 4;
+
+    float sigmaNormal = 128.0f;    // 法线权重 pow(max(dot(n, n'), 0), sigmaNormal)
+    float sigmaDepth = 1.0f;       // 深度容差, 以(跨步后的)像素足迹为单位
+    float sigmaLuminance = 4.0f;   // 亮度容差, 以亮度标准差为单位
+};
+
+/*
+    边缘保持的à-trous小波降噪(SVGF的空间滤波部分):
+    追踪pass输出累积后的线性颜色与首次命中的G-buffer, 每次迭代以2^i为间隔做5x5 B3样条滤波,
+    权重乘以法线/深度/亮度三项边缘停止函数. 第一次迭代由邻域亮度矩估计方差,
+    之后按sum(w^2 var) / sum(w)^2传递. 最后一次迭代色调映射后写入输出目标.
+*/
+class Denoiser {
+public:
+    explicit Denoiser(const string& defines);
+    ~Denoiser();
+    Denoiser(const Denoiser&) = delete;
+    Denoiser& operator=(const Denoiser&) = delete;
+
+    // 对data的noisyTarget(时域模式下为重投影历史)做iterations次迭代, 结果写入outputTarget(图像单元0)
+    void Run(const RenderData& data, int iterations);
+
+    // 程序(热重载直接替换)与源文件
+    unsigned int* Program() { return &m_program; }
+    static string ShaderPath();
+    void Reflect();    // 重新查询uniform位置(重载后调用)
+
+    DenoiseParams params;
+
+private:
+    unsigned int m_program = 0;
+    int m_stepLocation = -1;
+    int m_finalLocation = -1;
+    int m_sigmaNormalLocation = -1;
+    int m_sigmaDepthLocation = -1;
+    int m_sigmaLuminanceLocation = -1;
+};
+
+/*
+    CPU实现, 与denoise.glsl逐项一致(中间结果为float, GPU为rgba16f).
+    输入为CpuTracer在denoise模式下输出的线性颜色与G-buffer, 每次迭代按行分发到线程池.
+*/
+class CpuDenoiser {
+public:
+    explicit CpuDenoiser(ThreadPool* pool = nullptr);
+
+    // camera需与tracer本帧的Render参数一致
+    void Run(const CpuTracer& tracer, const CpuCamera& camera, int iterations);
+
+    // 色调映射后的RGBA float, 与CpuTracer::Pixels布局一致
+    const std::vector<float>& Pixels() const { return m_pixels; }
+
+    DenoiseParams params;
+
+private:
+    void FilterRow(const CpuTracer& tracer, const vec3& cameraFront, const float* input, float* output,
+                   int y, int step, bool finalPass);
+
+    ThreadPool* m_pool;
+    std::vector<float> m_buffers[2];   // 乒乓: rgb=颜色, a=方差
+    std::vector<float> m_pixels;
+};
+}
@@ -0,0 +1,63 @@
+// include/dirty_tracker.h
+#pragma once
+#include "sampler.h"
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+// 按需渲染的统计(渲染线程退出时输出)
+struct IdleStats {
+    long long renderedFrames = 0;    // 实际追踪的帧
+    long long presentedFrames = 0;   // 只重新显示上一帧(窗口重绘请求)
+    long long skippedFrames = 0;     // 状态未变而跳过的帧
+    double idleSeconds = 0.0;        // 阻塞等待新快照的总时长
+};
+
+/*
+    按需渲染的状态追踪: 记录上一次追踪时影响画面的全部状态(相机、渲染尺寸与目标、各模式开关、
+    采样序列与计算着色器程序), 状态不变、场景没有待上传的改动且没有显式失效(着色器重载)时跳过整帧,
+    outputTarget与窗口上的画面保持不变.
+    仍在收敛的模式继续渲染: 累积到kMaxAccumulatedFrames帧为止, 时域重投影在最后一次变化后再渲染kTemporalSettleFrames帧.
+    time只驱动胶片颗粒(光源动画经SceneAnimator表现为场景改动), 不视为画面变化: 静止时颗粒保持最后一帧.
+*/
+class DirtyTracker {
+public:
+    static constexpr int kMaxAccumulatedFrames = 1024;   // 之后每帧的混合权重不到1/1024, 画面已无可见变化
+    static constexpr int kTemporalSettleFrames = 32;     // 时域历史的指数混合收敛所需的帧数
+
+    // 本帧是否需要追踪
+    bool NeedsFrame(const RenderData& data) const;
+    // 包围一次追踪: 帧内又改变了状态(应用待处理的尺寸、动态分辨率调整比例)时下一帧仍需追踪
+    void BeginFrame(const RenderData& data);
+    void EndFrame(const RenderData& data);
+    void Presented() { m_stats.presentedFrames++; }
+    void Skipped(double idleSeconds);
+    // 状态之外的变化(着色器热重载)
+    void Invalidate() { m_dirty = true; }
+
+    const IdleStats& Stats() const { return m_stats; }
+
+private:
+    struct State {
+        vec3 cameraPos, cameraFront, cameraRight, cameraUp;
+        int screenWidth = 0, screenHeight = 0;
+        int renderWidth = 0, renderHeight = 0;
+        int targetWidth = 0, targetHeight = 0;   // 输出图像每帧轮换, 只比较分配尺寸
+        unsigned int program = 0;
+        bool accumulate = false, denoise = false, temporal = false;
+        int denoiseIterations = 0;
+        SamplerType sampler = SamplerType::Sobol;
+        uint32_t samplerScramble = 0;
+
+        bool operator==(const State& other) const = default;
+    };
+    static State Capture(const RenderData& data);
+
+    State m_state;           // 最近一次追踪时的状态
+    State m_pending;         // 本帧开始时的状态
+    bool m_dirty = true;     // 尚未渲染过或被显式失效
+    int m_settleFrames = 0;  // 时域模式剩余的收敛帧数
+    IdleStats m_stats;
+};
+}
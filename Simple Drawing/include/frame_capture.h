@@ -0,0 +1,85 @@
+// include/frame_capture.h
+#pragma once
+#include <condition_variable>
+
+namespace SimpleDrawingDemo {
+
+/*
+    异步帧捕获: 每帧把输出纹理读入PBO环(持久映射 + 栅栏), 之后的帧上非阻塞检查栅栏,
+    完成的帧交给写入线程. 主线程只提交读回命令, 不等待GPU也不做文件IO.
+    环满时主线程会等待空闲槽位(计入stalls), 从不丢帧.
+
+    输出目标:
+    - "-"           原始RGBA8帧写到stdout(可直接管道给编码器, 行序从上到下)
+    - ".raw"        原始RGBA8帧写入单个文件
+    - ".png" / ".pfm" 逐帧编号的图像文件; 路径可包含一个%d/%05d形式的编号(如frame_%05d.png, 字面%写作%%),
+                      否则自动追加编号
+*/
+class FrameCapture {
+public:
+    enum class Mode { Raw, Png, Pfm };
+    static constexpr int kRingSize = 4;
+
+    explicit FrameCapture(const string& target);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    bool IsOpen() const { return m_open; }
+    Mode GetMode() const { return m_mode; }
+
+    // 提交当前帧的读回(纹理左下角width x height区域), 需在GL线程调用
+    void Capture(unsigned int texture, int width, int height);
+    // 等待所有在途帧写完
+    void Finish();
+
+    void PrintStats() const;
+
+private:
+    enum class SlotState { Free, InFlight, Writing };
+    struct Slot {
+        unsigned int buffer = 0;
+        void* mapped = nullptr;      // 持久映射指针(写入线程直接读取)
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+        int width = 0, height = 0;
+        long long frame = 0;
+        SlotState state = SlotState::Free;
+    };
+
+    void Poll(bool wait);             // 把已完成的在途帧交给写入线程
+    void EnsureCapacity(Slot& slot, size_t bytes);
+    void WriterThread();
+    bool WriteFrame(const Slot& slot);
+    bool ParsePattern(const string& target);
+    string FramePath(long long frame) const;
+
+    Mode m_mode = Mode::Raw;
+    string m_target;
+    string m_pathPrefix, m_pathSuffix;   // 图像序列路径中编号之前/之后的部分
+    int m_frameWidth = 0;             // 编号的最小宽度
+    char m_framePad = '0';
+    FILE* m_stream = nullptr;         // Raw模式的输出流
+    bool m_open = false;
+    int m_bytesPerPixel = 4;
+
+    Slot m_slots[kRingSize];
+    int m_next = 0;                   // 下一个提交的槽位
+    std::deque<int> m_inFlight;       // 按帧顺序的在途槽位
+    long long m_frameCount = 0;
+    int m_rawWidth = 0, m_rawHeight = 0;   // Raw流的帧尺寸(必须固定)
+
+    std::mutex m_mutex;
+    std::condition_variable m_slotFreed, m_work;
+    std::deque<int> m_queue;          // 待写入的槽位
+    bool m_stop = false;
+    std::thread m_writer;
+
+    // 统计
+    double m_mainMs = 0.0;            // 主线程在Capture中的总耗时
+    double m_maxMainMs = 0.0;
+    int m_stalls = 0;                 // 等待空闲槽位的次数
+    std::atomic<long long> m_written{ 0 };
+    std::atomic<int> m_failed{ 0 };
+};
+}
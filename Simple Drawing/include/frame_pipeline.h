@@ -0,0 +1,60 @@
+// include/frame_pipeline.h
+#pragma once
+#include "render_targets.h"
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+/*
+    帧流水线: framesInFlight张输出图像轮换使用, 每帧结束时插入栅栏(glFenceSync).
+    第N+1帧的追踪写入另一张输出图像, 不再与第N帧blit对同一纹理的读取形成写后读依赖, 两帧可以在GPU上重叠;
+    复用一张输出图像前等待它上一次的栅栏, 在途帧数因此不超过framesInFlight, CPU不会无限领先GPU.
+    - 1(低延迟): 每帧开始前等待上一帧在GPU上完成, 渲染线程随后取到的快照总是最新的输入
+    - 2~3(高吞吐): CPU提交与GPU执行重叠, 画面最多落后输入framesInFlight帧
+    当前输出图像始终借给RenderData::outputTarget(图像单元0), 其余的由流水线持有, 尺寸随outputTarget调整.
+    累积历史、G-buffer等跨帧读写的目标仍只有一份, 这些模式下相邻帧之间的依赖不变.
+    每帧另记录提交时刻的GPU时钟与帧末的时间戳查询, 栅栏通过后两者之差即为从提交到GPU完成的延迟.
+*/
+class FramePipeline {
+public:
+    static constexpr int kMaxFramesInFlight = 3;
+
+    FramePipeline(RenderData& data, int framesInFlight);
+    ~FramePipeline();
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // 等待下一张输出图像空闲(在途帧数达到上限时阻塞); 低延迟模式下应在取输入之前调用
+    void Throttle();
+    // 帧开始: 轮换到下一张输出图像并绑定到图像单元0
+    void BeginFrame(RenderData& data);
+    // 帧末(blit与捕获之后): 插入时间戳查询与栅栏
+    void EndFrame();
+    // 等待全部在途帧完成
+    void Drain();
+
+    // outputTarget重新分配后, 按同一尺寸重新获取其余输出图像
+    void Resize(RenderData& data);
+    void Release(RenderTargetPool& pool);
+
+    // 取出并清空已完成帧的测量(毫秒): 提交到GPU完成的延迟 / Throttle中阻塞等待栅栏的时长
+    void TakeSamples(std::vector<double>& latencyMs, std::vector<double>& fenceWaitMs);
+
+    int FramesInFlight() const { return static_cast<int>(m_slots.size()); }
+
+private:
+    struct Slot {
+        RenderTarget target;          // 借给outputTarget期间为空
+        GLsync fence = nullptr;
+        unsigned int query = 0;       // 帧末的GL_TIMESTAMP
+        GLint64 submitTime = 0;       // 帧开始时的GPU时钟
+    };
+    void Wait(Slot& slot, bool recordWait);
+
+    std::vector<Slot> m_slots;
+    int m_current = 0;                // 当前借给outputTarget的槽位
+    std::vector<double> m_latencyMs;
+    std::vector<double> m_fenceWaitMs;
+};
+}
@@ -0,0 +1,26 @@
+// include/frame_uniforms.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// UBO绑定点
+enum UniformBinding {
+    UNIFORM_BINDING_FRAME = 0
+};
+
+/*
+    每帧uniform数据, 与common/frame.glsl中的FrameData块(std140)逐字节一致:
+    std140下vec3按16字节对齐, 其后的标量正好占用第4个分量.
+    renderWidth/renderHeight为动态分辨率下的实际追踪区域(渲染目标左下角).
+    numSpheres同时是三角形图元索引的起点(图元索引 = numSpheres + 三角形索引).
+*/
+struct FrameUniforms {
+    vec3 cameraPos;   float time;
+    vec3 cameraFront; int frameIndex;
+    vec3 cameraRight; int numSpheres;
+    vec3 cameraUp;    int numLights;
+    int accumulate;   int renderWidth; int renderHeight; int denoise;
+    int temporal;     int jitterIndex;   int numTriangles; int padding;
+};
+static_assert(sizeof(FrameUniforms) == 96, "FrameUniforms必须与std140布局一致");
+}
@@ -0,0 +1,30 @@
+// include/gpu_timer.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// GPU计时器: GL_TIMESTAMP查询对组成的环, 结果延迟若干帧读取, 避免CPU等待GPU
+// 使用时间戳而非GL_TIME_ELAPSED, 多个计时器可以相互嵌套
+class GpuTimer {
+public:
+    explicit GpuTimer(int ringSize = 8);
+    ~GpuTimer();
+
+    void Begin();
+    void End();
+
+    // 非阻塞读取一个已完成的结果(毫秒), 按提交顺序返回
+    bool Poll(double& ms);
+    // 阻塞等待全部未完成的查询
+    void Drain(std::vector<double>& out);
+
+private:
+    double ReadOldest();   // 阻塞读取最早的查询
+    int SlotCount() const { return static_cast<int>(m_queries.size()) / 2; }
+
+    std::vector<unsigned int> m_queries;   // 每个槽两个查询: 开始/结束时间戳
+    std::deque<double> m_ready;  // 环满时被迫提前读取的结果
+    int m_head = 0;              // 下一个写入槽
+    int m_pending = 0;           // 已提交未读取的查询数
+};
+}
@@ -0,0 +1,18 @@
+// include/image_io.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// 图像读写工具(用于离屏渲染结果输出与黄金图像比对)
+// 像素均为RGBA float, 行顺序与OpenGL一致(第0行为图像底部)
+struct ImageIO {
+    static std::vector<float> ReadTexture(unsigned int texture, int width, int height);
+
+    // 按扩展名选择格式(.pfm / .ppm / .png)
+    static bool Write(const string& path, int width, int height, const std::vector<float>& rgba);
+    static bool WritePFM(const string& path, int width, int height, const float* rgba);
+    static bool WritePPM(const string& path, int width, int height, const float* rgba);
+    // PNG: 8位RGBA输入, 仅使用未压缩的deflate块(不依赖zlib, 写入速度优先)
+    static bool WritePNG(const string& path, int width, int height, const unsigned char* rgba);
+};
+}
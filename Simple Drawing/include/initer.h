@@ -3,9 +3,11 @@
 
 namespace SimpleDrawingDemo {
 
+struct LaunchOptions;
+
 class Initer {
 public:
-    static GLFWwindow* InitWindow();
+    static GLFWwindow* InitWindow(const LaunchOptions& options);
     static void CleanResources(RenderData** data);
 };
 } // namespace SimpleDrawingDemo
@@ -0,0 +1,90 @@
+// include/launch_options.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// 命令行启动参数
+struct LaunchOptions {
+    // 窗口/渲染分辨率
+    int width = 1920;
+    int height = 1080;
+
+    // 场景文件(为空则使用默认场景)
+    string scenePath;
+    int randomSpheres = 0;       // 大于0时生成随机场景(大规模场景测试)
+
+    // 内部渲染比例(0.1~1), targetMs大于0时按帧时间自动调整
+    float renderScale = 1.0f;
+    double targetMs = 0.0;
+
+    // 渲染目标格式: rgba32f / rgba16f / r11g11b10f / rgba8
+    string outputFormat = "rgba8";      // 输出已色调映射到[0,1], 8位足够
+    string historyFormat = "rgba16f";   // 累积历史为线性HDR, 需要浮点
+
+    // 渲染后端: gpu / cpu
+    string backend = "gpu";
+
+    // 渐进累积模式(相机静止时逐帧收敛)
+    bool accumulate = false;
+
+    // 边缘保持降噪的迭代次数(0为关闭, 运行时按N切换)
+    int denoise = 0;
+
+    // 时域重投影(相机移动时复用上一帧历史, 运行时按T切换)
+    bool temporal = false;
+
+    // 反弹次数(编译为着色器宏MAX_BOUNCES, CPU后端一致)
+    int bounces = 3;
+
+    // 子像素抖动的采样序列: hash / r2 / sobol / bluenoise
+    string sampler = "sobol";
+    int convergence = 0;         // 大于0时运行收敛测试: 各采样序列累积到N个样本, 对照参考图测量RMSE
+    bool resizeCheck = false;    // 无头模式: 在两个尺寸桶之间来回调整渲染目标, 检查回到原尺寸时复用同一批纹理
+
+    // 单内核的工作组形状, 如"32x8"(为空时使用保存的调优结果, 没有则为16x16)
+    string workgroup;
+    bool autotune = false;       // 启动时测量各候选形状, 选用并保存最快的
+
+    // 多视图: 每帧以一次分派渲染N个转台视图到纹理数组(仅gpu后端, 无头模式)
+    int views = 0;
+
+    // 场景动画: 光源随lightPos移动, 按该比例选取的球体上下浮动(0为静止场景)
+    float animate = 0.0f;
+
+    // 主光线按屏幕分块的图元列表求交(仅gpu后端)
+    bool tileBinning = false;
+
+    // 渲染农场(仅cpu后端): 启动N个本机工作进程, 画面按16x16分块经Unix域套接字分发
+    int farm = 0;
+    string farmSocket;           // 协调进程监听的套接字路径(为空时使用/tmp下按pid命名的路径)
+    string farmWorker;           // 非空时作为工作进程运行, 连接该路径上的协调进程
+    int farmFault = 0;           // 测试用: 第一个工作进程渲染N个分块后不回传结果直接退出
+
+    // 按需渲染: 画面不变时跳过追踪并等待输入(交互模式, 场景动画或逐帧捕获时关闭)
+    bool idle = true;
+
+    // 在途帧数上限(输出图像数): 1为低延迟, 3为高吞吐
+    int framesInFlight = 2;
+
+    // 着色器程序二进制缓存(关闭后每次都重新编译, 用于测量冷启动)
+    bool shaderCache = true;
+
+    // 无头(离屏)基准测试模式
+    bool headless = false;       // 隐藏窗口运行, 不调用glfwSwapBuffers
+    bool useEGL = false;         // 使用EGL创建上下文(Mesa llvmpipe等无显示环境)
+    int frames = 300;            // 计时帧数
+    int warmup = 30;             // 预热帧数(不计入统计)
+    string cameraPath = "orbit"; // 固定相机路径: static / orbit / dolly
+    string reportPath;           // 帧时间JSON输出路径(为空则输出到stdout)
+    string dumpPath;             // 最终输出纹理的输出路径(.pfm / .ppm)
+
+    // 退出时导出的性能trace(Chrome trace_event JSON), 为空则不导出
+    string tracePath;
+
+    // 逐帧异步捕获目标: "-"(stdout原始流) / *.raw / *.png / *.pfm, 为空则不捕获
+    string capturePath;
+
+    static LaunchOptions Parse(int argc, char** argv);
+    static void PrintUsage();
+};
+}
@@ -2,17 +2,31 @@
 #pragma once
 
 namespace SimpleDrawingDemo {
+
+class Simulation;
+class ShaderReloader;
+
 class MainLoop {
 public:
+    // 是否交换缓冲(无头模式下关闭)
+    inline static bool s_presentEnabled = true;
+    // 是否在帧末处理窗口事件(渲染线程独立时由主线程处理)
+    inline static bool s_pollEvents = true;
+
+    // 按需渲染时没有新快照的等待超时(秒), 超时后仍检查着色器热重载
+    static constexpr double kIdlePollSeconds = 0.1;
+
     static void RenderLoop(GLFWwindow* window, RenderData* data);
-    static void InputHandles(GLFWwindow* window);
+    // 只把上一帧的输出重新显示到窗口(不追踪)
+    static void Present(GLFWwindow* window, RenderData* data);
     static void BeginFrame(GLFWwindow* window);
     static void EndFrame(GLFWwindow* window);
-    
-    // 鼠标位置回调
-    static void MousePosCallback(GLFWwindow* window, double xpos, double ypos);
-    
-    // 窗口大小回调
-    static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
+
+    // 渲染线程入口: 消费模拟快照并渲染, 直到running被清除
+    static void RenderThread(GLFWwindow* window, RenderData* data, Simulation* simulation,
+        ShaderReloader* reloader, const std::atomic<bool>& running);
+
+private:
+    static void Blit(RenderData* data);
 };
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+// include/mapped_file.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+/*
+    只读内存映射文件(Windows为CreateFileMapping, 其余平台为mmap).
+    页面由系统按需换入, 大文件无需整体读入内存.
+*/
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射整个文件, 失败(不存在或为空)时返回false
+    bool Open(const string& path);
+    void Close();
+
+    const unsigned char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    bool IsOpen() const { return m_data != nullptr; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = NULL;
+#endif
+};
+}
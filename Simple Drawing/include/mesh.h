@@ -0,0 +1,68 @@
+// include/mesh.h
+#pragma once
+#include <cstdint>
+#include "mapped_file.h"
+
+namespace SimpleDrawingDemo {
+
+class ThreadPool;
+
+// 网格加载统计(写入基准测试报告)
+struct MeshLoadStats {
+    string path;
+    bool fromCache = false;   // 直接映射了二进制缓存
+    int triangleCount = 0;
+    double parseMs = 0.0;     // OBJ解析耗时(命中缓存时为0)
+    double loadMs = 0.0;      // 总耗时(含映射缓存/写入缓存)
+    double convertMs = 0.0;   // 展开为场景的三角形记录(映射缓存时页面在这一步才真正读入)
+
+    nlohmann::json ToJson() const;
+};
+
+/*
+    索引三角形网格(位置与法线分别索引, 与OBJ一致).
+    首次加载OBJ时把文件切成按行对齐的块, 在线程池上并行解析, 结果写入二进制缓存(MESH_CACHE_PATH);
+    之后的启动直接映射缓存文件, 各数组指针指向映射内存, 不再逐顶点解析.
+    缓存以源文件的大小与修改时间校验, OBJ改动后自动重建; 索引越界的缓存视为未命中, 重新解析.
+    Load成功后所有索引都在范围内.
+*/
+class Mesh {
+public:
+    static constexpr uint32_t kNoNormal = 0xffffffffu;   // 面没有指定法线(使用几何法线)
+
+    Mesh() = default;
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // 加载OBJ(优先使用缓存), 失败时返回false
+    bool Load(const string& path, ThreadPool* pool = nullptr);
+
+    const vec3* Positions() const { return m_positions; }
+    const vec3* Normals() const { return m_normals; }                   // 没有法线时为nullptr
+    const uint32_t* Indices() const { return m_indices; }               // 每个三角形3个位置索引
+    const uint32_t* NormalIndices() const { return m_normalIndices; }   // 与Indices一一对应, 没有法线时为nullptr
+    uint32_t PositionCount() const { return m_positionCount; }
+    uint32_t NormalCount() const { return m_normalCount; }
+    uint32_t TriangleCount() const { return m_triangleCount; }
+    const MeshLoadStats& Stats() const { return m_stats; }
+
+private:
+    bool ParseObj(const string& path, ThreadPool& pool);
+    bool MapCache(const string& cachePath, uint64_t sourceSize, int64_t sourceTime, ThreadPool& pool);
+    bool IndicesInRange(ThreadPool& pool) const;
+    void WriteCache(const string& cachePath, uint64_t sourceSize, int64_t sourceTime) const;
+    void PointToParsed();
+
+    const vec3* m_positions = nullptr;
+    const vec3* m_normals = nullptr;
+    const uint32_t* m_indices = nullptr;
+    const uint32_t* m_normalIndices = nullptr;
+    uint32_t m_positionCount = 0, m_normalCount = 0, m_triangleCount = 0;
+    MeshLoadStats m_stats;
+
+    MappedFile m_cache;
+    // 本次解析的结果(未命中缓存时使用)
+    std::vector<vec3> m_parsedPositions, m_parsedNormals;
+    std::vector<uint32_t> m_parsedIndices, m_parsedNormalIndices;
+};
+}
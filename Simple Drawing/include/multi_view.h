@@ -0,0 +1,74 @@
+// include/multi_view.h
+#pragma once
+#include "render_targets.h"
+#include "workgroup_tuner.h"
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+// 视图数组的SSBO绑定点(与ray_tracing.glsl的Views块一致, 接在分块列表之后)
+enum MultiViewBinding {
+    MULTI_VIEW_BINDING_VIEWS = 16
+};
+
+// 一个视图: 相机基与在纹理数组对应层中的视口
+struct ViewCamera {
+    vec3 pos;
+    vec3 front;
+    vec3 right;
+    vec3 up;
+    int x = 0, y = 0;             // 视口在层内的偏移
+    int width = 0, height = 0;    // 视图自己的分辨率
+};
+
+/*
+    批量多视图渲染(缩略图、转台、立方体贴图各面): 各视图的相机基写入SSBO,
+    单内核以MULTI_VIEW变体编译, 一次glDispatchCompute(w, h, 视图数)渲染全部视图,
+    gl_GlobalInvocationID.z为视图序号, 结果写入GL_TEXTURE_2D_ARRAY的对应层.
+    与逐视图渲染相比省去每个视图的uniform设置、分派与屏障, 场景数据在各视图之间保持在缓存中.
+    纹理数组的格式与输出目标一致, 只增不减; 每层的尺寸为各视口右上角的最大值.
+    多视图只输出色调映射后的单帧结果(不累积、不降噪).
+*/
+class MultiViewRenderer {
+public:
+    // std430布局(与着色器的ViewData一致)
+    struct ViewData {
+        vec4 pos, front, right, up;
+        int viewport[4];
+    };
+    static_assert(sizeof(ViewData) == 80, "ViewData必须与std430布局一致");
+
+    explicit MultiViewRenderer(const RenderData& data);
+    ~MultiViewRenderer();
+    MultiViewRenderer(const MultiViewRenderer&) = delete;
+    MultiViewRenderer& operator=(const MultiViewRenderer&) = delete;
+
+    // 渲染全部视图(一次分派); 结束后图像单元0恢复为data的输出目标
+    void Render(RenderData& data, const std::vector<ViewCamera>& views);
+
+    // 读取某个视图视口内的像素(RGBA float, 行顺序同ImageIO)
+    std::vector<float> ReadView(int view) const;
+
+    const ViewCamera& View(int view) const { return m_views[view]; }
+    unsigned int Texture() const { return m_texture; }
+    int ViewCount() const { return static_cast<int>(m_views.size()); }
+    unsigned int* Program() { return &m_program; }
+    size_t AllocatedBytes() const;
+
+    // 单内核的多视图宏(不含分块求交: 分块列表只对应一个相机)
+    static string Defines();
+
+private:
+    void Reserve(int width, int height, int layers);
+
+    unsigned int m_program = 0;
+    TargetFormat m_format;
+    WorkgroupSize m_workgroup;          // 编译时注入的工作组形状
+    unsigned int m_texture = 0;         // GL_TEXTURE_2D_ARRAY
+    int m_width = 0, m_height = 0, m_layers = 0;
+    unsigned int m_viewBuffer = 0;
+    size_t m_viewCapacity = 0;          // 视图数容量
+    std::vector<ViewCamera> m_views;    // 最近一次渲染的视图
+};
+}
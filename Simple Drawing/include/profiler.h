@@ -0,0 +1,79 @@
+// include/profiler.h
+#pragma once
+#include "defines.h"
+
+/*
+    轻量性能分析器:
+    - PROFILE_SCOPE(name):     CPU区间(任意线程)
+    - PROFILE_GPU_SCOPE(name): CPU区间 + GPU时间戳查询(仅GL线程)
+    GPU查询按帧放入环形缓冲, kFrameLatency帧后非阻塞读回, 结果尚未就绪则丢弃该帧, 从不等待GPU.
+    每个pass保留最近kHistorySize个样本的滚动统计, 可随时导出Chrome trace_event JSON(chrome://tracing).
+    name必须是字符串字面量(只保存指针).
+*/
+
+#if ENABLE_PROFILER
+
+namespace SimpleDrawingDemo {
+
+class Profiler {
+public:
+    static constexpr int kFrameLatency = 4;              // GPU查询延迟读回的帧数
+    static constexpr int kHistorySize = 240;             // 每个pass保留的样本数
+    static constexpr size_t kMaxTraceEvents = 200000;    // trace事件上限(超出后丢弃最旧的)
+
+    // 帧边界(GL线程)
+    static void BeginFrame();
+    static void EndFrame();
+
+    static double NowUs();
+    static void RecordCpu(const char* name, double startUs, double endUs);
+    static int BeginGpu(const char* name);
+    static void EndGpu(int zone);
+
+    // 导出Chrome trace_event JSON
+    static bool DumpTrace(const string& path);
+    // 各pass滚动统计: 中位数/p99与耗时分布直方图
+    static void PrintSummary();
+    static nlohmann::json ToJson();
+    // 释放GPU查询对象(GL上下文销毁前调用)
+    static void Release();
+};
+
+// CPU区间(RAII)
+class CpuZone {
+public:
+    explicit CpuZone(const char* name) : m_name(name), m_start(Profiler::NowUs()) {}
+    ~CpuZone() { Profiler::RecordCpu(m_name, m_start, Profiler::NowUs()); }
+
+private:
+    const char* m_name;
+    double m_start;
+};
+
+// CPU + GPU区间(RAII)
+class GpuZone {
+public:
+    explicit GpuZone(const char* name) : m_cpu(name), m_zone(Profiler::BeginGpu(name)) {}
+    ~GpuZone() { Profiler::EndGpu(m_zone); }
+
+private:
+    CpuZone m_cpu;
+    int m_zone;
+};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ::SimpleDrawingDemo::CpuZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) ::SimpleDrawingDemo::GpuZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_BEGIN_FRAME() ::SimpleDrawingDemo::Profiler::BeginFrame()
+#define PROFILE_END_FRAME() ::SimpleDrawingDemo::Profiler::EndFrame()
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_GPU_SCOPE(name)
+#define PROFILE_BEGIN_FRAME()
+#define PROFILE_END_FRAME()
+
+#endif
@@ -2,16 +2,83 @@
 #pragma once
 #include "shader_paths.h"
 #include "shader.h"
+#include "render_targets.h"
+#include "workgroup_tuner.h"
+#include "sampler.h"
 
 namespace SimpleDrawingDemo {
 
+class CpuTracer;
+class UniformRing;
+class ResolutionController;
+class FrameCapture;
+class WavefrontTracer;
+class Denoiser;
+class CpuDenoiser;
+class RenderFarm;
+class TemporalReprojection;
+class TileBinner;
+class MultiViewRenderer;
+class StagingBuffer;
+class SceneAnimator;
+class FramePipeline;
+struct Scene;
+struct FrameSnapshot;
+
+// 渲染后端: GPU计算着色器(单内核) / GPU波前路径追踪 / CPU参考光线追踪器
+enum class RenderBackend { GPU, Wavefront, CPU };
+
 struct RenderData {
     // 光线追踪资源
-    unsigned int outputTexture;
+    // 渲染目标(来自targetPool, 按2的幂桶分配; 格式通过着色器宏注入计算着色器)
+    RenderTargetPool* targetPool = nullptr;
+    RenderTarget outputTarget;                     // 色调映射后的输出
+    RenderTarget historyTarget;                    // 累积历史(线性颜色的逐像素均值)
+    int framesInFlight = 2;                        // 输出图像数与在途帧数上限(需在初始化前设置)
+    FramePipeline* pipeline = nullptr;             // 轮换输出图像, outputTarget为本帧借出的一张
+    TargetFormat outputFormat = TargetFormat::RGBA8;
+    TargetFormat historyFormat = TargetFormat::RGBA16F;
+    double resizeDeadline = 0.0;                   // 窗口尺寸变化的防抖截止时间, 0表示无待处理
     unsigned int quadVAO, quadVBO;
     unsigned int computeShaderID;
+    ProgramReflection computeReflection;   // 计算着色器的uniform/块反射表
+    WorkgroupSize workgroup;               // 单内核的工作组形状(命令行指定或读取调优结果)
+    int maxBounces = 3;                    // 反弹次数(以MAX_BOUNCES宏注入, 各后端一致)
+    SamplerType sampler = SamplerType::Sobol;   // 子像素抖动等的采样序列(以SAMPLER宏注入)
+    uint32_t samplerScramble = 0;          // 非0时各采样维度与之异或(收敛测试的独立参考图)
+    unsigned int blueNoiseBuffer = 0;      // 蓝噪声掩码(SSBO, 首次选用蓝噪声时上传)
+    bool tileBinning = false;              // 主光线按屏幕分块的图元列表求交(需在初始化前设置)
+    TileBinner* tileBinner = nullptr;      // tileBinning开启时创建
+    MultiViewRenderer* multiView = nullptr;  // 多视图批量渲染(单内核的MULTI_VIEW变体, 输出纹理数组)
+    UniformRing* frameUniforms = nullptr;  // 每帧数据(FrameData块)的环形UBO
+
+    // 渲染后端(CPU后端的结果上传到outputTarget, 波前后端替代单内核的glDispatchCompute)
+    RenderBackend backend = RenderBackend::GPU;
+    CpuTracer* cpuTracer = nullptr;
+    RenderFarm* renderFarm = nullptr;       // 非空时CPU后端的帧分块交给本机工作进程(累积与降噪时仍在本进程渲染)
+    WavefrontTracer* wavefront = nullptr;   // 波前后端的各pass程序与光线队列
+
+    // 降噪: 开启时追踪pass输出线性颜色与首次命中的G-buffer, 由denoiser滤波后写入outputTarget
+    // (目标在首次开启时分配, 之后随输出目标一起调整尺寸)
+    bool denoise = false;
+    int denoiseIterations = 4;
+    Denoiser* denoiser = nullptr;
+    CpuDenoiser* cpuDenoiser = nullptr;            // CPU后端
+    RenderTarget gbufferNormalDepth;               // xyz=法线, w=线性深度
+    RenderTarget gbufferAlbedoId;                  // rgb=反照率, a=命中图元
+    RenderTarget noisyTarget;                      // 累积后、色调映射前的线性颜色
+    RenderTarget denoiseTargets[2];                // à-trous迭代的乒乓目标
+
+    // 时域重投影: 同样依赖G-buffer, 结果作为降噪输入(未开启降噪时直接写入outputTarget)
+    bool temporal = false;
+    TemporalReprojection* reprojection = nullptr;
+
+    // 场景数据(SSBO): 动态改动每帧经暂存缓冲增量上传
+    Scene* scene;
+    StagingBuffer* staging = nullptr;
+    SceneAnimator* animator = nullptr;     // 非空时每帧驱动场景动画
     
-    // 相机参数
+    // 相机参数(交互模式下由模拟线程的快照写入, 渲染线程只读)
     vec3 cameraPos;
     vec3 cameraFront;
     vec3 cameraRight;
@@ -19,17 +86,30 @@ struct RenderData {
     vec3 worldUp = vec3(0.0f, 1.0f, 0.0f);
     vec3 lightPos;
     
-    // 屏幕尺寸
+    // 屏幕尺寸(渲染目标按此尺寸所在的桶分配)
     int screenWidth;
     int screenHeight;
-    
-    // 摄像机控制参数
-    bool mouseCaptured = true;  // 鼠标是否被捕获
-    bool firstMouse = true;      // 是否是第一次获取鼠标位置
-    float lastX = 0.0f;          // 上一帧鼠标X位置
-    float lastY = 0.0f;          // 上一帧鼠标Y位置
-    float yaw = -90.0f;          // 偏航角 (yaw)
-    float pitch = 0.0f;          // 俯仰角 (pitch)
+
+    // 内部渲染比例: 只在渲染目标左下角renderWidth x renderHeight区域内追踪, 由general.glsl放大
+    // (渲染目标尚未按新窗口尺寸扩大时, 区域会被限制在已分配的范围内)
+    float renderScale = 1.0f;
+    int renderWidth = 1920;
+    int renderHeight = 1080;
+    ResolutionController* resolution = nullptr;   // 非空时按帧时间自动调整renderScale
+
+    // 逐帧异步捕获(非空时每帧读回输出纹理)
+    FrameCapture* capture = nullptr;
+
+    // 按需渲染(交互模式): 影响画面的状态不变时跳过整帧, 模拟与渲染线程都阻塞等待输入
+    bool idle = false;
+
+    // 帧时间(秒): 交互模式来自模拟快照, 基准测试按帧号固定
+    float time = 0.0f;
+
+    // 渐进累积: 相机静止时逐帧平均抖动采样, 相机或尺寸变化时重置
+    bool accumulate = false;
+    int frameIndex = 0;          // 已累积的帧数
+    unsigned int cameraVersion = 0;   // 最近一次应用的快照相机版本
     
     // 原始绘图资源（保留但不再使用）
     unsigned int VAO, VBO, segments;
@@ -44,6 +124,23 @@ struct RenderData {
     ~RenderData();
     
     void InitRayTracingResources();
+    void ReflectComputeShader();
+    void RebuildComputeShader();
+    void ResizeRenderTargets();
+    void ResizeAuxTargets();
+    void BindGBuffer();
+    void SetDenoise(bool enabled);
+    void SetTemporal(bool enabled);
+    void SetSampler(SamplerType type, uint32_t scramble = 0);
+    void RequestResize(int width, int height);
+    void ApplyPendingResize(double now);
+    string ComputeDefines() const;
+    string TraceDefines() const;
+    void ApplySnapshot(const FrameSnapshot& snapshot);
+    void UpdateScene();
+    void SetRenderScale(float scale);
+    bool LoadScene(const string& path);
+    void ResetAccumulation() { frameIndex = 0; }
     
     // 原始方法（保留但不再使用）
     void BindVertexObjects() {}
@@ -0,0 +1,148 @@
+// include/render_farm.h
+#pragma once
+#include <cstdint>
+#include "cpu_tracer.h"
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+struct LaunchOptions;
+struct Scene;
+
+// 协调进程与工作进程之间的二进制协议(同机进程, 按本机字节序直接收发结构体)
+namespace FarmProtocol {
+    constexpr uint32_t kMagic = 0x4d524146;   // "FARM"
+    constexpr uint16_t kVersion = 1;
+
+    enum class MessageType : uint16_t { Hello = 1, Job = 2, Result = 3, Quit = 4 };
+
+    struct Header {
+        uint32_t magic = kMagic;
+        uint16_t type = 0;
+        uint16_t version = kVersion;
+        uint32_t size = 0;            // 其后负载的字节数
+    };
+
+    // 工作进程连接后的第一条消息
+    struct Hello {
+        int32_t pid = 0;
+        int32_t threads = 0;
+    };
+
+    // 相机快照: 与CpuCamera对应, 另带光源位置(动画场景由工作进程在本地重放)
+    struct Camera {
+        vec3 pos, front, right, up;
+        vec3 lightPos;
+        float time = 0.0f;
+        int32_t frameIndex = 0;
+    };
+
+    // 分块矩形(像素)
+    struct TileRect {
+        uint16_t x = 0, y = 0, width = 0, height = 0;
+    };
+
+    // 协调进程 -> 工作进程: 一个分块的渲染任务
+    struct Job {
+        uint32_t frame = 0;
+        int32_t tile = 0;             // 行主序分块编号(与CpuTracer/单内核的16x16分派网格一致)
+        int32_t frameWidth = 0, frameHeight = 0;
+        TileRect rect;
+        Camera camera;
+    };
+
+    // 工作进程 -> 协调进程: 其后紧跟rect.width * rect.height个像素, 每像素3个float(色调映射后的RGB, 不含alpha)
+    struct Result {
+        uint32_t frame = 0;
+        int32_t tile = 0;
+        TileRect rect;
+    };
+}
+
+// 渲染农场统计(写入基准测试报告)
+struct FarmStats {
+    int workers = 0;          // 成功连接的工作进程数
+    long long frames = 0;
+    long long tiles = 0;      // 工作进程完成的分块
+    long long localTiles = 0; // 全部工作进程失效后由协调进程自己渲染的分块
+    long long steals = 0;     // 从其他工作进程队列尾部窃取的分块
+    long long failures = 0;   // 失效(断开/超时/协议错误)的工作进程
+    long long reassigned = 0; // 因失效而重新分配的分块
+    long long bytesSent = 0, bytesReceived = 0;
+
+    nlohmann::json ToJson() const;
+};
+
+/*
+    本机渲染农场: 协调进程把画面切成与分派网格一致的16x16分块, 经Unix域套接字分发给N个无头工作进程
+    (本程序以--farm-worker启动, 各自加载同一场景, 单线程CPU追踪).
+    每个工作进程有一个分块队列(按连续区间预分配), 最多kPipelineDepth个任务在途;
+    自己的队列空了就从最长队列的尾部窃取. 工作进程断开、超时或回传错误的数据即视为失效,
+    其在途与排队的分块重新分配给其余进程; 全部失效时由协调进程在本地渲染剩余分块.
+    组装结果为RGBA float(与CpuTracer::Pixels一致), 可上传到输出纹理或写入文件.
+    只支持POSIX(AF_UNIX + posix_spawn); 跨节点需要换成TCP传输, 协议本身不变.
+*/
+class RenderFarm {
+public:
+    static constexpr int kPipelineDepth = 2;          // 每个工作进程的在途任务数(收发与渲染重叠)
+    static constexpr int kConnectTimeoutMs = 30000;   // 等待工作进程加载场景并连接
+    static constexpr int kWorkerTimeoutMs = 10000;    // 在途任务无响应即视为失效
+
+    RenderFarm(const Scene* scene, const LaunchOptions& options);
+    ~RenderFarm();
+    RenderFarm(const RenderFarm&) = delete;
+    RenderFarm& operator=(const RenderFarm&) = delete;
+
+    // 启动工作进程并等待连接, 一个都没有连上时返回false
+    bool Start();
+    // 渲染一帧, 结果见Pixels()
+    void Render(const CpuCamera& camera, const vec3& lightPos, int width, int height);
+
+    const std::vector<float>& Pixels() const { return m_pixels; }
+    const FarmStats& Stats() const { return m_stats; }
+    int WorkerCount() const;
+
+    // 工作进程入口: 连接协调进程, 循环处理任务直到收到Quit或连接断开
+    static int RunWorker(RenderData* data, const LaunchOptions& options);
+
+private:
+    struct Worker {
+        int fd = -1;
+        int pid = 0;
+        bool alive = false;
+        std::deque<int> queue;        // 待发送的分块
+        std::deque<int> inFlight;     // 已发送、等待结果的分块(按发送顺序返回)
+        double lastProgress = 0.0;    // 上次收到结果(或开始等待)的时间, 秒
+    };
+    struct Process {
+        int pid = 0;
+        bool reaped = false;          // 已由waitpid回收, pid可能已被系统复用, 不能再发信号或等待
+    };
+
+    std::vector<string> WorkerArgs(int index) const;
+    bool Spawn(const std::vector<string>& args);
+    bool Accept();
+    Process* FindProcess(int pid);
+    bool NextTile(Worker& worker, int& tile);
+    bool Send(Worker& worker, int tile);
+    bool Receive(Worker& worker);
+    void Fail(Worker& worker, const char* reason);
+    void RenderLocally(const std::vector<int>& tiles);
+
+    const Scene* m_scene;
+    const LaunchOptions& m_options;
+    string m_socketPath;
+    int m_listenFd = -1;
+    std::vector<Process> m_spawned;   // 已启动的进程(连接前按pid匹配)
+    std::vector<Worker> m_workers;
+
+    // 当前帧
+    FarmProtocol::Job m_job;
+    int m_width = 0, m_height = 0, m_tilesX = 0;
+    std::vector<float> m_pixels;
+    std::vector<float> m_buffer;      // 接收缓冲
+
+    CpuTracer* m_localTracer = nullptr;   // 兜底渲染(首次需要时创建)
+    FarmStats m_stats;
+};
+}
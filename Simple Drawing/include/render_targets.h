@@ -0,0 +1,62 @@
+// include/render_targets.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// 渲染目标格式
+enum class TargetFormat { RGBA32F, RGBA16F, R11G11B10F, RGBA8 };
+
+struct TargetFormatInfo {
+    const char* name;          // 命令行名称
+    GLenum internalFormat;
+    const char* glslFormat;    // 计算着色器image格式限定符
+    int bytesPerPixel;
+};
+
+const TargetFormatInfo& FormatInfo(TargetFormat format);
+bool ParseTargetFormat(const string& name, TargetFormat& format);
+
+// 不可变存储(glTextureStorage2D)的渲染目标, 分配尺寸为2的幂桶
+struct RenderTarget {
+    unsigned int texture = 0;
+    int width = 0, height = 0;
+    TargetFormat format = TargetFormat::RGBA8;
+};
+
+/*
+    渲染目标池: 按(格式, 尺寸桶)复用纹理. 窗口在同一桶内缩放时完全不分配,
+    跨桶时旧纹理放回池中, 来回拖动窗口也只会命中已有的纹理.
+    空闲目标按尺寸桶整体保留(不限个数, 一个桶的空闲目标即上次使用该尺寸时的全部目标),
+    只保留最近放回的kMaxSpareBuckets个尺寸桶.
+*/
+class RenderTargetPool {
+public:
+    static constexpr int kMaxSpareBuckets = 2;    // 池中最多保留空闲目标的尺寸桶数
+
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // 获取至少width x height的目标
+    RenderTarget Acquire(TargetFormat format, int width, int height);
+    // 放回池中(空闲目标的尺寸桶超出kMaxSpareBuckets时删除最早放回的桶)
+    void Release(RenderTarget& target);
+    // 换成另一尺寸的目标: 已是同格式同尺寸桶时保持不变, 否则先获取新目标再放回旧目标
+    void Reacquire(RenderTarget& target, TargetFormat format, int width, int height);
+    void Clear();
+
+    size_t AllocatedBytes() const { return m_allocatedBytes; }
+    size_t CreatedCount() const { return m_created; }    // 累计新建的纹理数
+    size_t ReusedCount() const { return m_reused; }      // 累计从池中复用的次数
+    std::vector<unsigned int> SpareTextures() const;    // 空闲目标的纹理名称(升序)
+    static int Bucket(int size);    // 向上取2的幂
+
+private:
+    void Destroy(const RenderTarget& target);
+
+    std::vector<RenderTarget> m_free;    // 按放回顺序
+    size_t m_allocatedBytes = 0;
+    size_t m_created = 0, m_reused = 0;
+};
+}
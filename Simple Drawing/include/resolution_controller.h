@@ -0,0 +1,39 @@
+// include/resolution_controller.h
+#pragma once
+#include "gpu_timer.h"
+
+namespace SimpleDrawingDemo {
+
+/*
+    动态分辨率控制器: 根据实测渲染耗时调整内部渲染比例, 使其逼近目标帧时间.
+    像素数与比例的平方成正比, 因此按sqrt(目标/实测)修正; 带死区、单步限幅与冷却,
+    避免画面来回跳动(每次改变比例都会重置累积).
+*/
+class ResolutionController {
+public:
+    static constexpr float kStep = 1.0f / 32.0f;    // 比例量化步长
+    static constexpr int kCooldownFrames = 4;       // 改变比例后丢弃的样本数(仍在途中的旧比例测量)
+    static constexpr int kMinSamples = 4;           // 做出调整前至少需要的样本数
+
+    ResolutionController(double targetMs, float minScale = 0.5f, float maxScale = 1.0f);
+
+    // 包围受比例影响的GPU工作(GPU后端)
+    void Begin() { m_timer.Begin(); }
+    void End() { m_timer.End(); }
+    // 直接提交一次耗时(CPU后端)
+    void AddSample(double ms);
+
+    // 读取已完成的测量并返回新的渲染比例
+    float Update(float currentScale);
+
+    double SmoothedMs() const { return m_sampleCount ? m_smoothedMs : 0.0; }
+
+private:
+    GpuTimer m_timer;
+    double m_targetMs;
+    float m_minScale, m_maxScale;
+    double m_smoothedMs = 0.0;    // 当前比例下耗时的指数滑动平均
+    int m_sampleCount = 0;
+    int m_cooldown = 0;
+};
+}
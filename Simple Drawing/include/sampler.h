@@ -0,0 +1,55 @@
+// include/sampler.h
+#pragma once
+#include <cstdint>
+
+namespace SimpleDrawingDemo {
+
+// 蓝噪声缓冲的SSBO绑定点(与common/sampler.glsl一致)
+enum SamplerBinding {
+    SAMPLER_BINDING_BLUE_NOISE = 17
+};
+
+// 采样序列(与common/sampler.glsl的SAMPLER_*一致)
+enum class SamplerType { Hash, R2, Sobol, BlueNoise };
+
+const char* SamplerName(SamplerType type);
+bool ParseSampler(const string& name, SamplerType& type);
+
+/*
+    平铺蓝噪声: void-and-cluster(Ulichney 1993)在CPU上离线生成两张独立的kSize x kSize掩码,
+    每个像素的值为其在点序中的秩(均匀分布在(0, 1)), 相邻像素的值互补.
+    首次使用时生成并写入BLUE_NOISE_PATH, 之后直接读取.
+*/
+class BlueNoise {
+public:
+    static constexpr int kSize = 64;
+
+    // 两张掩码交错存放(kSize^2项, 每项x/y各一张)
+    static const std::vector<vec2>& Get();
+
+private:
+    static std::vector<float> Generate(unsigned int seed);
+    static bool LoadCache(std::vector<vec2>& texels);
+    static void WriteCache(const std::vector<vec2>& texels);
+};
+
+/*
+    采样器: 主光线子像素抖动等逐像素、逐帧的随机数.
+    - Hash: 旧的fract(sin)哈希(白噪声, 像素之间与帧之间都有相关)
+    - R2: 低差异的R2序列, 逐像素随机平移
+    - Sobol: 逐像素打乱顺序并Owen扰乱的Sobol序列, 任意2的幂个样本都分层
+    - BlueNoise: 平铺蓝噪声给出逐像素的起点, 逐帧按R2推进(误差在屏幕上集中到高频)
+    GPU端为common/sampler.glsl(按SAMPLER宏编译, 蓝噪声缓冲由RenderData上传), CPU参考追踪器使用Sample2D, 两者逐位一致.
+*/
+class Sampler {
+public:
+    // 各用途的采样维度(与SAMPLE_DIMENSION_*一致)
+    static constexpr uint32_t kDimensionJitter = 0;
+
+    // scramble非0时与各维度异或(只用于GPU端的收敛测试参考图, CPU端始终为0)
+    static string Defines(SamplerType type, uint32_t scramble = 0);
+
+    // 第index个二维样本(各分量在[0, 1)), 与着色器的sample2D一致
+    static vec2 Sample2D(SamplerType type, int x, int y, uint32_t index, uint32_t dimension);
+};
+}
@@ -0,0 +1,116 @@
+// include/scene.h
+#pragma once
+#include "bvh.h"
+#include "mesh.h"
+#include "staging_buffer.h"
+
+namespace SimpleDrawingDemo {
+
+// 场景缓冲区绑定点(与common/scene.glsl中的binding一致)
+enum SceneBinding {
+    SCENE_BINDING_CENTER_RADIUS = 1,
+    SCENE_BINDING_COLOR_SPECULAR = 2,
+    SCENE_BINDING_REFLECTIVITY = 3,
+    SCENE_BINDING_EMISSION = 4,
+    SCENE_BINDING_LIGHTS = 5,
+    SCENE_BINDING_COUNT = 5
+};
+
+// 三角形缓冲区绑定点(8~11为波前队列)
+enum MeshBinding {
+    MESH_BINDING_TRIANGLES = 12,
+    MESH_BINDING_TRIANGLE_SHADING = 13
+};
+
+// 增量更新统计(累计值, 写入基准测试报告)
+struct SceneUpdateStats {
+    int frames = 0;          // 有改动的帧数
+    int primitives = 0;      // 改动的图元数
+    int ranges = 0;          // 合并后的上传范围数(每个范围一次复制命令)
+    size_t bytes = 0;        // 上传字节数
+    int refitNodes = 0;      // refit的BVH节点数
+    int rebuilds = 0;        // SAH代价退化触发的完整重建次数
+    double updateMs = 0.0;   // CPU端耗时(refit + 写入暂存缓冲)
+
+    void Add(const SceneUpdateStats& other);
+    nlohmann::json ToJson() const;
+};
+
+/*
+    场景数据: 球体属性按SoA紧凑存储, 直接作为std430 SSBO上传.
+    求交只需读取centerRadius, 着色时才访问其余数组, 遍历时缓存更友好.
+
+    网格展开为逐三角形的记录, 与球体共用一棵BVH: 图元索引小于球体数为球体, 否则为三角形(索引 - 球体数).
+    材质数组的前SphereCount()项属于球体(与球体索引一致), 之后每个网格实例一项.
+
+    动态更新: Set*修改单个图元或材质并记录脏范围, Update()每帧统一处理:
+    BVH只refit改动图元的祖先, 各缓冲只上传合并后的改动范围, 开销与改动量成正比而与场景规模无关.
+*/
+struct Scene {
+    std::vector<vec4> centerRadius;   // xyz=球心, w=半径
+    std::vector<vec4> colorSpecular;  // 材质: rgb=颜色, a=高光指数
+    std::vector<float> reflectivity;  // 材质: 反射率
+    std::vector<float> emission;      // 材质: 自发光强度, 大于0的球体即为光源(网格只发光, 不参与直接光照采样)
+    std::vector<int> lights;          // 光源球体索引
+
+    // 三角形: 每个三角形3个vec4 = v0, e1 = v1 - v0, e2 = v2 - v0 (Möller–Trumbore直接使用预先算好的边)
+    std::vector<vec4> triangleVertices;
+    std::vector<glm::uvec4> triangleShading;   // xyz=三个顶点的法线(八面体编码, snorm16x2), w=材质索引
+    std::vector<MeshLoadStats> meshes;         // 已加载网格的统计(基准测试报告)
+
+    // 待上传的改动(元素范围): 球心半径 / 材质(三个材质数组共用) / 三角形顶点
+    DirtyRanges dirtyCenterRadius, dirtyMaterials, dirtyTriangles;
+    bool dirtyLights = false;                  // 光源列表变化(整体上传)
+    SceneUpdateStats updateStats;
+
+    // 加速结构
+    Bvh bvh;
+
+    // GPU缓冲区
+    unsigned int buffers[SCENE_BINDING_COUNT] = {};
+    unsigned int triangleBuffers[2] = {};
+
+    Scene() = default;
+    ~Scene();
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    int SphereCount() const { return static_cast<int>(centerRadius.size()); }
+    int LightCount() const { return static_cast<int>(lights.size()); }
+    int TriangleCount() const { return static_cast<int>(triangleShading.size()); }
+    int PrimitiveCount() const { return SphereCount() + TriangleCount(); }
+
+    void Clear();
+    // 球体须在所有网格之前添加(材质索引与球体索引一致), 否则返回-1
+    int AddSphere(const vec3& center, float radius, const vec3& color,
+        float specular, float reflectivity, float emission = 0.0f);
+    // 添加网格实例(先缩放再平移到世界空间), 返回材质索引, 网格数据有误时返回-1
+    int AddMesh(const Mesh& mesh, const vec3& position, const vec3& scale, const vec3& color,
+        float specular, float reflectivity, float emission = 0.0f);
+
+    // 内置默认场景(与原先着色器中的常量球体表一致)
+    void LoadDefault();
+    // 从JSON加载(spheres与meshes数组, 网格路径相对于场景文件), 失败时保持原场景不变
+    bool LoadFromJson(const string& path);
+    // 随机生成大量小球(用于测试大规模场景)
+    void LoadRandom(int count, unsigned int seed = 1);
+
+    // 重新构建BVH并输出构建报告
+    void BuildBvh();
+
+    // 动态更新: 只修改CPU端数据并记录脏范围(三角形的顶点法线保持不变, 适合刚体平移)
+    void SetSphere(int index, const vec3& center, float radius);
+    void SetTriangle(int index, const vec3& v0, const vec3& v1, const vec3& v2);
+    void SetMaterial(int index, const vec3& color, float specular, float reflectivity, float emission);
+    // refit BVH(必要时重建)并经暂存缓冲上传改动范围, staging为空时只更新CPU端(CPU后端); 有改动时返回true
+    bool Update(StagingBuffer* staging);
+    bool HasPendingUpdates() const {
+        return dirtyLights || !dirtyCenterRadius.Empty() || !dirtyMaterials.Empty() || !dirtyTriangles.Empty();
+    }
+
+    // 上传/绑定SSBO
+    void Upload();
+    void Bind() const;
+    void Release();
+};
+}
@@ -0,0 +1,31 @@
+// include/scene_animator.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+struct Scene;
+
+/*
+    场景动画(--animate F): 光源球体随模拟的lightPos平移, 其余球体(地面等大球除外)按比例F选取一部分上下浮动.
+    每帧只通过Scene::Set*修改这些图元, 上传与BVH更新由Scene::Update增量完成. 位置只取决于时间, 基准测试可复现.
+*/
+class SceneAnimator {
+public:
+    static constexpr float kMaxRadius = 10.0f;   // 半径更大的球体(地面)不参与浮动
+    static constexpr float kAmplitude = 0.5f;    // 浮动幅度
+
+    SceneAnimator(const Scene& scene, float fraction);
+
+    void Apply(Scene& scene, float time, const vec3& lightPos) const;
+    int AnimatedCount() const { return static_cast<int>(m_spheres.size() + m_lights.size()); }
+
+private:
+    struct AnimatedSphere {
+        int index;
+        vec4 base;     // 初始球心与半径
+        float phase;
+    };
+    std::vector<AnimatedSphere> m_spheres;
+    std::vector<AnimatedSphere> m_lights;
+};
+}
@@ -4,26 +4,53 @@ namespace SimpleDrawingDemo {
 
 class RenderData;
 
+// 接口块信息(uniform块或着色器存储块)
+struct BlockInfo {
+    int index = -1;      // 块索引
+    int binding = -1;    // 着色器中声明的绑定点
+    int dataSize = 0;    // 块数据大小(字节)
+};
+
+/*
+    程序反射: 链接后一次性枚举活动uniform与接口块, 之后按名称查哈希表,
+    不再每帧调用glGetUniformLocation. 块内成员不单独记录location.
+*/
+struct ProgramReflection {
+    std::unordered_map<string, int> uniforms;            // 名称 -> location
+    std::unordered_map<string, BlockInfo> uniformBlocks;
+    std::unordered_map<string, BlockInfo> storageBlocks;
+
+    int Location(const string& name) const;              // 不存在时返回-1(glUniform*会忽略)
+    const BlockInfo* UniformBlock(const string& name) const;
+};
+
 struct Shader {
     /* ------- 静态成员与方法 ------- */
     inline static unsigned int s_programID = 0;
 
     static string Load(const string& path);
+    static string Preprocess(const string& path, std::vector<string>* includes = nullptr);
     static unsigned int Create(
         const string& vsh_path = "", const string& fsh_path = "",
         const string& geo_path = "", const string& csh_path = ""
     );
-    static unsigned int CreateComputeShader(const string& path);
-    static unsigned int Compile(const string& path, GLenum type);
+    static unsigned int CreateComputeShader(const string& path, const string& defines = "");
+    static unsigned int Compile(const string& path, GLenum type, const string& defines = "");
+    static unsigned int CompileSource(const string& source, const string& path, GLenum type);
+    static unsigned int Build(const std::vector<std::pair<GLenum, string>>& stages, const string& defines = "");
+    static string InjectDefines(const string& source, const string& defines);
+    static ProgramReflection Reflect(unsigned int program);
 
     /* ------- 实例成员与方法 ------- */
-    
+    ProgramReflection reflection;   // s_programID的反射结果, 由Reflect()填充
+
+    void Reflect() { reflection = Reflect(s_programID); }
     void Use() const;
     void SetUniform1i(const string& name, int value) const;
     void SetUniform1f(const string& name, float value) const;
     void SetUniform2f(const string& name, const vec2& vector) const;
     void SetUniform3f(const string& name, const vec3& vector) const;
     void SetUniform4f(const string& name, const vec4& vector) const;
-    void SetUniformMat4(const string& name, const mat4& matrix);
+    void SetUniformMat4(const string& name, const mat4& matrix) const;
 };
 }
\ No newline at end of file
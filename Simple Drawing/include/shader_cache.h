@@ -0,0 +1,38 @@
+// include/shader_cache.h
+#pragma once
+#include <cstdint>
+#include "defines.h"
+
+namespace SimpleDrawingDemo {
+
+// 着色器缓存统计(用于对比冷/热启动耗时)
+struct ShaderCacheStats {
+    int hits = 0;            // 直接加载二进制成功
+    int misses = 0;          // 无缓存文件, 需要编译
+    int rejected = 0;        // 驱动拒绝了缓存的二进制(驱动更新等), 回退编译
+    double compileMs = 0.0;  // 编译+链接总耗时
+    double loadMs = 0.0;     // 加载二进制总耗时
+
+    nlohmann::json ToJson() const;
+};
+
+/*
+    程序二进制磁盘缓存: 以源码、宏定义及驱动信息的哈希为键,
+    保存glGetProgramBinary的结果, 下次启动时用glProgramBinary直接加载.
+*/
+struct ShaderCache {
+    inline static bool s_enabled = true;
+    inline static string s_directory = SHADER_CACHE_PATH;
+    inline static ShaderCacheStats s_stats;
+
+    // 计算缓存键: 各阶段源码 + 宏定义 + 厂商/渲染器/GL与GLSL版本
+    static uint64_t Key(const std::vector<std::pair<GLenum, string>>& stages, const string& defines);
+    // 加载缓存的程序, 失败(无文件或被驱动拒绝)时返回0
+    static unsigned int Load(uint64_t key);
+    // 保存已链接程序的二进制(链接前需设置GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    static void Store(uint64_t key, unsigned int program);
+
+private:
+    static string PathOf(uint64_t key);
+};
+}
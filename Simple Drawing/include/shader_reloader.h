@@ -0,0 +1,67 @@
+// include/shader_reloader.h
+#pragma once
+#include <condition_variable>
+#include "defines.h"
+
+namespace SimpleDrawingDemo {
+
+/*
+    着色器热重载: 监视着色器目录, 文件变化后在共享GL上下文的后台线程上重新编译链接,
+    链接成功且GPU端完成后(栅栏)才在渲染线程上替换程序ID; 失败时保留旧程序继续运行.
+    渲染线程只在Poll中做非阻塞的栅栏查询, 不会因编译产生卡顿.
+*/
+class ShaderReloader {
+public:
+    using ReloadCallback = std::function<void()>;
+
+    // 必须在主线程(创建窗口的线程)上构造, 内部会创建一个隐藏的共享上下文窗口
+    explicit ShaderReloader(GLFWwindow* mainWindow, const string& directory = SHADER_PATH);
+    ~ShaderReloader();
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    // 注册程序: 任一阶段文件变化时重新构建, 成功后写入*target并调用onReload
+    void Watch(const std::vector<std::pair<GLenum, string>>& stages, unsigned int* target,
+               ReloadCallback onReload = nullptr, const string& defines = "");
+
+    // 每帧在渲染线程调用: 替换已完成的新程序, 返回替换的程序数
+    int Poll();
+
+private:
+    struct Program {
+        std::vector<std::pair<GLenum, string>> stages;
+        string defines;                              // 注入的宏定义
+        std::vector<std::filesystem::path> files;    // 规范化路径(含#include的文件), 用于匹配变化的文件
+        unsigned int* target;
+        ReloadCallback onReload;
+    };
+    struct Result {
+        size_t program;      // m_programs下标
+        unsigned int id;
+        GLsync fence;        // 后台上下文的编译链接命令完成后触发
+    };
+
+    void WatchThread();
+    void CompileThread();
+    void OnFileChanged(const std::filesystem::path& path);
+
+    GLFWwindow* m_context = nullptr;    // 后台编译用的共享上下文(隐藏窗口)
+    string m_directory;
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::vector<Program> m_programs;
+    std::vector<std::filesystem::path> m_pending;          // 等待防抖的变化文件
+    std::chrono::steady_clock::time_point m_lastChange;
+    std::vector<Result> m_results;
+    std::atomic<bool> m_running{ true };
+
+#ifdef _WIN32
+    HANDLE m_directoryHandle = INVALID_HANDLE_VALUE;
+#else
+    int m_notifyFd = -1;
+#endif
+    std::thread m_watchThread;
+    std::thread m_compileThread;
+};
+}
@@ -0,0 +1,192 @@
+// include/simd.h
+#pragma once
+
+/*
+    8路SIMD浮点封装, 用于CPU光线包(ray packet)追踪.
+    AVX2下为单个__m256, SSE下为两个__m128拼接, 否则退化为标量数组.
+    按函数指定目标指令集(#pragma GCC target)的编译单元不会定义__AVX2__, 需在包含前定义SD_SIMD_TARGET_AVX2.
+    比较运算返回的掩码同样以Float8表示(每路全1或全0).
+    各实现位于不同的内联命名空间, 按不同指令集编译的编译单元可以链接在一起而不违反ODR.
+*/
+
+#if defined(__AVX2__) || defined(SD_SIMD_TARGET_AVX2)
+    #include <immintrin.h>
+    #define SD_SIMD_AVX2 1
+    #define SD_SIMD_NAMESPACE SimdAvx2
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define SD_SIMD_SSE 1
+    #define SD_SIMD_NAMESPACE SimdSse
+#else
+    #include <cstring>
+    #define SD_SIMD_NAMESPACE SimdScalar
+#endif
+
+// 类内定义的友元函数不受#pragma GCC target影响, 需逐个指定目标指令集
+#if defined(SD_SIMD_TARGET_AVX2)
+    #define SD_SIMD_TARGET __attribute__((target("avx2,fma")))
+#else
+    #define SD_SIMD_TARGET
+#endif
+
+namespace SimpleDrawingDemo {
+inline namespace SD_SIMD_NAMESPACE {
+
+struct Float8 {
+    static constexpr int kWidth = 8;
+
+#if defined(SD_SIMD_AVX2)
+    __m256 v;
+
+    Float8() : v(_mm256_setzero_ps()) {}
+    Float8(__m256 x) : v(x) {}
+    Float8(float s) : v(_mm256_set1_ps(s)) {}
+
+    static Float8 Load(const float* p) { return _mm256_loadu_ps(p); }
+    void Store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    friend SD_SIMD_TARGET Float8 operator+(Float8 a, Float8 b) { return _mm256_add_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 operator-(Float8 a, Float8 b) { return _mm256_sub_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 operator*(Float8 a, Float8 b) { return _mm256_mul_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 operator/(Float8 a, Float8 b) { return _mm256_div_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 operator&(Float8 a, Float8 b) { return _mm256_and_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 operator|(Float8 a, Float8 b) { return _mm256_or_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 operator<(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    friend SD_SIMD_TARGET Float8 operator>(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+    friend SD_SIMD_TARGET Float8 operator<=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+    friend SD_SIMD_TARGET Float8 operator>=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+    friend SD_SIMD_TARGET Float8 operator==(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+    friend SD_SIMD_TARGET Float8 operator!=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ); }
+
+    friend SD_SIMD_TARGET Float8 Sqrt(Float8 a) { return _mm256_sqrt_ps(a.v); }
+    friend SD_SIMD_TARGET Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a.v, b.v); }
+    // mask ? a : b
+    friend SD_SIMD_TARGET Float8 Select(Float8 mask, Float8 a, Float8 b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+    // !a & b
+    friend SD_SIMD_TARGET Float8 AndNot(Float8 a, Float8 b) { return _mm256_andnot_ps(a.v, b.v); }
+    friend SD_SIMD_TARGET int Movemask(Float8 a) { return _mm256_movemask_ps(a.v); }
+
+    static const char* Name() { return "AVX2"; }
+
+#elif defined(SD_SIMD_SSE)
+    __m128 lo, hi;
+
+    Float8() : lo(_mm_setzero_ps()), hi(_mm_setzero_ps()) {}
+    Float8(__m128 l, __m128 h) : lo(l), hi(h) {}
+    Float8(float s) : lo(_mm_set1_ps(s)), hi(_mm_set1_ps(s)) {}
+
+    static Float8 Load(const float* p) { return Float8(_mm_loadu_ps(p), _mm_loadu_ps(p + 4)); }
+    void Store(float* p) const { _mm_storeu_ps(p, lo); _mm_storeu_ps(p + 4, hi); }
+
+    #define SD_SSE_BINARY(op, fn) \
+        friend SD_SIMD_TARGET Float8 op(Float8 a, Float8 b) { return Float8(fn(a.lo, b.lo), fn(a.hi, b.hi)); }
+    SD_SSE_BINARY(operator+, _mm_add_ps)
+    SD_SSE_BINARY(operator-, _mm_sub_ps)
+    SD_SSE_BINARY(operator*, _mm_mul_ps)
+    SD_SSE_BINARY(operator/, _mm_div_ps)
+    SD_SSE_BINARY(operator&, _mm_and_ps)
+    SD_SSE_BINARY(operator|, _mm_or_ps)
+    SD_SSE_BINARY(operator<, _mm_cmplt_ps)
+    SD_SSE_BINARY(operator>, _mm_cmpgt_ps)
+    SD_SSE_BINARY(operator<=, _mm_cmple_ps)
+    SD_SSE_BINARY(operator>=, _mm_cmpge_ps)
+    SD_SSE_BINARY(operator==, _mm_cmpeq_ps)
+    SD_SSE_BINARY(operator!=, _mm_cmpneq_ps)
+    SD_SSE_BINARY(Min, _mm_min_ps)
+    SD_SSE_BINARY(Max, _mm_max_ps)
+    SD_SSE_BINARY(AndNot, _mm_andnot_ps)
+    #undef SD_SSE_BINARY
+
+    friend SD_SIMD_TARGET Float8 Sqrt(Float8 a) { return Float8(_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi)); }
+    friend SD_SIMD_TARGET Float8 Select(Float8 mask, Float8 a, Float8 b) {
+        return (mask & a) | AndNot(mask, b);
+    }
+    friend SD_SIMD_TARGET int Movemask(Float8 a) { return _mm_movemask_ps(a.lo) | (_mm_movemask_ps(a.hi) << 4); }
+
+    static const char* Name() { return "SSE"; }
+
+#else
+    float v[kWidth];
+
+    Float8() { for (int i = 0; i < kWidth; i++) v[i] = 0.0f; }
+    Float8(float s) { for (int i = 0; i < kWidth; i++) v[i] = s; }
+
+    static Float8 Load(const float* p) { Float8 r; for (int i = 0; i < kWidth; i++) r.v[i] = p[i]; return r; }
+    void Store(float* p) const { for (int i = 0; i < kWidth; i++) p[i] = v[i]; }
+
+    static float Bits(bool b) { return b ? AllOnes() : 0.0f; }
+    static float AllOnes() { unsigned int u = 0xFFFFFFFFu; float f; std::memcpy(&f, &u, 4); return f; }
+    static unsigned int U(float f) { unsigned int u; std::memcpy(&u, &f, 4); return u; }
+    static float F(unsigned int u) { float f; std::memcpy(&f, &u, 4); return f; }
+
+    #define SD_SCALAR_BINARY(op, expr) \
+        friend SD_SIMD_TARGET Float8 op(Float8 a, Float8 b) { Float8 r; for (int i = 0; i < kWidth; i++) { float x = a.v[i], y = b.v[i]; r.v[i] = (expr); } return r; }
+    SD_SCALAR_BINARY(operator+, x + y)
+    SD_SCALAR_BINARY(operator-, x - y)
+    SD_SCALAR_BINARY(operator*, x * y)
+    SD_SCALAR_BINARY(operator/, x / y)
+    SD_SCALAR_BINARY(operator&, F(U(x) & U(y)))
+    SD_SCALAR_BINARY(operator|, F(U(x) | U(y)))
+    SD_SCALAR_BINARY(operator<, Bits(x < y))
+    SD_SCALAR_BINARY(operator>, Bits(x > y))
+    SD_SCALAR_BINARY(operator<=, Bits(x <= y))
+    SD_SCALAR_BINARY(operator>=, Bits(x >= y))
+    SD_SCALAR_BINARY(operator==, Bits(x == y))
+    SD_SCALAR_BINARY(operator!=, Bits(x != y))
+    SD_SCALAR_BINARY(Min, y < x ? y : x)
+    SD_SCALAR_BINARY(Max, y > x ? y : x)
+    SD_SCALAR_BINARY(AndNot, F(~U(x) & U(y)))
+    #undef SD_SCALAR_BINARY
+
+    friend SD_SIMD_TARGET Float8 Sqrt(Float8 a) { Float8 r; for (int i = 0; i < kWidth; i++) r.v[i] = std::sqrt(a.v[i]); return r; }
+    friend SD_SIMD_TARGET Float8 Select(Float8 mask, Float8 a, Float8 b) { return (mask & a) | AndNot(mask, b); }
+    friend SD_SIMD_TARGET int Movemask(Float8 a) { int m = 0; for (int i = 0; i < kWidth; i++) m |= int(U(a.v[i]) >> 31) << i; return m; }
+
+    static const char* Name() { return "Scalar"; }
+#endif
+
+    friend SD_SIMD_TARGET bool Any(Float8 mask) { return Movemask(mask) != 0; }
+    friend SD_SIMD_TARGET Float8 operator-(Float8 a) { return Float8(0.0f) - a; }
+    Float8& operator+=(Float8 b) { return *this = *this + b; }
+    Float8& operator*=(Float8 b) { return *this = *this * b; }
+    Float8& operator&=(Float8 b) { return *this = *this & b; }
+
+    // 逐路标量函数(pow等无SIMD指令的运算)
+    template <typename Fn>
+    friend SD_SIMD_TARGET Float8 PerLane(Float8 a, Float8 b, Fn fn) {
+        alignas(32) float x[kWidth], y[kWidth];
+        a.Store(x); b.Store(y);
+        for (int i = 0; i < kWidth; i++) x[i] = fn(x[i], y[i]);
+        return Load(x);
+    }
+};
+
+// 8路三维向量(SoA布局)
+struct Vec3x8 {
+    Float8 x, y, z;
+
+    Vec3x8() {}
+    Vec3x8(Float8 a, Float8 b, Float8 c) : x(a), y(b), z(c) {}
+    Vec3x8(const vec3& v) : x(v.x), y(v.y), z(v.z) {}
+
+    friend SD_SIMD_TARGET Vec3x8 operator+(const Vec3x8& a, const Vec3x8& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    friend SD_SIMD_TARGET Vec3x8 operator-(const Vec3x8& a, const Vec3x8& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    friend SD_SIMD_TARGET Vec3x8 operator*(const Vec3x8& a, const Vec3x8& b) { return { a.x * b.x, a.y * b.y, a.z * b.z }; }
+    friend SD_SIMD_TARGET Vec3x8 operator*(const Vec3x8& a, Float8 s) { return { a.x * s, a.y * s, a.z * s }; }
+    friend SD_SIMD_TARGET Vec3x8 operator*(Float8 s, const Vec3x8& a) { return a * s; }
+    friend SD_SIMD_TARGET Vec3x8 operator-(const Vec3x8& a) { return { -a.x, -a.y, -a.z }; }
+
+    friend SD_SIMD_TARGET Float8 Dot(const Vec3x8& a, const Vec3x8& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    friend SD_SIMD_TARGET Vec3x8 Cross(const Vec3x8& a, const Vec3x8& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+    friend SD_SIMD_TARGET Vec3x8 Normalize(const Vec3x8& a) { return a * (Float8(1.0f) / Sqrt(Dot(a, a))); }
+    // GLSL reflect(i, n) = i - 2 * dot(n, i) * n
+    friend SD_SIMD_TARGET Vec3x8 Reflect(const Vec3x8& i, const Vec3x8& n) { return i - n * (Float8(2.0f) * Dot(n, i)); }
+    friend SD_SIMD_TARGET Vec3x8 Select(Float8 mask, const Vec3x8& a, const Vec3x8& b) {
+        return { Select(mask, a.x, b.x), Select(mask, a.y, b.y), Select(mask, a.z, b.z) };
+    }
+};
+}   // inline namespace SD_SIMD_NAMESPACE
+}
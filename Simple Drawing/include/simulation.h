@@ -0,0 +1,100 @@
+// include/simulation.h
+#pragma once
+#include <condition_variable>
+#include "triple_buffer.h"
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+// 模拟线程发布给渲染线程的不可变帧快照
+struct FrameSnapshot {
+    vec3 cameraPos = vec3(0.0f);
+    vec3 cameraFront = vec3(0.0f, 0.0f, -1.0f);
+    vec3 cameraRight = vec3(1.0f, 0.0f, 0.0f);
+    vec3 cameraUp = vec3(0.0f, 1.0f, 0.0f);
+    vec3 lightPos = vec3(0.0f);
+    float time = 0.0f;                 // 模拟时间(秒)
+    bool accumulate = false;
+    bool denoise = false;
+    bool temporal = false;
+    int framebufferWidth = 0;          // 窗口帧缓冲尺寸, 渲染线程据此调整渲染目标
+    int framebufferHeight = 0;
+
+    // 单调递增的计数: 快照可能被覆盖, 一次性事件用计数传递才不会丢失
+    unsigned int cameraVersion = 0;    // 相机变化次数(变化时重新开始累积)
+    unsigned int traceRequests = 0;    // F12按下次数(trace在渲染线程导出)
+    unsigned int refreshRequests = 0;  // 窗口重绘请求次数(被遮挡后露出等, 按需渲染时只重新显示上一帧)
+
+    unsigned long long tick = 0;
+    double sampleTime = 0.0;           // 采样输入的时刻(glfwGetTime), 用于统计输入延迟
+};
+
+/*
+    固定步长模拟: 拥有相机与光源状态, 按真实时间积分(移动速度与帧率无关),
+    每个步长结束后通过三缓冲发布快照, 渲染线程只读取快照并执行GL命令.
+    GLFW的事件处理与按键查询只能在主线程进行, 因此模拟运行在主线程, 渲染移到独立线程.
+    按需渲染(RenderData::idle)时, 超过kIdleDelay没有输入即进入空闲: 不再按步长唤醒,
+    只以kIdleWait为超时等待输入事件, 任何输入都会唤醒并立即恢复按步长运行.
+*/
+class Simulation {
+public:
+    static constexpr double kTickRate = 120.0;        // 每秒模拟步数
+    static constexpr double kMaxCatchUp = 0.25;       // 落后超过该时长(秒)时丢弃积压的步长
+    static constexpr float kMoveSpeed = 6.0f;         // 相机移动速度(单位/秒)
+    static constexpr float kMouseSensitivity = 0.1f;  // 鼠标灵敏度(度/像素)
+    static constexpr double kIdleDelay = 0.25;        // 最后一次输入后进入空闲的时长(秒)
+    static constexpr double kIdleWait = 0.5;          // 空闲时等待输入事件的超时(秒)
+
+    // 从RenderData拷贝初始相机, 并接管窗口的鼠标与尺寸回调; 需在主线程调用
+    Simulation(GLFWwindow* window, const RenderData* data);
+    ~Simulation();
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // 在主线程运行模拟循环, 直到窗口关闭
+    void Run();
+
+    // 渲染线程: 取出最新快照, 没有新快照时返回false
+    bool Consume(FrameSnapshot& snapshot) { return m_snapshots.Consume(snapshot); }
+    // 渲染线程: 阻塞到有新快照或超时, 有新快照时返回true
+    bool WaitForSnapshot(double timeoutSeconds);
+
+    unsigned long long TickCount() const { return m_state.tick; }
+    long long IdleWaits() const { return m_idleWaits; }
+
+    // 光源动画(与渲染无关, 基准测试也用它保证画面一致)
+    static vec3 LightPosition(float time);
+
+private:
+    void Tick(float dt);
+    void HandleKeys(double now);
+    void UpdateOrientation();
+    void Publish(double now);
+
+    static void MousePosCallback(GLFWwindow* window, double xpos, double ypos);
+    static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
+    static void WindowRefreshCallback(GLFWwindow* window);
+
+    GLFWwindow* m_window;
+    TripleBuffer<FrameSnapshot> m_snapshots;
+    std::mutex m_publishMutex;                     // 只用于唤醒等待快照的渲染线程
+    std::condition_variable m_publishSignal;
+    FrameSnapshot m_state;                 // 模拟线程独占的当前状态
+    FrameSnapshot m_published;             // 最近一次发布的快照
+    vec3 m_worldUp;
+
+    // 空闲
+    bool m_idleEnabled = false;
+    double m_lastActivity = 0.0;           // 最近一次发布有变化的快照的时刻
+    long long m_idleWaits = 0;
+
+    // 摄像机控制
+    bool m_mouseCaptured = true;
+    bool m_firstMouse = true;
+    float m_lastX = 0.0f;
+    float m_lastY = 0.0f;
+    float m_yaw = -90.0f;
+    float m_pitch = 0.0f;
+};
+}
@@ -0,0 +1,53 @@
+// include/staging_buffer.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// 待上传的元素范围: 逐个记录, 上传前排序并合并相邻或间隔很小的范围
+class DirtyRanges {
+public:
+    struct Range {
+        size_t first;
+        size_t count;
+    };
+
+    void Add(size_t first, size_t count = 1) { m_ranges.push_back({ first, count }); }
+    bool Empty() const { return m_ranges.empty(); }
+    void Clear() { m_ranges.clear(); }
+
+    // 合并后的范围(按起点升序); 间隔不超过maxGap个元素的范围合为一个, 用少量多余字节换更少的复制命令
+    std::vector<Range> Coalesce(size_t maxGap) const;
+
+private:
+    std::vector<Range> m_ranges;
+};
+
+/*
+    持久映射的暂存缓冲: 数据memcpy到当前槽位, 再由glCopyNamedBufferSubData复制到目标缓冲的对应位置,
+    不再整块glBufferData. 与UniformRing相同, 三个槽位轮换, 每个槽位被GPU复制完毕前由栅栏保护.
+    单次上传超过槽位剩余空间时(如首次上传大场景)直接glNamedBufferSubData.
+*/
+class StagingBuffer {
+public:
+    static constexpr int kSlots = 3;
+
+    explicit StagingBuffer(size_t slotSize);
+    ~StagingBuffer();
+    StagingBuffer(const StagingBuffer&) = delete;
+    StagingBuffer& operator=(const StagingBuffer&) = delete;
+
+    // 把size字节写入buffer的offset处(命令按提交顺序在之后的绘制/分派之前完成)
+    void Upload(unsigned int buffer, size_t offset, const void* data, size_t size);
+    // 本帧的复制命令已提交: 插入栅栏并切换到下一槽位(本帧未使用时不做任何事)
+    void Advance();
+
+private:
+    unsigned int m_buffer = 0;
+    char* m_mapped = nullptr;
+    size_t m_slotSize;
+    size_t m_used = 0;       // 当前槽位已写入的字节数
+    bool m_ready = false;    // 当前槽位的栅栏已等待
+    int m_slot = 0;
+    GLsync m_fences[kSlots] = {};
+};
+}
@@ -0,0 +1,66 @@
+// include/temporal_reprojection.h
+#pragma once
+#include "render_targets.h"
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+/*
+    时域重投影: 相机移动时复用上一帧的结果.
+    每帧的首次命中点(由G-buffer的线性深度重建)投影到上一帧相机, 邻域样本逐个按物体ID/深度/法线校验
+    (去遮挡检测), 全部通过时用Catmull-Rom重采样上一帧历史, 否则只用通过的双线性样本;
+    结果裁剪到当前帧3x3邻域的颜色包围盒后与当前样本按1/样本数混合. 配合逐帧的子像素抖动, 移动中也能得到多重采样的效果.
+    上一帧的G-buffer与历史都是乒乓目标, 交换即可, 不做拷贝.
+*/
+class TemporalReprojection {
+public:
+    static constexpr float kMaxHistory = 32.0f;   // 样本数上限(最小混合系数1/32)
+
+    explicit TemporalReprojection(const string& defines);
+    ~TemporalReprojection();
+    TemporalReprojection(const TemporalReprojection&) = delete;
+    TemporalReprojection& operator=(const TemporalReprojection&) = delete;
+
+    // (重新)分配历史与上一帧G-buffer, 尺寸与输出目标同一桶; 之后的第一帧不使用历史
+    void Resize(RenderTargetPool& pool, int width, int height);
+    void Release(RenderTargetPool& pool);
+    bool Allocated() const { return m_history[0].texture != 0; }
+
+    // 混合本帧与上一帧历史, 结果写入History()(未开启降噪时同时写入输出目标)
+    void Run(const RenderData& data);
+    // 帧末(降噪之后)调用: 本帧的G-buffer与相机留作下一帧的"上一帧"
+    void EndFrame(RenderData& data);
+    // 丢弃历史(开启时、场景变化后)
+    void Reset() { m_prevWidth = m_prevHeight = 0; }
+
+    const RenderTarget& History() const { return m_history[m_current]; }
+    int JitterIndex() const { return m_jitterIndex; }
+
+    // 程序(热重载直接替换)与源文件
+    unsigned int* Program() { return &m_program; }
+    static string ShaderPath();
+    void Reflect();    // 重新查询uniform位置(重载后调用)
+
+private:
+    unsigned int m_program = 0;
+    int m_prevCameraPosLocation = -1;
+    int m_prevCameraFrontLocation = -1;
+    int m_prevCameraRightLocation = -1;
+    int m_prevCameraUpLocation = -1;
+    int m_prevRenderSizeLocation = -1;
+    int m_maxHistoryLocation = -1;
+
+    RenderTarget m_history[2];          // 乒乓: rgb=线性颜色, a=样本数
+    int m_current = 0;                  // 本帧写入的历史下标
+    RenderTarget m_prevNormalDepth;     // 上一帧的G-buffer(与RenderData中的本帧G-buffer逐帧交换)
+    RenderTarget m_prevAlbedoId;
+
+    vec3 m_prevCameraPos = vec3(0.0f);
+    vec3 m_prevCameraFront = vec3(0.0f, 0.0f, -1.0f);
+    vec3 m_prevCameraRight = vec3(1.0f, 0.0f, 0.0f);
+    vec3 m_prevCameraUp = vec3(0.0f, 1.0f, 0.0f);
+    int m_prevWidth = 0, m_prevHeight = 0;   // 0表示没有可用历史
+    int m_jitterIndex = 0;                   // 子像素抖动序号, 相机移动时不重置
+};
+}
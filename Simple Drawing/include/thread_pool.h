@@ -0,0 +1,39 @@
+// include/thread_pool.h
+#pragma once
+#include <condition_variable>
+
+namespace SimpleDrawingDemo {
+
+// 常驻线程池: 以ParallelFor方式分发任务, 调用线程同样参与执行
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount = 0);   // 0表示使用全部硬件线程
+    ~ThreadPool();
+
+    int ThreadCount() const { return static_cast<int>(m_threads.size()) + 1; }
+
+    // 并行执行fn(0 ~ count-1), 阻塞直到全部完成
+    // 在工作线程内部嵌套调用时直接串行执行, 避免死锁
+    void ParallelFor(int count, const std::function<void(int)>& fn);
+
+    static ThreadPool& Shared();
+
+private:
+    void WorkerMain();
+    void RunIndices(const std::function<void(int)>* job, int count);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_submitMutex;          // 串行化多个外部线程的提交
+    std::mutex m_mutex;
+    std::condition_variable m_wake, m_done;
+
+    const std::function<void(int)>* m_job = nullptr;
+    std::atomic<int> m_next{ 0 };
+    int m_count = 0;
+    int m_active = 0;
+    unsigned long long m_generation = 0;
+    bool m_stop = false;
+
+    static thread_local bool t_inPool;
+};
+}
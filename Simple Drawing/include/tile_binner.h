@@ -0,0 +1,55 @@
+// include/tile_binner.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+// 分块列表的SSBO绑定点(与common/tiles.glsl一致, 接在三角形缓冲之后)
+enum TileBinding {
+    TILE_BINDING_COUNTS = 14,
+    TILE_BINDING_PRIMITIVES = 15
+};
+
+/*
+    屏幕空间图元分块(分块光源剔除的做法用于几何体):
+    每帧在追踪之前, 每个图元的包围球(三角形为三个顶点)投影到屏幕, 按覆盖的块原子追加到各块的图元列表.
+    块与单内核的工作组一一对应, 工作组把本块列表读入共享内存后, 主光线只测试列表中的图元;
+    反射与阴影光线仍遍历BVH. 列表超过容量的块整体退回BVH, 结果不变.
+    只依赖当前帧的图元位置与相机, 物体移动后无需重建任何结构.
+*/
+class TileBinner {
+public:
+    static constexpr int kTileCapacity = 128;   // 每块的列表容量(TILE_CAPACITY)
+    static constexpr int kGroupSize = 64;       // 分块pass的工作组大小(每个调用一个图元)
+
+    explicit TileBinner(const string& defines);
+    ~TileBinner();
+    TileBinner(const TileBinner&) = delete;
+    TileBinner& operator=(const TileBinner&) = delete;
+
+    // 按data的渲染区域与工作组形状分块; 调用前需绑定帧数据UBO与场景SSBO
+    void Run(const RenderData& data);
+
+    // 注入分块pass与单内核的宏(开启主光线的分块求交)
+    static string Defines();
+
+    // 程序(热重载直接替换)与源文件
+    unsigned int* Program() { return &m_program; }
+    static string ShaderPath();
+    void Reflect();    // 重新查询uniform位置(重载后调用)
+
+    size_t AllocatedBytes() const;
+
+private:
+    void Reserve(size_t tiles);
+
+    unsigned int m_program = 0;
+    int m_tileSizeLocation = -1;
+    int m_tileCountLocation = -1;
+
+    unsigned int m_counts = 0;        // 每块的图元数
+    unsigned int m_primitives = 0;    // 每块kTileCapacity项图元索引
+    size_t m_capacity = 0;            // 块数容量
+};
+}
@@ -0,0 +1,50 @@
+// include/triple_buffer.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+/*
+    单生产者/单消费者的无锁三缓冲: 写端始终写自己独占的后台槽位, 写完后与中间槽位交换;
+    读端有新数据时再与中间槽位交换. 双方都不会等待对方, 读端总是拿到最新发布的完整数据,
+    中间未被读取的旧数据直接被覆盖.
+    中间槽位的索引与"有新数据"标志打包在同一个原子变量里, 交换只需一次exchange.
+*/
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // 写端: 发布一份新数据
+    void Publish(const T& value) {
+        m_slots[m_back].value = value;
+        unsigned int previous = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+    }
+
+    // 读端: 有新数据时取出并返回true, 否则保持out不变
+    bool Consume(T& out) {
+        if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        unsigned int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & kIndexMask;
+        out = m_slots[m_front].value;
+        return true;
+    }
+
+    // 读端: 是否有尚未取出的新数据
+    bool Pending() const { return (m_middle.load(std::memory_order_acquire) & kFresh) != 0; }
+
+private:
+    static constexpr unsigned int kIndexMask = 3;
+    static constexpr unsigned int kFresh = 4;
+
+    // 每个槽位独占缓存行, 避免读写两端伪共享
+    struct alignas(64) Slot { T value{}; };
+    Slot m_slots[3];
+
+    alignas(64) unsigned int m_back = 0;                  // 写端独占
+    alignas(64) std::atomic<unsigned int> m_middle{ 1 };  // 两端共享
+    alignas(64) unsigned int m_front = 2;                 // 读端独占
+};
+}
@@ -0,0 +1,32 @@
+// include/uniform_ring.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+/*
+    持久映射的UBO环形缓冲: 每帧写入一个槽位(一次memcpy + 一次glBindBufferRange),
+    槽位被GPU使用完毕前由栅栏保护, 三个槽位即可让CPU写入与GPU读取互不等待.
+*/
+class UniformRing {
+public:
+    static constexpr int kSlots = 3;
+
+    explicit UniformRing(size_t blockSize);
+    ~UniformRing();
+    UniformRing(const UniformRing&) = delete;
+    UniformRing& operator=(const UniformRing&) = delete;
+
+    // 等待当前槽位空闲, 写入数据并绑定到指定UBO绑定点
+    void Update(const void* data, unsigned int binding);
+    // 本帧使用该槽位的命令已提交: 插入栅栏并切换到下一槽位
+    void Advance();
+
+private:
+    unsigned int m_buffer = 0;
+    char* m_mapped = nullptr;
+    size_t m_blockSize;
+    size_t m_stride;
+    int m_slot = 0;
+    GLsync m_fences[kSlots] = {};
+};
+}
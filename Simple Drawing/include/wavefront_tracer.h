@@ -0,0 +1,56 @@
+// include/wavefront_tracer.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+// 波前队列的SSBO绑定点(与common/wavefront.glsl一致, 接在场景与BVH之后)
+enum WavefrontBinding {
+    WAVEFRONT_BINDING_CURRENT_RAYS = 8,
+    WAVEFRONT_BINDING_NEXT_RAYS = 9,
+    WAVEFRONT_BINDING_SHADOW_RAYS = 10,
+    WAVEFRONT_BINDING_RADIANCE = 11
+};
+
+/*
+    波前路径追踪: 把单内核的traceRay拆成独立的计算pass,
+    生成 -> (求交 -> 着色 -> 分派参数 -> 阴影 -> 汇总) x 反弹次数 -> 输出.
+    光线在pass之间通过SSBO队列传递, 着色时用原子计数追加(压缩掉已终止的路径),
+    后续pass用glDispatchComputeIndirect按队列实际长度分派, 反弹越深、场景越大, SIMD利用率越高.
+    阴影光线单独成队, 用any-hit遮挡查询, 命中任意遮挡物即结束.
+*/
+class WavefrontTracer {
+public:
+    enum Pass { Generate, Extend, Shade, Dispatch, Shadow, Resolve, Finalize, kPassCount };
+    static constexpr int kGroupSize = 64;            // 一维pass的工作组大小(WAVEFRONT_GROUP_SIZE)
+    static constexpr int kShadowRaysPerPath = 2;     // 阴影队列容量(每条路径), 超出时在着色pass内直接查询
+    static constexpr size_t kQueueHeaderSize = 32;   // count + 填充 + 间接分派参数
+
+    // maxBounces需与defines中的MAX_BOUNCES一致
+    WavefrontTracer(const string& defines, int maxBounces);
+    ~WavefrontTracer();
+    WavefrontTracer(const WavefrontTracer&) = delete;
+    WavefrontTracer& operator=(const WavefrontTracer&) = delete;
+
+    // 渲染左下角width x height区域到输出图像; 调用前需绑定帧数据UBO、场景SSBO与输出图像
+    void Render(int width, int height);
+
+    // 各pass的程序(热重载直接替换)与源文件
+    unsigned int* Program(Pass pass) { return &m_programs[pass]; }
+    static string PassPath(Pass pass);
+    void Reflect();    // 重新查询uniform位置(着色pass重载后调用)
+
+    size_t AllocatedBytes() const;
+
+private:
+    void Reserve(size_t pixels);
+
+    unsigned int m_programs[kPassCount] = {};
+    int m_bounceLocation = -1;
+    int m_maxBounces;
+
+    unsigned int m_rayQueues[2] = {};    // 乒乓: 本次反弹的输入队列 / 下一次反弹的输出队列
+    unsigned int m_shadowQueue = 0;
+    unsigned int m_radiance = 0;
+    size_t m_capacity = 0;               // 路径容量(像素数)
+};
+}
@@ -0,0 +1,40 @@
+// include/workgroup_tuner.h
+#pragma once
+
+namespace SimpleDrawingDemo {
+
+struct RenderData;
+
+// 单内核追踪的工作组形状(以LOCAL_SIZE_X/LOCAL_SIZE_Y宏注入ray_tracing.glsl), 分派的工作组数随之计算
+struct WorkgroupSize {
+    int x = 16;
+    int y = 16;
+
+    string Defines() const;
+    string Name() const;     // 如"16x16"
+    int GroupsX(int width) const { return (width + x - 1) / x; }
+    int GroupsY(int height) const { return (height + y - 1) / y; }
+    bool Supported() const;  // 不超过驱动的工作组尺寸与调用数上限(需要GL上下文)
+
+    static bool Parse(const string& text, WorkgroupSize& out);
+};
+
+/*
+    工作组形状自动调优: 在当前驱动上逐个编译候选形状的ray_tracing.glsl变体(各自进入程序二进制缓存),
+    按相同的相机路径渲染若干帧并用GPU时间戳计时, 最快的形状按驱动(厂商/渲染器/版本)写入AUTOTUNE_PATH.
+    之后的启动直接读取该结果; 驱动更新后不再匹配, 回退到默认的16x16.
+*/
+class WorkgroupTuner {
+public:
+    static const std::vector<WorkgroupSize>& Candidates();
+
+    // 读取当前驱动保存的结果, 没有(或已不受支持)时返回false
+    static bool Load(WorkgroupSize& out);
+    // 测量全部候选形状, 选用最快的并保存; 调用前需完成InitRayTracingResources且使用GPU后端
+    static WorkgroupSize Run(GLFWwindow* window, RenderData* data);
+
+private:
+    static string DriverKey();
+    static void Save(const WorkgroupSize& best, const nlohmann::json& results, int width, int height);
+};
+}
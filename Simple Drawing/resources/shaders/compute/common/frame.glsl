@@ -0,0 +1,61 @@
+// resources/shaders/compute/common/frame.glsl
+// 计算着色器共用: 渲染目标、每帧数据与色调映射(由Shader::Preprocess展开)
+
+// 渲染目标格式由RenderData::ComputeDefines注入(与glBindImageTexture的格式一致)
+#ifndef OUTPUT_FORMAT
+#define OUTPUT_FORMAT rgba32f
+#endif
+#ifndef HISTORY_FORMAT
+#define HISTORY_FORMAT rgba32f
+#endif
+#ifdef MULTI_VIEW
+// 多视图: 每个视图写入纹理数组的一层(渲染期间临时绑定到输出的图像单元0), 位置与层由main设置
+layout(OUTPUT_FORMAT, binding = 0) uniform writeonly image2DArray outputImage;
+ivec3 viewTarget = ivec3(0);   // xy=视口在层内的偏移, z=层
+#define OUTPUT_COORD(p) ivec3((p) + viewTarget.xy, viewTarget.z)
+#else
+layout(OUTPUT_FORMAT, binding = 0) uniform writeonly image2D outputImage;
+#define OUTPUT_COORD(p) (p)
+#endif
+layout(HISTORY_FORMAT, binding = 1) uniform image2D historyImage;   // 累积历史(线性颜色均值)
+
+// 每帧数据(std140, 由UniformRing写入, 布局与FrameUniforms一致)
+layout(std140, binding = 0) uniform FrameData {
+    vec3 cameraPos;   float time;
+    vec3 cameraFront; int frameIndex;    // 已累积帧数, 0表示重新开始
+    vec3 cameraRight; int numSpheres;
+    vec3 cameraUp;    int numLights;
+    bool accumulate;                     // 渐进累积模式
+    int renderWidth;                     // 实际追踪区域(动态分辨率, 位于图像左下角)
+    int renderHeight;
+    bool denoise;                        // 输出线性颜色与G-buffer, 由denoise.glsl滤波后写入输出
+    bool temporal;                       // 时域重投影: 同上, 由temporal.glsl与上一帧历史混合
+    int jitterIndex;                     // 时域模式的抖动序号(逐帧递增, 相机移动时不重置)
+    int numTriangles;                    // 网格三角形数(图元索引从numSpheres开始)
+};
+
+#define MAX_DISTANCE 10000.0
+
+// 简单随机数生成
+float rand(vec2 co) {
+    return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+// 渲染区域内某点(像素坐标, 像素中心为+0.5)的相机光线方向
+vec3 cameraRay(vec2 pixelPos) {
+    vec2 size = vec2(renderWidth, renderHeight);
+    vec2 uv = pixelPos / size;
+    uv = uv * 2.0 - 1.0;
+
+    // 相机设置
+    float aspectRatio = size.x / size.y;
+
+    // 使用传入的相机方向向量
+    return normalize(cameraFront + uv.x * cameraRight * aspectRatio + uv.y * cameraUp);
+}
+
+// 色调映射与Gamma校正
+vec3 toneMap(vec3 color) {
+    color = color / (color + vec3(1.0));
+    return pow(color, vec3(1.0/2.2));
+}
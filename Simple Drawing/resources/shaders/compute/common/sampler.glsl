@@ -0,0 +1,89 @@
+// resources/shaders/compute/common/sampler.glsl
+// 逐像素/逐帧的采样序列(主光线子像素抖动等), 由SAMPLER宏选择, 与Sampler(CPU端)逐位一致
+
+#define SAMPLER_HASH 0         // fract(sin)哈希(旧实现, 白噪声)
+#define SAMPLER_R2 1           // R2序列 + 逐像素随机平移
+#define SAMPLER_SOBOL 2        // 逐像素打乱+Owen扰乱的Sobol(0,2)序列
+#define SAMPLER_BLUE_NOISE 3   // 平铺蓝噪声(void-and-cluster) + 逐帧R2偏移
+
+#ifndef SAMPLER
+#define SAMPLER SAMPLER_SOBOL
+#endif
+
+#if SAMPLER == SAMPLER_BLUE_NOISE
+#define BLUE_NOISE_SIZE 64
+layout(std430, binding = 17) readonly buffer BlueNoise { vec2 blueNoise[]; };   // BLUE_NOISE_SIZE^2项, 两个独立的掩码
+#endif
+
+// 采样维度(同一像素上各用途的序列互不相关)
+#define SAMPLE_DIMENSION_JITTER 0u
+
+// 扰乱种子: 与维度异或, 非0时得到与默认序列互不相关的另一组样本(收敛测试的参考图)
+#ifndef SAMPLER_SCRAMBLE
+#define SAMPLER_SCRAMBLE 0u
+#endif
+
+// 整数哈希(lowbias32)
+uint hashUint(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+uint hashPixel(ivec2 pixel, uint dimension) {
+    return hashUint(uint(pixel.x) ^ hashUint(uint(pixel.y) ^ hashUint(dimension)));
+}
+
+// 高24位映射到[0, 1)(float可精确表示)
+float toUnit(uint x) {
+    return float(x >> 8) * (1.0 / 16777216.0);
+}
+
+// Laine-Karras置换: 作用在位反转后的值上即为嵌套均匀扰乱(Owen扰乱)
+uint nestedUniformScramble(uint x, uint seed) {
+    x = bitfieldReverse(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return bitfieldReverse(x);
+}
+
+// Sobol序列的第二维(第一维为位反转)
+uint sobolSecond(uint index) {
+    uint result = 0u;
+    for (uint v = 1u << 31; index != 0u; index >>= 1, v ^= v >> 1) {
+        if ((index & 1u) != 0u) result ^= v;
+    }
+    return result;
+}
+
+// 第index个二维样本, 各分量在[0, 1); dimension区分同一像素上互不相关的用途
+vec2 sample2D(ivec2 pixel, uint index, uint dimension) {
+#if SAMPLER == SAMPLER_HASH
+    float seed = float(index);
+    return vec2(rand(vec2(pixel) + seed * 0.7548777), rand(vec2(pixel) + seed * 0.5698403 + 17.0));
+#elif SAMPLER == SAMPLER_R2
+    // R2: 步长为塑料数的倒数(定点数), 逐像素随机平移去除像素间的相关
+    uint seed = hashPixel(pixel, dimension);
+    return vec2(toUnit(hashUint(seed) + index * 3242174889u), toUnit(hashUint(seed + 1u) + index * 2447445414u));
+#elif SAMPLER == SAMPLER_SOBOL
+    // 逐像素打乱样本顺序, 两维各自Owen扰乱: 任意2的幂前缀仍保持分层
+    uint seed = hashPixel(pixel, dimension);
+    uint shuffled = nestedUniformScramble(index, seed);
+    uint x = nestedUniformScramble(bitfieldReverse(shuffled), hashUint(seed));
+    uint y = nestedUniformScramble(sobolSecond(shuffled), hashUint(seed + 1u));
+    return vec2(toUnit(x), toUnit(y));
+#else
+    // 蓝噪声: 相邻像素的值互补(误差集中在高频); 逐帧按R2平移, 同一像素的时间序列也低差异
+    uint shift = hashUint(dimension);
+    ivec2 tile = (pixel + ivec2(shift, shift >> 8)) & (BLUE_NOISE_SIZE - 1);
+    vec2 noise = blueNoise[tile.y * BLUE_NOISE_SIZE + tile.x];
+    uvec2 offset = uvec2(noise * 16777216.0) << 8;
+    return vec2(toUnit(offset.x + index * 3242174889u), toUnit(offset.y + index * 2447445414u));
+#endif
+}
@@ -0,0 +1,300 @@
+// resources/shaders/compute/common/scene.glsl
+// 光线追踪各计算着色器共用: 场景缓冲、求交、G-buffer与输出(由Shader::Preprocess展开)
+
+#include "frame.glsl"
+#include "sampler.glsl"
+
+// G-buffer与线性颜色(仅在降噪/时域模式下写入, 由denoise.glsl与temporal.glsl读取)
+layout(rgba32f, binding = 2) uniform writeonly image2D gbufferNormalDepth;   // xyz=首次命中法线, w=线性深度(未命中为MAX_DISTANCE)
+layout(rgba32f, binding = 3) uniform writeonly image2D gbufferAlbedoId;      // rgb=反照率(未命中为天空颜色), a=命中物体的材质索引(-1为天空)
+layout(rgba16f, binding = 4) uniform writeonly image2D noisyImage;           // 累积后、色调映射前的线性颜色
+
+// 场景数据(std430紧凑布局, 由Scene::Upload上传)
+// 图元索引小于numSpheres为球体, 否则为三角形(索引 - numSpheres); 材质的前numSpheres项属于球体, 之后每个网格一项
+layout(std430, binding = 1) readonly buffer SphereCenterRadius { vec4 sphereCenterRadius[]; };       // xyz=球心, w=半径
+layout(std430, binding = 2) readonly buffer MaterialColorSpecular { vec4 materialColorSpecular[]; }; // rgb=颜色, a=高光指数
+layout(std430, binding = 3) readonly buffer MaterialReflectivity { float materialReflectivity[]; };
+layout(std430, binding = 4) readonly buffer MaterialEmission { float materialEmission[]; };
+layout(std430, binding = 5) readonly buffer SceneLights { int lightIndices[]; };                     // 光源球体索引
+
+// 三角形(8~11为波前队列)
+layout(std430, binding = 12) readonly buffer TriangleVertices { vec4 triangleVertices[]; };   // 每个三角形3项: v0, e1 = v1 - v0, e2 = v2 - v0
+layout(std430, binding = 13) readonly buffer TriangleShading { uvec4 triangleShading[]; };    // xyz=顶点法线(八面体编码), w=材质索引
+
+// BVH(深度优先排列, 每个节点两个vec4: xyz=包围盒, w=offset/count的位模式)
+layout(std430, binding = 6) readonly buffer BvhNodes { vec4 bvhNodes[]; };
+layout(std430, binding = 7) readonly buffer BvhPrimitives { int bvhPrimIndices[]; };
+
+#define BVH_STACK_SIZE 48
+
+// 反弹次数(宿主按--bounces注入)
+#ifndef MAX_BOUNCES
+#define MAX_BOUNCES 3
+#endif
+
+// 光线与球体求交
+float intersectSphere(vec4 centerRadius, vec3 rayOrigin, vec3 rayDir) {
+    vec3 oc = rayOrigin - centerRadius.xyz;
+    float a = dot(rayDir, rayDir);
+    float b = 2.0 * dot(oc, rayDir);
+    float c = dot(oc, oc) - centerRadius.w * centerRadius.w;
+    float discriminant = b * b - 4.0 * a * c;
+
+    if (discriminant < 0.0) {
+        return -1.0;
+    }
+
+    return (-b - sqrt(discriminant)) / (2.0 * a);
+}
+
+// 光线与三角形求交(Möller–Trumbore, 边已预先算好), 未命中返回-1
+float intersectTriangle(int triangle, vec3 rayOrigin, vec3 rayDir) {
+    vec3 e1 = triangleVertices[triangle * 3 + 1].xyz;
+    vec3 e2 = triangleVertices[triangle * 3 + 2].xyz;
+    vec3 p = cross(rayDir, e2);
+    float det = dot(e1, p);
+    if (abs(det) < 1e-12) return -1.0;   // 光线与三角形平行
+
+    float invDet = 1.0 / det;
+    vec3 s = rayOrigin - triangleVertices[triangle * 3].xyz;
+    float u = dot(s, p) * invDet;
+    if (u < 0.0 || u > 1.0) return -1.0;
+
+    vec3 q = cross(s, e1);
+    float v = dot(rayDir, q) * invDet;
+    if (v < 0.0 || u + v > 1.0) return -1.0;
+
+    return dot(e2, q) * invDet;
+}
+
+// 按图元类型求交
+float intersectPrimitive(int primitive, vec3 rayOrigin, vec3 rayDir) {
+    if (primitive < numSpheres) return intersectSphere(sphereCenterRadius[primitive], rayOrigin, rayDir);
+    return intersectTriangle(primitive - numSpheres, rayOrigin, rayDir);
+}
+
+// 光线与包围盒求交(slab), 返回进入距离, 未命中返回1e30
+float intersectAabb(int node, vec3 rayOrigin, vec3 invDir, float maxT) {
+    vec3 t0 = (bvhNodes[node * 2].xyz - rayOrigin) * invDir;
+    vec3 t1 = (bvhNodes[node * 2 + 1].xyz - rayOrigin) * invDir;
+    vec3 tmin = min(t0, t1);
+    vec3 tmax = max(t0, t1);
+    float enter = max(max(tmin.x, tmin.y), max(tmin.z, 0.0));
+    float exit = min(min(tmax.x, tmax.y), min(tmax.z, maxT));
+    return enter <= exit ? enter : 1e30;
+}
+
+vec3 safeInverse(vec3 rayDir) {
+    vec3 safeDir = vec3(
+        abs(rayDir.x) > 1e-8 ? rayDir.x : 1e-8,
+        abs(rayDir.y) > 1e-8 ? rayDir.y : 1e-8,
+        abs(rayDir.z) > 1e-8 ? rayDir.z : 1e-8);
+    return 1.0 / safeDir;
+}
+
+// 场景求交(BVH遍历, 就近子节点优先)
+bool intersectScene(vec3 rayOrigin, vec3 rayDir, out int hitIndex, out float minT) {
+    minT = MAX_DISTANCE;
+    hitIndex = -1;
+    if (numSpheres + numTriangles == 0) return false;
+
+    vec3 invDir = safeInverse(rayDir);
+
+    int stack[BVH_STACK_SIZE];
+    int sp = 0;
+    int node = 0;
+    if (intersectAabb(0, rayOrigin, invDir, minT) >= 1e30) return false;
+
+    while (true) {
+        int offset = floatBitsToInt(bvhNodes[node * 2].w);
+        int count = floatBitsToInt(bvhNodes[node * 2 + 1].w);
+
+        if (count > 0) {
+            // 叶子: 逐个图元求交
+            for (int i = offset; i < offset + count; i++) {
+                int primitive = bvhPrimIndices[i];
+                float t = intersectPrimitive(primitive, rayOrigin, rayDir);
+                if (t > 0.0001 && t < minT) {
+                    minT = t;
+                    hitIndex = primitive;
+                }
+            }
+        } else {
+            // 内部节点: 左子节点紧随其后, 右子节点为offset
+            int nearNode = node + 1;
+            int farNode = offset;
+            float nearT = intersectAabb(nearNode, rayOrigin, invDir, minT);
+            float farT = intersectAabb(farNode, rayOrigin, invDir, minT);
+            if (farT < nearT) {
+                int tmpNode = nearNode; nearNode = farNode; farNode = tmpNode;
+                float tmpT = nearT; nearT = farT; farT = tmpT;
+            }
+
+            if (nearT < 1e30) {
+                if (farT < 1e30 && sp < BVH_STACK_SIZE) stack[sp++] = farNode;
+                node = nearNode;
+                continue;
+            }
+        }
+
+        if (sp == 0) break;
+        node = stack[--sp];
+    }
+
+    return hitIndex != -1;
+}
+
+// 遮挡查询(any-hit): (0.0001, maxT)内有任意图元(ignoreIndex除外)即返回, 不求最近交点
+bool occluded(vec3 rayOrigin, vec3 rayDir, float maxT, int ignoreIndex) {
+    if (numSpheres + numTriangles == 0) return false;
+
+    vec3 invDir = safeInverse(rayDir);
+
+    int stack[BVH_STACK_SIZE];
+    int sp = 0;
+    int node = 0;
+    if (intersectAabb(0, rayOrigin, invDir, maxT) >= 1e30) return false;
+
+    while (true) {
+        int offset = floatBitsToInt(bvhNodes[node * 2].w);
+        int count = floatBitsToInt(bvhNodes[node * 2 + 1].w);
+
+        if (count > 0) {
+            for (int i = offset; i < offset + count; i++) {
+                int primitive = bvhPrimIndices[i];
+                if (primitive == ignoreIndex) continue;
+                float t = intersectPrimitive(primitive, rayOrigin, rayDir);
+                if (t > 0.0001 && t < maxT) return true;
+            }
+        } else {
+            // 顺序无关, 两个子节点都压栈
+            if (intersectAabb(offset, rayOrigin, invDir, maxT) < 1e30 && sp < BVH_STACK_SIZE) stack[sp++] = offset;
+            if (intersectAabb(node + 1, rayOrigin, invDir, maxT) < 1e30) {
+                node = node + 1;
+                continue;
+            }
+        }
+
+        if (sp == 0) break;
+        node = stack[--sp];
+    }
+
+    return false;
+}
+
+// 阴影光线的最远距离: 到光源表面为止(起点在光源内部时不限制)
+float lightDistance(int lightIndex, vec3 rayOrigin, vec3 rayDir) {
+    float t = intersectSphere(sphereCenterRadius[lightIndex], rayOrigin, rayDir);
+    return t > 0.0001 ? t : MAX_DISTANCE;
+}
+
+// 计算法向量
+vec3 calculateNormal(vec3 center, vec3 point) {
+    return normalize(point - center);
+}
+
+// 八面体编码的单位法线(与Scene的PackNormal一致)
+vec3 unpackNormal(uint bits) {
+    vec2 e = unpackSnorm2x16(bits);
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * mix(vec2(-1.0), vec2(1.0), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
+// 命中图元的材质索引
+int materialIndex(int hitIndex) {
+    return hitIndex < numSpheres ? hitIndex : int(triangleShading[hitIndex - numSpheres].w);
+}
+
+// 命中点法线: 球体为径向; 三角形按重心坐标插值顶点法线, 并翻到入射光线一侧(网格不区分正反面)
+vec3 surfaceNormal(int hitIndex, vec3 rayOrigin, vec3 rayDir, vec3 hitPoint) {
+    if (hitIndex < numSpheres) return calculateNormal(sphereCenterRadius[hitIndex].xyz, hitPoint);
+
+    int triangle = hitIndex - numSpheres;
+    vec3 e1 = triangleVertices[triangle * 3 + 1].xyz;
+    vec3 e2 = triangleVertices[triangle * 3 + 2].xyz;
+    vec3 s = hitPoint - triangleVertices[triangle * 3].xyz;
+
+    // 由命中点求重心坐标(解2x2线性方程组)
+    float d11 = dot(e1, e1), d12 = dot(e1, e2), d22 = dot(e2, e2);
+    float s1 = dot(s, e1), s2 = dot(s, e2);
+    float invDenom = 1.0 / max(d11 * d22 - d12 * d12, 1e-30);
+    float u = clamp((d22 * s1 - d12 * s2) * invDenom, 0.0, 1.0);
+    float v = clamp((d11 * s2 - d12 * s1) * invDenom, 0.0, 1.0 - u);
+
+    uvec4 shading = triangleShading[triangle];
+    vec3 normal = normalize((1.0 - u - v) * unpackNormal(shading.x) + u * unpackNormal(shading.y) + v * unpackNormal(shading.z));
+    vec3 geometric = cross(e1, e2);
+    if (dot(normal, geometric) < 0.0) normal = -normal;
+    return faceforward(normal, rayDir, geometric);
+}
+
+// 天空颜色
+vec3 skyColor(vec3 rayDir) {
+    float t = 0.5 * (rayDir.y + 1.0);
+    return (1.0 - t) * vec3(0.1, 0.1, 0.3) + t * vec3(0.5, 0.7, 1.0);
+}
+
+// 单个光源的直接光照: lit为未被遮挡时的贡献, shadowed为被遮挡时的贡献
+void directLight(int lightIndex, vec3 hitPoint, vec3 normal, vec3 viewDir, vec4 material,
+                 out vec3 lightDir, out vec3 lit, out vec3 shadowed) {
+    vec3 lightPos = sphereCenterRadius[lightIndex].xyz;
+    lightDir = normalize(lightPos - hitPoint);
+
+    // 基础光照
+    float diff = max(dot(normal, lightDir), 0.0);
+
+    // 镜面反射
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.a);
+
+    lit = diff * material.rgb + vec3(0.8) * spec;
+    shadowed = diff * material.rgb * 0.3;
+}
+
+// 主光线方向(累积/时域模式下每帧取采样序列的下一个子像素抖动)
+vec3 primaryRayDir(ivec2 storePos) {
+    vec2 jitter = vec2(0.0);
+    if (accumulate || temporal) {
+        uint index = uint(accumulate ? frameIndex : jitterIndex);
+        jitter = sample2D(storePos, index, SAMPLE_DIMENSION_JITTER ^ SAMPLER_SCRAMBLE) - 0.5;
+    }
+
+    return cameraRay(vec2(storePos) + 0.5 + jitter);
+}
+
+// 降噪或时域重投影需要首次命中的G-buffer与线性颜色
+bool gbufferEnabled() {
+    return denoise || temporal;
+}
+
+// 首次命中信息写入G-buffer(material为命中物体的材质索引, 网格整体算一个物体; -1表示天空)
+void writeGBuffer(ivec2 storePos, int material, float t, vec3 rayDir, vec3 normal, vec3 albedo) {
+    float depth = material >= 0 ? t * dot(rayDir, cameraFront) : MAX_DISTANCE;
+    imageStore(gbufferNormalDepth, storePos, vec4(material >= 0 ? normal : vec3(0.0), depth));
+    imageStore(gbufferAlbedoId, storePos, vec4(albedo, float(material)));
+}
+
+// 累积/胶片颗粒、色调映射后写入输出图像; 降噪/时域模式下线性颜色交给后续pass
+void writePixel(ivec2 storePos, vec3 color) {
+    if (accumulate) {
+        // 逐像素滑动平均
+        if (frameIndex > 0) {
+            vec3 history = imageLoad(historyImage, storePos).rgb;
+            color = mix(history, color, 1.0 / float(frameIndex + 1));
+        }
+        imageStore(historyImage, storePos, vec4(color, 1.0));
+    } else if (!gbufferEnabled()) {
+        // 添加一些噪声模拟胶片颗粒
+        float noise = 0.05 * rand(vec2(storePos) + time);
+        color += vec3(noise);
+    }
+
+    if (gbufferEnabled()) {
+        imageStore(noisyImage, storePos, vec4(color, 1.0));
+        return;
+    }
+
+    // 输出颜色
+    imageStore(outputImage, OUTPUT_COORD(storePos), vec4(toneMap(color), 1.0));
+}
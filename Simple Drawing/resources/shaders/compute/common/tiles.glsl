@@ -0,0 +1,9 @@
+// resources/shaders/compute/common/tiles.glsl
+// 屏幕空间分块的图元列表: tile_binning.glsl写入, ray_tracing.glsl的主光线读取(由Shader::Preprocess展开)
+// 块与单内核的工作组一一对应, 块号 = 行 * 每行块数 + 列
+
+#ifndef TILE_CAPACITY
+#define TILE_CAPACITY 128
+#endif
+layout(std430, binding = 14) buffer TileCounts { uint tileCounts[]; };          // 每块落入的图元数(可能超过容量, 超出表示溢出)
+layout(std430, binding = 15) buffer TilePrimitives { int tilePrimitives[]; };   // 每块TILE_CAPACITY项图元索引, 顺序不定
@@ -0,0 +1,49 @@
+// resources/shaders/compute/common/wavefront.glsl
+// 波前路径追踪各pass共用的队列布局(缓冲由WavefrontTracer创建, 每个队列头后紧跟记录数组)
+
+#define WAVEFRONT_GROUP_SIZE 64
+
+// 路径段:
+//   origin.w     = 像素索引(位模式)
+//   direction.w  = 最近交点距离(extend写入)
+//   throughput.w = 命中的图元(位模式, -1表示未命中; extend写入)
+//   shading.rgb  = 本段不依赖阴影的光照(天空/自发光/溢出时直接算出的光照; shade写入)
+//   shading.w    = 本段阴影记录的起始下标(位模式, -1表示没有; 记录数为numLights)
+struct PathRay {
+    vec4 origin;
+    vec4 direction;
+    vec4 throughput;
+    vec4 shading;
+};
+
+// 阴影光线: origin.w=最远距离(光源表面), direction.w=光源图元(位模式),
+// lit/shadowed为可见/被遮挡时的贡献, lit.w为shadow pass写入的可见性
+struct ShadowRay {
+    vec4 origin;
+    vec4 direction;
+    vec4 lit;
+    vec4 shadowed;
+};
+
+// 队列头: count为追加计数(可能超过容量, 读取时按length()截断), dispatch为间接分派参数(偏移16字节)
+layout(std430, binding = 8) buffer CurrentRays {
+    uint currentCount; uint currentPad0, currentPad1, currentPad2;
+    uvec4 currentDispatch;
+    PathRay currentRays[];
+};
+layout(std430, binding = 9) buffer NextRays {
+    uint nextCount; uint nextPad0, nextPad1, nextPad2;
+    uvec4 nextDispatch;
+    PathRay nextRays[];
+};
+layout(std430, binding = 10) buffer ShadowRays {
+    uint shadowCount; uint shadowPad0, shadowPad1, shadowPad2;
+    uvec4 shadowDispatch;
+    ShadowRay shadowRays[];
+};
+
+// 逐像素累计的线性颜色(各次反弹的贡献)
+layout(std430, binding = 11) buffer Radiance { vec4 radiance[]; };
+
+uint currentLength() { return min(currentCount, uint(currentRays.length())); }
+uint shadowLength() { return min(shadowCount, uint(shadowRays.length())); }
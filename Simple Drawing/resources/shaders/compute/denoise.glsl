@@ -0,0 +1,134 @@
+// resources/shaders/compute/denoise.glsl
+// 边缘保持的à-trous小波滤波(一次迭代): 法线/深度/亮度三项权重, 最后一次迭代色调映射后写入输出图像
+#version 450 core
+layout(local_size_x = 16, local_size_y = 16) in;
+
+#include "common/frame.glsl"
+
+// 追踪pass写入的G-buffer(布局见common/scene.glsl)
+layout(rgba32f, binding = 2) uniform readonly image2D gbufferNormalDepth;
+
+// 本次迭代的输入/输出: rgb=线性颜色, a=亮度方差(第一次迭代的输入为追踪pass的noisyImage, a无意义)
+layout(rgba16f, binding = 5) uniform readonly image2D inputImage;
+layout(rgba16f, binding = 6) uniform writeonly image2D filteredImage;
+
+uniform int stepSize;          // 采样间隔2^i
+uniform bool finalPass;        // 最后一次迭代: 色调映射后写入outputImage
+uniform float sigmaNormal;     // 法线权重的指数
+uniform float sigmaDepth;      // 深度容差(以像素足迹为单位)
+uniform float sigmaLuminance;  // 亮度容差(以标准差为单位)
+
+#define TILE 16
+#define APRON 2
+#define TILE_EXT (TILE + 2 * APRON)
+
+/*
+    跨步分块: 间隔为s时, 一个工作组只处理同一余数类(x % s, y % s)的16x16个像素,
+    它们的5x5邻域在跨步网格上是连续的, 因此每次迭代都能用20x20的共享内存块完成,
+    不会因为间隔增大而退化成散乱的全局读取.
+*/
+shared vec4 s_color[TILE_EXT][TILE_EXT];          // rgb=颜色, a=方差
+shared vec4 s_normalDepth[TILE_EXT][TILE_EXT];    // w<0表示超出渲染区域
+
+const float kKernel[3] = float[](3.0 / 8.0, 1.0 / 4.0, 1.0 / 16.0);   // B3样条, 按|偏移|索引
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main() {
+    ivec2 size = ivec2(renderWidth, renderHeight);
+    ivec2 group = ivec2(gl_WorkGroupID.xy);
+    ivec2 residue = group % stepSize;
+    ivec2 block = group / stepSize;
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+
+    // 协作载入共享内存块(跨步网格坐标 -> 像素坐标)
+    for (uint i = gl_LocalInvocationIndex; i < TILE_EXT * TILE_EXT; i += TILE * TILE) {
+        ivec2 tile = ivec2(i % TILE_EXT, i / TILE_EXT);
+        ivec2 pixel = residue + (block * TILE - APRON + tile) * stepSize;
+        if (all(greaterThanEqual(pixel, ivec2(0))) && all(lessThan(pixel, size))) {
+            s_color[tile.y][tile.x] = imageLoad(inputImage, pixel);
+            s_normalDepth[tile.y][tile.x] = imageLoad(gbufferNormalDepth, pixel);
+        } else {
+            s_color[tile.y][tile.x] = vec4(0.0);
+            s_normalDepth[tile.y][tile.x] = vec4(0.0, 0.0, 0.0, -1.0);
+        }
+    }
+    barrier();
+
+    ivec2 storePos = residue + (block * TILE + local) * stepSize;
+    if (storePos.x >= renderWidth || storePos.y >= renderHeight) return;
+
+    ivec2 center = local + APRON;
+    vec4 centerColor = s_color[center.y][center.x];
+    vec4 centerNormalDepth = s_normalDepth[center.y][center.x];
+    vec3 normal = centerNormalDepth.xyz;
+    float depth = centerNormalDepth.w;
+
+    vec4 result = centerColor;
+    if (depth < MAX_DISTANCE) {
+        // 深度容差: 中心像素足迹(视平面半高为1)按表面倾斜放大
+        float footprint = depth * 2.0 / float(renderHeight) * float(stepSize);
+        float phiDepth = sigmaDepth * footprint / max(abs(dot(normal, cameraFront)), 0.2) + 1e-4;
+
+        // 邻域的几何权重(法线 x 深度), 两轮共用
+        float geometry[5][5];
+        for (int dy = -2; dy <= 2; dy++) {
+            for (int dx = -2; dx <= 2; dx++) {
+                vec4 sampleNormalDepth = s_normalDepth[center.y + dy][center.x + dx];
+                float weight = 0.0;
+                if (sampleNormalDepth.w >= 0.0 && sampleNormalDepth.w < MAX_DISTANCE) {
+                    float normalWeight = pow(max(dot(normal, sampleNormalDepth.xyz), 0.0), sigmaNormal);
+                    float depthWeight = exp(-abs(depth - sampleNormalDepth.w) / (phiDepth * length(vec2(dx, dy)) + 1e-4));
+                    weight = kKernel[abs(dx)] * kKernel[abs(dy)] * normalWeight * depthWeight;
+                }
+                geometry[dy + 2][dx + 2] = weight;
+            }
+        }
+
+        // 第一次迭代: 用几何权重下的亮度一阶/二阶矩估计方差
+        float variance = centerColor.a;
+        if (stepSize == 1) {
+            float sum = 0.0, moment1 = 0.0, moment2 = 0.0;
+            for (int dy = -2; dy <= 2; dy++) {
+                for (int dx = -2; dx <= 2; dx++) {
+                    float l = luminance(s_color[center.y + dy][center.x + dx].rgb);
+                    float w = geometry[dy + 2][dx + 2];
+                    sum += w;
+                    moment1 += w * l;
+                    moment2 += w * l * l;
+                }
+            }
+            moment1 /= sum;
+            variance = max(moment2 / sum - moment1 * moment1, 0.0);
+        }
+
+        float centerLuminance = luminance(centerColor.rgb);
+        float phiLuminance = sigmaLuminance * sqrt(variance) + 1e-4;
+
+        vec3 colorSum = vec3(0.0);
+        float weightSum = 0.0;
+        float varianceSum = 0.0;
+        for (int dy = -2; dy <= 2; dy++) {
+            for (int dx = -2; dx <= 2; dx++) {
+                vec4 sampleColor = s_color[center.y + dy][center.x + dx];
+                float sampleVariance = stepSize == 1 ? variance : sampleColor.a;
+                float luminanceWeight = exp(-abs(centerLuminance - luminance(sampleColor.rgb)) / phiLuminance);
+                float w = geometry[dy + 2][dx + 2] * luminanceWeight;
+                colorSum += w * sampleColor.rgb;
+                weightSum += w;
+                varianceSum += w * w * sampleVariance;
+            }
+        }
+
+        // 中心像素的权重恒为kKernel[0]^2 > 0
+        result = vec4(colorSum / weightSum, varianceSum / (weightSum * weightSum));
+    }
+
+    if (finalPass) {
+        imageStore(outputImage, storePos, vec4(toneMap(result.rgb), 1.0));
+    } else {
+        imageStore(filteredImage, storePos, result);
+    }
+}
@@ -1,164 +1,155 @@
 // resources/shaders/compute/ray_tracing.glsl
 #version 450 core
-layout(local_size_x = 16, local_size_y = 16) in;
-layout(rgba32f, binding = 0) uniform image2D outputImage;
-
-uniform vec3 cameraPos;
-uniform vec3 cameraFront;
-uniform vec3 cameraRight;
-uniform vec3 cameraUp;
-uniform float time;
-
-// 球体定义
-struct Sphere {
-    vec3 center;
-    float radius;
-    vec3 color;
-    float specular;
-    float reflectivity;
-};
 
-#define NUM_SPHERES 5
-const Sphere spheres[NUM_SPHERES] = Sphere[NUM_SPHERES](
-    Sphere(vec3(0.0, 0.0, -5.0), 1.0, vec3(1.0, 0.0, 0.0), 32.0, 0.3),   // 红色球
-    Sphere(vec3(-2.0, 1.0, -6.0), 1.0, vec3(0.0, 1.0, 0.0), 64.0, 0.5),  // 绿色球
-    Sphere(vec3(2.0, -1.0, -7.0), 1.0, vec3(0.0, 0.0, 1.0), 128.0, 0.7), // 蓝色球
-    Sphere(vec3(0.0, -101.0, -5.0), 100.0, vec3(0.8, 0.8, 0.8), 16.0, 0.2), // 地面
-    Sphere(vec3(0.0, 5.0, -10.0), 1.5, vec3(1.0, 1.0, 0.8), 256.0, 0.1)  // 光源
-);
-
-// 光线与球体求交
-float intersectSphere(Sphere s, vec3 rayOrigin, vec3 rayDir) {
-    vec3 oc = rayOrigin - s.center;
-    float a = dot(rayDir, rayDir);
-    float b = 2.0 * dot(oc, rayDir);
-    float c = dot(oc, oc) - s.radius * s.radius;
-    float discriminant = b * b - 4.0 * a * c;
-    
-    if (discriminant < 0.0) {
-        return -1.0;
+// 工作组形状由宿主注入(见WorkgroupTuner), 单独编译时使用16x16
+#ifndef LOCAL_SIZE_X
+#define LOCAL_SIZE_X 16
+#define LOCAL_SIZE_Y 16
+#endif
+layout(local_size_x = LOCAL_SIZE_X, local_size_y = LOCAL_SIZE_Y) in;
+
+#include "common/scene.glsl"
+
+#ifdef TILE_BINNING
+#include "common/tiles.glsl"
+
+shared int s_tilePrimitives[TILE_CAPACITY];
+
+// 工作组协作把本块的图元列表读入共享内存, 返回图元数; 溢出时返回-1(主光线改用BVH)
+int loadTile() {
+    uint tile = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    uint count = tileCounts[tile];
+    if (count > TILE_CAPACITY) return -1;
+
+    for (uint i = gl_LocalInvocationIndex; i < count; i += gl_WorkGroupSize.x * gl_WorkGroupSize.y) {
+        s_tilePrimitives[i] = tilePrimitives[tile * TILE_CAPACITY + i];
     }
-    
-    return (-b - sqrt(discriminant)) / (2.0 * a);
+    barrier();
+    return int(count);
 }
 
-// 场景求交
-bool intersectScene(vec3 rayOrigin, vec3 rayDir, out int hitIndex, out float minT) {
-    minT = 10000.0;
+// 主光线只与本块列表中的图元求交(列表顺序不定, 距离相同时取较小的索引)
+bool intersectTile(int count, vec3 rayOrigin, vec3 rayDir, out int hitIndex, out float minT) {
+    minT = MAX_DISTANCE;
     hitIndex = -1;
-    
-    for (int i = 0; i < NUM_SPHERES; i++) {
-        float t = intersectSphere(spheres[i], rayOrigin, rayDir);
-        if (t > 0.0001 && t < minT) {
+    for (int i = 0; i < count; i++) {
+        int primitive = s_tilePrimitives[i];
+        float t = intersectPrimitive(primitive, rayOrigin, rayDir);
+        if (t > 0.0001 && (t < minT || (t == minT && primitive < hitIndex))) {
             minT = t;
-            hitIndex = i;
+            hitIndex = primitive;
         }
     }
-    
     return hitIndex != -1;
 }
+#endif
 
-// 计算法向量
-vec3 calculateNormal(Sphere sphere, vec3 point) {
-    return normalize(point - sphere.center);
-}
-
-// 简单随机数生成
-float rand(vec2 co) {
-    return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
-}
+#ifdef MULTI_VIEW
+// 各视图的相机基与视口(std430, 布局与MultiViewRenderer::ViewData一致); 视图序号为gl_GlobalInvocationID.z
+struct ViewData {
+    vec4 pos;
+    vec4 front;
+    vec4 right;
+    vec4 up;
+    ivec4 viewport;   // xy=层内偏移, zw=分辨率
+};
+layout(std430, binding = 16) readonly buffer Views { ViewData views[]; };
+#endif
 
-// 光线追踪主函数
-vec3 traceRay(vec3 rayOrigin, vec3 rayDir) {
+// 光线追踪主函数(单个内核完成全部反弹; 波前模式见wavefront/目录)
+// tileCount不小于0时主光线只测试本块的图元列表, 反射与阴影光线仍遍历BVH
+vec3 traceRay(ivec2 storePos, vec3 rayOrigin, vec3 rayDir, int tileCount) {
     vec3 color = vec3(0.0);
     vec3 attenuation = vec3(1.0);
-    
-    for (int bounce = 0; bounce < 3; bounce++) {
+
+    for (int bounce = 0; bounce < MAX_BOUNCES; bounce++) {
         int hitIndex;
         float t;
-        
-        if (!intersectScene(rayOrigin, rayDir, hitIndex, t)) {
+
+        bool hit;
+#ifdef TILE_BINNING
+        if (bounce == 0 && tileCount >= 0) hit = intersectTile(tileCount, rayOrigin, rayDir, hitIndex, t);
+        else
+#endif
+        hit = intersectScene(rayOrigin, rayDir, hitIndex, t);
+
+        if (!hit) {
             // 天空颜色
-            float t = 0.5 * (rayDir.y + 1.0);
-            vec3 skyColor = (1.0 - t) * vec3(0.1, 0.1, 0.3) + t * vec3(0.5, 0.7, 1.0);
-            color += attenuation * skyColor;
+            color += attenuation * skyColor(rayDir);
+            if (gbufferEnabled() && bounce == 0) writeGBuffer(storePos, -1, t, rayDir, vec3(0.0), skyColor(rayDir));
             break;
         }
-        
-        Sphere hitSphere = spheres[hitIndex];
+
+        int materialId = materialIndex(hitIndex);
+        vec4 material = materialColorSpecular[materialId];
+        float emission = materialEmission[materialId];
         vec3 hitPoint = rayOrigin + t * rayDir;
-        vec3 normal = calculateNormal(hitSphere, hitPoint);
-        
-        // 光源位置
-        vec3 lightPos = spheres[4].center;
-        vec3 lightDir = normalize(lightPos - hitPoint);
-        
-        // 阴影检测
-        vec3 shadowOrigin = hitPoint + normal * 0.001;
-        int shadowIndex;
-        float shadowT;
-        bool inShadow = intersectScene(shadowOrigin, lightDir, shadowIndex, shadowT);
-        
-        // 基础光照
-        float diff = max(dot(normal, lightDir), 0.0);
-        
-        // 镜面反射
+        vec3 normal = surfaceNormal(hitIndex, rayOrigin, rayDir, hitPoint);
         vec3 viewDir = normalize(rayOrigin - hitPoint);
-        vec3 reflectDir = reflect(-lightDir, normal);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), hitSphere.specular);
-        
-        // 光照计算（排除光源本身）
+        vec3 shadowOrigin = hitPoint + normal * 0.001;
+        if (gbufferEnabled() && bounce == 0) writeGBuffer(storePos, materialId, t, rayDir, normal, material.rgb);
+
         vec3 lighting = vec3(0.0);
-        if (hitIndex != 4) {
-            if (!inShadow || shadowIndex == 4) {
-                lighting = diff * hitSphere.color + vec3(0.8) * spec;
-            } else {
-                lighting = diff * hitSphere.color * 0.3;
+        if (emission > 0.0) {
+            // 自发光（光源）
+            lighting = material.rgb * emission;
+        } else {
+            // 逐个光源累加
+            for (int l = 0; l < numLights; l++) {
+                int lightIndex = lightIndices[l];
+                vec3 lightDir, lit, shadowed;
+                directLight(lightIndex, hitPoint, normal, viewDir, material, lightDir, lit, shadowed);
+
+                // 阴影检测: 到光源表面之间有任意遮挡即可提前结束
+                bool inShadow = occluded(shadowOrigin, lightDir, lightDistance(lightIndex, shadowOrigin, lightDir), lightIndex);
+                lighting += inShadow ? shadowed : lit;
             }
         }
-        
-        // 自发光（光源）
-        if (hitIndex == 4) {
-            lighting = hitSphere.color * 5.0;
-        }
-        
+
         color += attenuation * lighting;
-        
+
         // 反射
-        if (hitSphere.reflectivity > 0.0) {
-            attenuation *= hitSphere.reflectivity;
+        float reflectivity = materialReflectivity[materialId];
+        if (reflectivity > 0.0) {
+            attenuation *= reflectivity;
             rayDir = reflect(rayDir, normal);
             rayOrigin = hitPoint + normal * 0.001;
         } else {
             break;
         }
     }
-    
+
     return color;
 }
 
 void main() {
+#ifdef MULTI_VIEW
+    // 多视图: 同一次分派渲染全部视图, 各视图按自己的分辨率生成主光线(与cameraRay相同的公式)
+    uint view = gl_GlobalInvocationID.z;
+    ivec4 viewport = views[view].viewport;
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (pixel.x >= viewport.z || pixel.y >= viewport.w) return;
+    viewTarget = ivec3(viewport.xy, int(view));
+
+    vec2 size = vec2(viewport.zw);
+    vec2 uv = (vec2(pixel) + 0.5) / size * 2.0 - 1.0;
+    vec3 dir = normalize(views[view].front.xyz + uv.x * views[view].right.xyz * (size.x / size.y) + uv.y * views[view].up.xyz);
+    writePixel(pixel, traceRay(pixel, views[view].pos.xyz, dir, -1));
+    return;
+#endif
+
+    // 分块列表须在越界的调用返回之前读入(barrier要求工作组内全部调用到达)
+#ifdef TILE_BINNING
+    int tileCount = loadTile();
+#else
+    int tileCount = -1;
+#endif
+
     ivec2 storePos = ivec2(gl_GlobalInvocationID.xy);
-    vec2 uv = (vec2(storePos) + 0.5) / vec2(imageSize(outputImage));
-    uv = uv * 2.0 - 1.0;
-    
-    // 相机设置
-    float aspectRatio = float(imageSize(outputImage).x) / float(imageSize(outputImage).y);
-    
-    // 使用传入的相机方向向量
-    vec3 rayDir = normalize(cameraFront + uv.x * cameraRight * aspectRatio + uv.y * cameraUp);
-    
+    if (storePos.x >= renderWidth || storePos.y >= renderHeight) return;
+
     // 执行光线追踪
-    vec3 color = traceRay(cameraPos, rayDir);
-    
-    // 添加一些噪声模拟胶片颗粒
-    float noise = 0.05 * rand(vec2(storePos) + time);
-    color += vec3(noise);
-    
-    // 色调映射
-    color = color / (color + vec3(1.0));
-    color = pow(color, vec3(1.0/2.2)); // Gamma校正
-    
-    // 输出颜色
-    imageStore(outputImage, storePos, vec4(color, 1.0));
+    vec3 color = traceRay(storePos, cameraPos, primaryRayDir(storePos), tileCount);
+
+    writePixel(storePos, color);
 }
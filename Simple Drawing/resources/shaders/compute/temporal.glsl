@@ -0,0 +1,146 @@
+// resources/shaders/compute/temporal.glsl
+// 时域重投影: 当前帧的首次命中点投影到上一帧, 校验后与上一帧历史混合(邻域裁剪防拖影)
+#version 450 core
+layout(local_size_x = 16, local_size_y = 16) in;
+
+#include "common/frame.glsl"
+
+// 本帧追踪pass的输出(布局见common/scene.glsl)
+layout(rgba32f, binding = 2) uniform readonly image2D gbufferNormalDepth;
+layout(rgba32f, binding = 3) uniform readonly image2D gbufferAlbedoId;
+layout(rgba16f, binding = 4) uniform readonly image2D noisyImage;
+
+// 本帧历史: rgb=混合后的线性颜色, a=有效样本数
+layout(rgba16f, binding = 7) uniform writeonly image2D historyOutput;
+
+// 上一帧的历史与G-buffer(纹理单元, 按texelFetch读取)
+layout(binding = 1) uniform sampler2D prevHistory;
+layout(binding = 2) uniform sampler2D prevNormalDepth;
+layout(binding = 3) uniform sampler2D prevAlbedoId;
+
+// 上一帧的相机与渲染区域(prevRenderSize为0表示没有可用历史)
+uniform vec3 prevCameraPos;
+uniform vec3 prevCameraFront;
+uniform vec3 prevCameraRight;
+uniform vec3 prevCameraUp;
+uniform ivec2 prevRenderSize;
+uniform float maxHistory;       // 样本数上限, 决定最小混合系数1/maxHistory
+
+#define DEPTH_TOLERANCE 0.05    // 相对深度容差
+#define NORMAL_TOLERANCE 0.9    // 法线夹角余弦下限
+#define CLIP_GAMMA 1.0          // 方差裁剪的宽度(标准差倍数)
+
+vec3 rgbToYCoCg(vec3 c) {
+    return vec3(0.25 * c.r + 0.5 * c.g + 0.25 * c.b, 0.5 * c.r - 0.5 * c.b, -0.25 * c.r + 0.5 * c.g - 0.25 * c.b);
+}
+
+vec3 yCoCgToRgb(vec3 c) {
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Catmull-Rom样条在x-1, x, x+1, x+2处的权重(和为1)
+vec4 catmullRomWeights(float f) {
+    return vec4(f * (-0.5 + f * (1.0 - 0.5 * f)),
+                1.0 + f * f * (-2.5 + 1.5 * f),
+                f * (0.5 + f * (2.0 - 1.5 * f)),
+                f * f * (-0.5 + 0.5 * f));
+}
+
+// 上一帧的某个像素是否与当前像素是同一表面(天空只比较物体ID)
+bool historyValid(ivec2 tap, float hitId, float prevDepth, vec3 normal) {
+    if (any(lessThan(tap, ivec2(0))) || any(greaterThanEqual(tap, prevRenderSize))) return false;
+    if (texelFetch(prevAlbedoId, tap, 0).a != hitId) return false;
+    if (hitId < 0.0) return true;
+
+    vec4 tapNormalDepth = texelFetch(prevNormalDepth, tap, 0);
+    return abs(tapNormalDepth.w - prevDepth) <= DEPTH_TOLERANCE * prevDepth
+        && dot(tapNormalDepth.xyz, normal) >= NORMAL_TOLERANCE;
+}
+
+void main() {
+    ivec2 storePos = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = ivec2(renderWidth, renderHeight);
+    if (storePos.x >= size.x || storePos.y >= size.y) return;
+
+    vec3 current = imageLoad(noisyImage, storePos).rgb;
+    vec4 normalDepth = imageLoad(gbufferNormalDepth, storePos);
+    float hitId = imageLoad(gbufferAlbedoId, storePos).a;
+
+    // 当前帧3x3邻域在YCoCg空间的包围盒: 均值 ± CLIP_GAMMA倍标准差(方差裁剪), 不超出邻域的最值
+    vec3 boxMin = vec3(1e30), boxMax = vec3(-1e30);
+    vec3 moment1 = vec3(0.0), moment2 = vec3(0.0);
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            ivec2 p = clamp(storePos + ivec2(dx, dy), ivec2(0), size - 1);
+            vec3 c = rgbToYCoCg(imageLoad(noisyImage, p).rgb);
+            boxMin = min(boxMin, c);
+            boxMax = max(boxMax, c);
+            moment1 += c;
+            moment2 += c * c;
+        }
+    }
+    vec3 mean = moment1 / 9.0;
+    vec3 sigma = sqrt(max(moment2 / 9.0 - mean * mean, 0.0));
+    boxMin = max(boxMin, mean - CLIP_GAMMA * sigma);
+    boxMax = min(boxMax, mean + CLIP_GAMMA * sigma);
+
+    vec3 color = current;
+    float samples = 1.0;
+    if (prevRenderSize.x > 0) {
+        // 由像素中心方向与线性深度重建世界坐标(天空按MAX_DISTANCE处的点处理), 再投影到上一帧
+        vec3 dir = cameraRay(vec2(storePos) + 0.5);
+        vec3 worldPos = cameraPos + dir * (normalDepth.w / dot(dir, cameraFront));
+        vec3 rel = worldPos - prevCameraPos;
+        float prevDepth = dot(rel, prevCameraFront);
+        float prevAspect = float(prevRenderSize.x) / float(prevRenderSize.y);
+        vec2 prevUv = vec2(dot(rel, prevCameraRight) / prevAspect, dot(rel, prevCameraUp)) / prevDepth;
+        vec2 prevPixel = (prevUv * 0.5 + 0.5) * vec2(prevRenderSize) - 0.5;
+
+        // 4x4邻域的样本逐个校验(同一物体、深度与法线接近); 全部通过时用Catmull-Rom重采样,
+        // 否则退回双线性并只用通过的样本重新归一化(反复双线性重采样会让历史越来越模糊)
+        vec4 history = vec4(0.0);
+        float weightSum = 0.0;
+        if (prevDepth > 0.0) {
+            ivec2 base = ivec2(floor(prevPixel));
+            vec2 f = prevPixel - vec2(base);
+
+            bool valid[16];
+            bool allValid = true;
+            for (int i = 0; i < 16; i++) {
+                valid[i] = historyValid(base + ivec2(i % 4 - 1, i / 4 - 1), hitId, prevDepth, normalDepth.xyz);
+                allValid = allValid && valid[i];
+            }
+
+            if (allValid) {
+                vec4 wx = catmullRomWeights(f.x), wy = catmullRomWeights(f.y);
+                for (int i = 0; i < 16; i++) {
+                    float w = wx[i % 4] * wy[i / 4];
+                    history += w * texelFetch(prevHistory, base + ivec2(i % 4 - 1, i / 4 - 1), 0);
+                    weightSum += w;
+                }
+                history.a = max(history.a, 1.0);
+            } else {
+                for (int i = 0; i < 4; i++) {
+                    ivec2 offset = ivec2(i & 1, i >> 1);
+                    if (!valid[(offset.y + 1) * 4 + offset.x + 1]) continue;
+                    float w = (offset.x != 0 ? f.x : 1.0 - f.x) * (offset.y != 0 ? f.y : 1.0 - f.y);
+                    history += w * texelFetch(prevHistory, base + offset, 0);
+                    weightSum += w;
+                }
+            }
+        }
+
+        // 通过校验的权重过小视为去遮挡, 从当前样本重新开始
+        if (weightSum > 1e-3) {
+            history /= weightSum;
+            vec3 clamped = yCoCgToRgb(clamp(rgbToYCoCg(history.rgb), boxMin, boxMax));
+            samples = min(history.a + 1.0, maxHistory);
+            color = mix(clamped, current, 1.0 / samples);
+        }
+    }
+
+    imageStore(historyOutput, storePos, vec4(color, samples));
+
+    // 未开启降噪时直接输出
+    if (!denoise) imageStore(outputImage, storePos, vec4(toneMap(color), 1.0));
+}
@@ -0,0 +1,77 @@
+// resources/shaders/compute/tile_binning.glsl
+// 图元分块: 每个图元投影到屏幕, 按覆盖的块原子追加到各块的列表(分块前由宿主清零计数)
+#version 450 core
+layout(local_size_x = 64) in;
+
+#include "common/scene.glsl"
+#include "common/tiles.glsl"
+
+uniform ivec2 tileSize;     // 块尺寸(等于单内核的工作组形状)
+uniform ivec2 tileCount;    // 每行/每列的块数(等于单内核的工作组数)
+
+#define NEAR_EPSILON 1e-4
+
+// 相机空间坐标: x沿cameraRight, y沿cameraUp, z沿cameraFront
+vec3 toCamera(vec3 p) {
+    vec3 rel = p - cameraPos;
+    return vec3(dot(rel, cameraRight), dot(rel, cameraUp), dot(rel, cameraFront));
+}
+
+// 球在一个轴上投影斜率(c/z)的精确范围: 过相机且与球相切的两条直线, 要求球完全在相机平面之前
+vec2 sphereSlopes(float c, float z, float r) {
+    float d = sqrt(max(c * c + z * z - r * r, 0.0));
+    return vec2(c * z - r * d, c * z + r * d) / (z * z - r * r);
+}
+
+void main() {
+    int primitive = int(gl_GlobalInvocationID.x);
+    if (primitive >= numSpheres + numTriangles) return;
+
+    // 投影斜率的包围盒: xy=最小(x/z, y/z), zw=最大; 与相机平面相交的图元覆盖全部块
+    vec4 bounds = vec4(-1e30, -1e30, 1e30, 1e30);
+    bool clipped = false;
+    if (primitive < numSpheres) {
+        vec4 sphere = sphereCenterRadius[primitive];
+        vec3 c = toCamera(sphere.xyz);
+        if (c.z + sphere.w <= 0.0) return;   // 完全在相机之后
+        clipped = c.z - sphere.w <= NEAR_EPSILON;
+        if (!clipped) {
+            vec2 sx = sphereSlopes(c.x, c.z, sphere.w);
+            vec2 sy = sphereSlopes(c.y, c.z, sphere.w);
+            bounds = vec4(sx.x, sy.x, sx.y, sy.y);
+        }
+    } else {
+        // 三角形直接投影三个顶点
+        int triangle = primitive - numSpheres;
+        vec3 v0 = triangleVertices[triangle * 3].xyz;
+        vec3 p0 = toCamera(v0);
+        vec3 p1 = toCamera(v0 + triangleVertices[triangle * 3 + 1].xyz);
+        vec3 p2 = toCamera(v0 + triangleVertices[triangle * 3 + 2].xyz);
+        if (max(p0.z, max(p1.z, p2.z)) <= 0.0) return;
+        clipped = min(p0.z, min(p1.z, p2.z)) <= NEAR_EPSILON;
+        if (!clipped) {
+            vec2 q0 = p0.xy / p0.z, q1 = p1.xy / p1.z, q2 = p2.xy / p2.z;
+            bounds = vec4(min(q0, min(q1, q2)), max(q0, max(q1, q2)));
+        }
+    }
+
+    // 斜率 -> 像素坐标(与cameraRay互逆): 像素x = (x / (z * aspect) * 0.5 + 0.5) * 宽 = x / z * 0.5 * 高 + 0.5 * 宽
+    vec2 size = vec2(renderWidth, renderHeight);
+    vec2 minPixel = clipped ? vec2(0.0) : bounds.xy * (0.5 * size.y) + 0.5 * size;
+    vec2 maxPixel = clipped ? size : bounds.zw * (0.5 * size.y) + 0.5 * size;
+
+    // 抖动后的采样点可位于像素内任意位置, 两侧再各留一个像素的数值误差余量
+    ivec2 lo = max(ivec2(floor(clamp(minPixel, vec2(-4.0), size + 4.0))) - 2, ivec2(0));
+    ivec2 hi = min(ivec2(floor(clamp(maxPixel, vec2(-4.0), size + 4.0))) + 1, ivec2(size) - 1);
+    if (any(greaterThan(lo, hi))) return;   // 完全在屏幕之外
+
+    ivec2 minTile = lo / tileSize;
+    ivec2 maxTile = min(hi / tileSize, tileCount - 1);
+    for (int ty = minTile.y; ty <= maxTile.y; ty++) {
+        for (int tx = minTile.x; tx <= maxTile.x; tx++) {
+            uint tile = uint(ty * tileCount.x + tx);
+            uint slot = atomicAdd(tileCounts[tile], 1u);
+            if (slot < TILE_CAPACITY) tilePrimitives[tile * TILE_CAPACITY + slot] = primitive;
+        }
+    }
+}
@@ -0,0 +1,12 @@
+// resources/shaders/compute/wavefront/dispatch.glsl
+// 波前: 把next队列与阴影队列的计数换算成glDispatchComputeIndirect的参数
+#version 450 core
+layout(local_size_x = 1) in;
+
+#include "../common/wavefront.glsl"
+
+void main() {
+    uint rays = min(nextCount, uint(nextRays.length()));
+    nextDispatch = uvec4((rays + WAVEFRONT_GROUP_SIZE - 1) / WAVEFRONT_GROUP_SIZE, 1, 1, 0);
+    shadowDispatch = uvec4((shadowLength() + WAVEFRONT_GROUP_SIZE - 1) / WAVEFRONT_GROUP_SIZE, 1, 1, 0);
+}
@@ -0,0 +1,19 @@
+// resources/shaders/compute/wavefront/extend.glsl
+// 波前: 当前队列的最近交点(closest-hit), 结果写回光线记录
+#version 450 core
+
+#include "../common/scene.glsl"
+#include "../common/wavefront.glsl"
+
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= currentLength()) return;
+
+    int hitIndex;
+    float t;
+    intersectScene(currentRays[index].origin.xyz, currentRays[index].direction.xyz, hitIndex, t);
+    currentRays[index].direction.w = t;
+    currentRays[index].throughput.w = intBitsToFloat(hitIndex);
+}
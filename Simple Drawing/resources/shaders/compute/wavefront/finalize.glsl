@@ -0,0 +1,14 @@
+// resources/shaders/compute/wavefront/finalize.glsl
+// 波前: 累积、色调映射并写入输出图像
+#version 450 core
+layout(local_size_x = 16, local_size_y = 16) in;
+
+#include "../common/scene.glsl"
+#include "../common/wavefront.glsl"
+
+void main() {
+    ivec2 storePos = ivec2(gl_GlobalInvocationID.xy);
+    if (storePos.x >= renderWidth || storePos.y >= renderHeight) return;
+
+    writePixel(storePos, radiance[storePos.y * renderWidth + storePos.x].rgb);
+}
@@ -0,0 +1,21 @@
+// resources/shaders/compute/wavefront/generate.glsl
+// 波前: 生成主光线(按像素顺序稠密写入next队列)并清零累计颜色
+#version 450 core
+layout(local_size_x = 16, local_size_y = 16) in;
+
+#include "../common/scene.glsl"
+#include "../common/wavefront.glsl"
+
+void main() {
+    ivec2 storePos = ivec2(gl_GlobalInvocationID.xy);
+    if (storePos.x >= renderWidth || storePos.y >= renderHeight) return;
+
+    int pixel = storePos.y * renderWidth + storePos.x;
+    if (pixel == 0) nextCount = uint(renderWidth * renderHeight);
+
+    radiance[pixel] = vec4(0.0);
+    nextRays[pixel].origin = vec4(cameraPos, intBitsToFloat(pixel));
+    nextRays[pixel].direction = vec4(primaryRayDir(storePos), 0.0);
+    nextRays[pixel].throughput = vec4(vec3(1.0), intBitsToFloat(-1));
+    nextRays[pixel].shading = vec4(0.0);
+}
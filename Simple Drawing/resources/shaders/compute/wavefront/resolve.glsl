@@ -0,0 +1,29 @@
+// resources/shaders/compute/wavefront/resolve.glsl
+// 波前: 按阴影结果汇总本段光照, 乘以路径通量后累加到像素
+#version 450 core
+
+#include "../common/scene.glsl"
+#include "../common/wavefront.glsl"
+
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= currentLength()) return;
+
+    PathRay ray = currentRays[index];
+    vec3 lighting = ray.shading.rgb;
+
+    // 与单内核相同的光源顺序累加
+    int first = floatBitsToInt(ray.shading.w);
+    if (first >= 0) {
+        for (int l = 0; l < numLights; l++) {
+            ShadowRay shadow = shadowRays[first + l];
+            lighting += shadow.lit.w > 0.5 ? shadow.lit.rgb : shadow.shadowed.rgb;
+        }
+    }
+
+    // 每个像素在同一次反弹中最多有一条路径, 无需原子操作
+    int pixel = floatBitsToInt(ray.origin.w);
+    radiance[pixel].rgb += ray.throughput.rgb * lighting;
+}
@@ -0,0 +1,116 @@
+// resources/shaders/compute/wavefront/shade.glsl
+// 波前: 着色命中点, 生成阴影光线与反射光线(追加到压缩队列)
+#version 450 core
+
+#include "../common/scene.glsl"
+#include "../common/wavefront.glsl"
+
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+uniform int bounce;   // 当前反弹次数(0为主光线)
+
+// 工作组内先汇总追加数量, 每组只对全局计数做一次原子操作
+shared uint s_rayCount;
+shared uint s_rayBase;
+shared uint s_shadowCount;
+shared uint s_shadowBase;
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    bool valid = index < currentLength();
+
+    if (gl_LocalInvocationIndex == 0) {
+        s_rayCount = 0;
+        s_shadowCount = 0;
+    }
+    barrier();
+
+    PathRay ray;
+    int hitIndex = -1;
+    int materialId = -1;
+    float reflectivity = 0.0;
+    int lights = 0;
+    uint rayOffset = 0;
+    uint shadowOffset = 0;
+    if (valid) {
+        ray = currentRays[index];
+        hitIndex = floatBitsToInt(ray.throughput.w);
+        if (hitIndex >= 0) {
+            materialId = materialIndex(hitIndex);
+            reflectivity = materialReflectivity[materialId];
+            if (materialEmission[materialId] <= 0.0) lights = numLights;
+        }
+        if (reflectivity > 0.0 && bounce + 1 < MAX_BOUNCES) rayOffset = atomicAdd(s_rayCount, 1u);
+        if (lights > 0) shadowOffset = atomicAdd(s_shadowCount, uint(lights));
+    }
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0) {
+        s_rayBase = atomicAdd(nextCount, s_rayCount);
+        s_shadowBase = atomicAdd(shadowCount, s_shadowCount);
+    }
+    barrier();
+    if (!valid) return;
+
+    vec3 rayOrigin = ray.origin.xyz;
+    vec3 rayDir = ray.direction.xyz;
+    // 主光线的首次命中写入G-buffer
+    bool primary = gbufferEnabled() && bounce == 0;
+    int pixel = floatBitsToInt(ray.origin.w);
+    ivec2 storePos = ivec2(pixel % renderWidth, pixel / renderWidth);
+    if (hitIndex < 0) {
+        // 天空颜色
+        currentRays[index].shading = vec4(skyColor(rayDir), intBitsToFloat(-1));
+        if (primary) writeGBuffer(storePos, -1, ray.direction.w, rayDir, vec3(0.0), skyColor(rayDir));
+        return;
+    }
+
+    vec4 material = materialColorSpecular[materialId];
+    float emission = materialEmission[materialId];
+    vec3 hitPoint = rayOrigin + ray.direction.w * rayDir;
+    vec3 normal = surfaceNormal(hitIndex, rayOrigin, rayDir, hitPoint);
+    vec3 viewDir = normalize(rayOrigin - hitPoint);
+    vec3 shadowOrigin = hitPoint + normal * 0.001;
+    if (primary) writeGBuffer(storePos, materialId, ray.direction.w, rayDir, normal, material.rgb);
+
+    vec3 lighting = vec3(0.0);
+    int first = -1;
+    if (emission > 0.0) {
+        // 自发光（光源）
+        lighting = material.rgb * emission;
+    } else if (lights > 0) {
+        uint base = s_shadowBase + shadowOffset;
+        bool queued = base + uint(lights) <= uint(shadowRays.length());
+        if (queued) first = int(base);
+
+        for (int l = 0; l < lights; l++) {
+            int lightIndex = lightIndices[l];
+            vec3 lightDir, lit, shadowed;
+            directLight(lightIndex, hitPoint, normal, viewDir, material, lightDir, lit, shadowed);
+            float maxT = lightDistance(lightIndex, shadowOrigin, lightDir);
+
+            if (queued) {
+                ShadowRay shadow;
+                shadow.origin = vec4(shadowOrigin, maxT);
+                shadow.direction = vec4(lightDir, intBitsToFloat(lightIndex));
+                shadow.lit = vec4(lit, 1.0);
+                shadow.shadowed = vec4(shadowed, 0.0);
+                shadowRays[base + uint(l)] = shadow;
+            } else {
+                // 阴影队列已满: 当场查询(整条路径段都不入队, 累加顺序不变)
+                lighting += occluded(shadowOrigin, lightDir, maxT, lightIndex) ? shadowed : lit;
+            }
+        }
+    }
+    currentRays[index].shading = vec4(lighting, intBitsToFloat(first));
+
+    // 反射: 追加到下一次反弹的队列
+    if (reflectivity > 0.0 && bounce + 1 < MAX_BOUNCES) {
+        PathRay next;
+        next.origin = vec4(hitPoint + normal * 0.001, ray.origin.w);
+        next.direction = vec4(reflect(rayDir, normal), 0.0);
+        next.throughput = vec4(ray.throughput.rgb * reflectivity, intBitsToFloat(-1));
+        next.shading = vec4(0.0);
+        nextRays[s_rayBase + rayOffset] = next;
+    }
+}
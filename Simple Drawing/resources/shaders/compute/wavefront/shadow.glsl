@@ -0,0 +1,17 @@
+// resources/shaders/compute/wavefront/shadow.glsl
+// 波前: 阴影光线的遮挡查询(any-hit, 命中任意遮挡物即结束)
+#version 450 core
+
+#include "../common/scene.glsl"
+#include "../common/wavefront.glsl"
+
+layout(local_size_x = WAVEFRONT_GROUP_SIZE) in;
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= shadowLength()) return;
+
+    ShadowRay ray = shadowRays[index];
+    bool blocked = occluded(ray.origin.xyz, ray.direction.xyz, ray.origin.w, floatBitsToInt(ray.direction.w));
+    shadowRays[index].lit.w = blocked ? 0.0 : 1.0;
+}
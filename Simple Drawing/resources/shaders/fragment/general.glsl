@@ -4,7 +4,11 @@
 out vec4 FragColor;
 in vec2 TexCoords;
 uniform sampler2D screenTexture;
+uniform vec2 renderSize;    // 有效渲染区域(像素, 位于纹理左下角)
 
 void main() {
-    FragColor = texture(screenTexture, TexCoords);
-}
\ No newline at end of file
+    // 双线性放大: 采样点限制在有效区域内, 避免混入区域外的旧像素
+    vec2 texSize = vec2(textureSize(screenTexture, 0));
+    vec2 pixel = clamp(TexCoords * renderSize, vec2(0.5), renderSize - 0.5);
+    FragColor = texture(screenTexture, pixel / texSize);
+}
@@ -0,0 +1,505 @@
+// src/benchmark.cpp
+#include "pch.h"
+#include "render_data.h"
+#include "launch_options.h"
+#include "main_loop.h"
+#include "gpu_timer.h"
+#include "image_io.h"
+#include "cpu_tracer.h"
+#include "scene.h"
+#include "shader_cache.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "benchmark.h"
+#include "denoiser.h"
+#include "render_farm.h"
+#include "multi_view.h"
+#include "frame_pipeline.h"
+
+namespace SimpleDrawingDemo {
+
+/* ------- 帧时间统计 ------- */
+
+FrameStats FrameStats::From(std::vector<double> samples) {
+    FrameStats stats;
+    stats.count = samples.size();
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        size_t index = static_cast<size_t>(std::ceil(p * samples.size())) - 1;
+        return samples[std::min(index, samples.size() - 1)];
+    };
+
+    stats.min = samples.front();
+    stats.median = percentile(0.5);
+    stats.p99 = percentile(0.99);
+    double sum = 0.0;
+    for (double s : samples) sum += s;
+    stats.mean = sum / samples.size();
+    return stats;
+}
+
+nlohmann::json FrameStats::ToJson() const {
+    nlohmann::json j;
+    j["min"] = min;
+    j["median"] = median;
+    j["p99"] = p99;
+    j["mean"] = mean;
+    j["count"] = count;
+    return j;
+}
+
+/* ------- 基准测试 ------- */
+
+// 已加载网格的统计(是否命中缓存、解析与加载耗时)
+static nlohmann::json MeshReport(const Scene& scene) {
+    nlohmann::json meshes = nlohmann::json::array();
+    for (const MeshLoadStats& mesh : scene.meshes) meshes.push_back(mesh.ToJson());
+    return meshes;
+}
+
+// 固定相机路径, 保证每次测试的画面一致
+ViewCamera Benchmark::PathCamera(const string& path, float t, const vec3& worldUp) {
+    using namespace glm;
+
+    vec3 pos(0.0f, 0.0f, 3.0f);
+    vec3 front(0.0f, 0.0f, -1.0f);
+
+    if (path == "orbit") {
+        // 绕场景中心一周
+        const vec3 target(0.0f, 0.0f, -6.0f);
+        const float radius = 9.0f;
+        float angle = 2.0f * 3.14159265f * t;
+        pos = target + vec3(sin(angle) * radius, 1.5f, cos(angle) * radius);
+        front = normalize(target - pos);
+    } else if (path == "dolly") {
+        // 沿视线方向推进
+        pos = mix(vec3(0.0f, 0.0f, 3.0f), vec3(0.0f, 0.5f, -2.0f), t);
+    } else if (path != "static") {
+        static bool warned = false;
+        if (!warned) {
+            std::cerr << "[ERROR_BENCH] 未知相机路径: " << path << ", 使用static" << std::endl;
+            warned = true;
+        }
+    }
+
+    ViewCamera camera;
+    camera.pos = pos;
+    camera.front = front;
+    camera.right = normalize(cross(front, worldUp));
+    camera.up = normalize(cross(camera.right, front));
+    return camera;
+}
+
+void Benchmark::ApplyCameraPath(RenderData* data, const string& path, float t) {
+    ViewCamera camera = PathCamera(path, t, data->worldUp);
+
+    // 相机变化时重新开始累积
+    if (data->cameraPos != camera.pos || data->cameraFront != camera.front) data->ResetAccumulation();
+
+    data->cameraPos = camera.pos;
+    data->cameraFront = camera.front;
+    data->cameraRight = camera.right;
+    data->cameraUp = camera.up;
+}
+
+int Benchmark::Run(GLFWwindow* window, RenderData* data, const LaunchOptions& options) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // 离屏运行: 不交换缓冲
+    MainLoop::s_presentEnabled = false;
+
+    GpuTimer gpuTimer;
+    std::vector<double> cpuTimes, gpuTimes;
+    cpuTimes.reserve(options.frames);
+    gpuTimes.reserve(options.frames);
+    std::vector<double> latencyTimes, fenceWaitTimes;   // 流水线: 提交到GPU完成的延迟, 等待空闲输出图像的时间
+    Clock::time_point measureStart;
+
+    int totalFrames = options.warmup + options.frames;
+    for (int i = 0; i < totalFrames; i++) {
+        bool measured = i >= options.warmup;
+        float t = measured ? float(i - options.warmup) / float(options.frames) : 0.0f;
+
+        // 固定相机与时间, 保证结果可复现
+        ApplyCameraPath(data, options.cameraPath, t);
+        data->time = static_cast<float>(i) / 60.0f;
+        data->lightPos = Simulation::LightPosition(data->time);
+
+        if (i == options.warmup) {
+            // 计时从空的流水线开始, 丢弃预热帧的样本
+            data->pipeline->Drain();
+            data->pipeline->TakeSamples(latencyTimes, fenceWaitTimes);
+            latencyTimes.clear();
+            fenceWaitTimes.clear();
+            measureStart = Clock::now();
+        }
+        auto start = Clock::now();
+        if (measured) gpuTimer.Begin();
+        if (data->multiView) {
+            // 转台: 各视图均匀分布在orbit路径上, 整体随t转动(视图0即orbit路径本身)
+            std::vector<ViewCamera> views(options.views);
+            for (int k = 0; k < options.views; k++) {
+                views[k] = PathCamera("orbit", std::fmod(t + float(k) / float(options.views), 1.0f), data->worldUp);
+                views[k].width = data->renderWidth;
+                views[k].height = data->renderHeight;
+            }
+            data->UpdateScene();
+            PROFILE_GPU_SCOPE("MultiView");
+            data->multiView->Render(*data, views);
+        } else {
+            MainLoop::RenderLoop(window, data);
+        }
+        if (measured) gpuTimer.End();
+        auto end = Clock::now();
+
+        if (measured) {
+            cpuTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        // 收集已完成的GPU查询(不阻塞)
+        double gpuMs;
+        while (gpuTimer.Poll(gpuMs)) gpuTimes.push_back(gpuMs);
+    }
+
+    glFinish();
+    double measureSeconds = std::chrono::duration<double>(Clock::now() - measureStart).count();
+    gpuTimer.Drain(gpuTimes);
+    data->pipeline->Drain();
+    data->pipeline->TakeSamples(latencyTimes, fenceWaitTimes);
+
+    // 生成JSON报告
+    nlohmann::json report;
+    report["renderer"] = string(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    report["backend"] = options.backend;
+    report["denoise"] = data->denoise ? data->denoiseIterations : 0;
+    report["temporal"] = data->temporal;
+    report["bounces"] = data->maxBounces;
+    report["workgroup"] = data->workgroup.Name();
+    report["tile_binning"] = data->tileBinner != nullptr;
+    report["sampler"] = SamplerName(data->sampler);
+    report["views"] = data->multiView ? options.views : 0;
+    report["width"] = data->screenWidth;
+    report["height"] = data->screenHeight;
+    report["render_scale"] = data->renderScale;
+    report["render_width"] = data->renderWidth;
+    report["render_height"] = data->renderHeight;
+    report["frames"] = options.frames;
+    report["warmup"] = options.warmup;
+    report["camera_path"] = options.cameraPath;
+    report["spheres"] = data->scene->SphereCount();
+    report["triangles"] = data->scene->TriangleCount();
+    report["meshes"] = MeshReport(*data->scene);
+    report["bvh"] = data->scene->bvh.stats.ToJson();
+    report["animate"] = options.animate;
+    report["scene_updates"] = data->scene->updateStats.ToJson();
+    report["cpu_ms"] = FrameStats::From(cpuTimes).ToJson();
+    report["gpu_ms"] = FrameStats::From(gpuTimes).ToJson();
+    report["frames_in_flight"] = data->pipeline->FramesInFlight();
+    report["throughput_fps"] = options.frames / measureSeconds;
+    report["pipeline"] = {
+        { "latency_ms", FrameStats::From(latencyTimes).ToJson() },
+        { "fence_wait_ms", FrameStats::From(fenceWaitTimes).ToJson() }
+    };
+    report["shader_cache"] = ShaderCache::s_stats.ToJson();
+
+    // 多视图: 每个视图单独输出(文件名追加_view序号)
+    if (data->multiView && !options.dumpPath.empty()) {
+        std::filesystem::path path(options.dumpPath);
+        for (int k = 0; k < data->multiView->ViewCount(); k++) {
+            string viewPath = (path.parent_path() / (path.stem().string() + "_view" + std::to_string(k) + path.extension().string())).string();
+            const ViewCamera& view = data->multiView->View(k);
+            if (!ImageIO::Write(viewPath, view.width, view.height, data->multiView->ReadView(k))) return 1;
+        }
+        std::cout << "[BENCH] " << data->multiView->ViewCount() << " 个视图已写入: " << options.dumpPath << std::endl;
+        LaunchOptions reportOnly = options;
+        reportOnly.dumpPath.clear();
+        return WriteResults(report, reportOnly, 0, 0, {});
+    }
+
+    // 输出实际追踪区域(未放大)
+    std::vector<float> pixels;
+    if (!options.dumpPath.empty()) {
+        pixels = ImageIO::ReadTexture(data->outputTarget.texture, data->renderWidth, data->renderHeight);
+    }
+    return WriteResults(report, options, data->renderWidth, data->renderHeight, pixels);
+}
+
+int Benchmark::RunConvergence(GLFWwindow* window, RenderData* data, const LaunchOptions& options) {
+    // 参考图的样本数倍数(参考图自身的误差约为被测序列的1/4以下);
+    // 参考图使用另一个扰乱种子, 避免与被测的sobol序列共享前N个样本而低估其误差
+    constexpr int kReferenceFactor = 16;
+    constexpr uint32_t kReferenceScramble = 0x9e3779b9u;
+    const SamplerType samplers[] = { SamplerType::Hash, SamplerType::R2, SamplerType::Sobol, SamplerType::BlueNoise };
+
+    MainLoop::s_presentEnabled = false;
+    if (data->historyFormat != TargetFormat::RGBA32F) {
+        std::cerr << "[CONVERGENCE] 累积历史不是rgba32f, 高样本数时的量化误差会掩盖采样误差" << std::endl;
+    }
+    if (data->outputFormat != TargetFormat::RGBA32F) {
+        std::cerr << "[CONVERGENCE] 输出不是rgba32f, RMSE包含输出格式的量化误差" << std::endl;
+    }
+
+    // 静止相机(相机路径的起点)、固定时间与光源, 只有子像素抖动随样本变化
+    data->accumulate = true;
+    data->SetTemporal(false);
+    ApplyCameraPath(data, options.cameraPath, 0.0f);
+    data->time = 0.0f;
+    data->lightPos = Simulation::LightPosition(data->time);
+    const int width = data->renderWidth, height = data->renderHeight;
+
+    // 累积samples个样本, 在每个2的幂样本数(及最后一个)处回调当前的色调映射输出
+    auto accumulate = [&](SamplerType sampler, uint32_t scramble, int samples, const std::function<void(int, const std::vector<float>&)>& measure) {
+        data->SetSampler(sampler, scramble);
+        data->ResetAccumulation();
+        for (int sample = 1; sample <= samples; sample++) {
+            MainLoop::RenderLoop(window, data);
+            if ((sample & (sample - 1)) == 0 || sample == samples) {
+                measure(sample, ImageIO::ReadTexture(data->outputTarget.texture, width, height));
+            }
+        }
+    };
+
+    std::vector<float> reference;
+    int referenceSamples = options.convergence * kReferenceFactor;
+    auto start = std::chrono::high_resolution_clock::now();
+    accumulate(SamplerType::Sobol, kReferenceScramble, referenceSamples, [&](int sample, const std::vector<float>& pixels) {
+        if (sample == referenceSamples) reference = pixels;
+    });
+    std::cout << "[CONVERGENCE] 参考图: sobol " << referenceSamples << " 样本, "
+              << std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() << " s" << std::endl;
+
+    auto rmse = [&](const std::vector<float>& pixels) {
+        double sum = 0.0;
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            for (size_t c = 0; c < 3; c++) {
+                double d = static_cast<double>(pixels[i + c]) - reference[i + c];
+                sum += d * d;
+            }
+        }
+        return std::sqrt(sum / (static_cast<double>(width) * height * 3.0));
+    };
+
+    struct Curve {
+        std::vector<int> samples;
+        std::vector<double> rmse;
+    };
+    std::vector<Curve> curves;
+    for (SamplerType sampler : samplers) {
+        Curve curve;
+        accumulate(sampler, 0, options.convergence, [&](int sample, const std::vector<float>& pixels) {
+            curve.samples.push_back(sample);
+            curve.rmse.push_back(rmse(pixels));
+        });
+        curves.push_back(curve);
+    }
+
+    // 等质量样本数: 曲线首次降到hash在N个样本时的误差处(对数坐标线性插值)
+    const double target = curves[0].rmse.back();
+    auto equalQualitySamples = [&](const Curve& curve) {
+        for (size_t i = 0; i < curve.rmse.size(); i++) {
+            if (curve.rmse[i] > target) continue;
+            if (i == 0 || curve.rmse[i] == target) return static_cast<double>(curve.samples[i]);
+            double t = std::log(curve.rmse[i - 1] / target) / std::log(curve.rmse[i - 1] / curve.rmse[i]);
+            return std::exp(std::log(static_cast<double>(curve.samples[i - 1]))
+                + t * std::log(static_cast<double>(curve.samples[i]) / curve.samples[i - 1]));
+        }
+        return -1.0;
+    };
+
+    nlohmann::json results;
+    for (size_t k = 0; k < curves.size(); k++) {
+        const Curve& curve = curves[k];
+        double equal = equalQualitySamples(curve);
+        nlohmann::json entry;
+        entry["samples"] = curve.samples;
+        entry["rmse"] = curve.rmse;
+        entry["equal_quality_samples"] = equal > 0.0 ? nlohmann::json(equal) : nlohmann::json();
+        entry["samples_saved"] = equal > 0.0 ? nlohmann::json(1.0 - equal / options.convergence) : nlohmann::json();
+        results[SamplerName(samplers[k])] = entry;
+
+        std::ostringstream line;
+        line << "[CONVERGENCE] " << SamplerName(samplers[k]) << ":";
+        for (size_t i = 0; i < curve.samples.size(); i++) line << " " << curve.samples[i] << "spp=" << curve.rmse[i];
+        if (equal > 0.0) {
+            line << " | 达到hash " << options.convergence << "spp的误差需 " << equal << "spp (节省 "
+                 << 100.0 * (1.0 - equal / options.convergence) << "%)";
+        } else {
+            line << " | " << options.convergence << "spp内未达到hash的误差";
+        }
+        std::cout << line.str() << std::endl;
+    }
+
+    nlohmann::json report;
+    report["renderer"] = string(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    report["backend"] = options.backend;
+    report["bounces"] = data->maxBounces;
+    report["width"] = width;
+    report["height"] = height;
+    report["camera_path"] = options.cameraPath;
+    report["spheres"] = data->scene->SphereCount();
+    report["triangles"] = data->scene->TriangleCount();
+    report["history_format"] = FormatInfo(data->historyFormat).name;
+    report["reference_sampler"] = SamplerName(SamplerType::Sobol);
+    report["reference_samples"] = referenceSamples;
+    report["convergence"] = results;
+
+    // --dump输出参考图
+    return WriteResults(report, options, width, height, reference);
+}
+
+int Benchmark::RunResizeCheck(GLFWwindow* window, RenderData* data, const LaunchOptions& options) {
+    constexpr int kRoundTrips = 3;
+
+    MainLoop::s_presentEnabled = false;
+    const int width = data->screenWidth, height = data->screenHeight;
+    const int sizes[2][2] = { { width, height }, { width * 2, height * 2 } };   // 宽高各翻倍, 必然跨桶
+
+    auto resize = [&](int index) {
+        data->RequestResize(sizes[index][0], sizes[index][1]);
+        data->ResizeRenderTargets();
+        for (int i = 0; i <= data->pipeline->FramesInFlight(); i++) MainLoop::RenderLoop(window, data);
+        glFinish();
+    };
+
+    // 两个尺寸各访问一次后, 离开一个尺寸时池中的空闲目标即该尺寸使用的全部纹理;
+    // 之后每次往返, 离开时放回的必须是同一批纹理名称, 且不再新建纹理
+    // (同格式同尺寸的目标之间可以互换, 如时域模式每帧交换的G-buffer, 因此按集合比较)
+    resize(0);
+    resize(1);
+    std::vector<unsigned int> spares[2];
+    spares[0] = data->targetPool->SpareTextures();    // 在1时的空闲目标: 尺寸0的全部纹理
+    resize(0);
+    spares[1] = data->targetPool->SpareTextures();
+    size_t created = data->targetPool->CreatedCount(), reused = data->targetPool->ReusedCount();
+
+    bool passed = true;
+    for (int trip = 0; trip < kRoundTrips * 2; trip++) {
+        int index = trip % 2 == 0 ? 1 : 0;
+        resize(index);
+        if (data->targetPool->SpareTextures() != spares[1 - index]) {
+            std::cerr << "[RESIZE_CHECK] 回到 " << sizes[index][0] << "x" << sizes[index][1] << " 时使用的纹理名称改变" << std::endl;
+            passed = false;
+        }
+    }
+    size_t extra = data->targetPool->CreatedCount() - created;
+    if (extra != 0) {
+        std::cerr << "[RESIZE_CHECK] 往返中新建了 " << extra << " 个纹理" << std::endl;
+        passed = false;
+    }
+
+    std::cout << "[RESIZE_CHECK] " << sizes[0][0] << "x" << sizes[0][1] << " <-> " << sizes[1][0] << "x" << sizes[1][1]
+              << " 往返 " << kRoundTrips << " 次, 复用 " << data->targetPool->ReusedCount() - reused << " 个, 新建 " << extra
+              << " 个, 显存 " << data->targetPool->AllocatedBytes() / (1024.0 * 1024.0) << " MB: " << (passed ? "通过" : "失败") << std::endl;
+    return passed ? 0 : 1;
+}
+
+int Benchmark::RunCpu(RenderData* data, const LaunchOptions& options) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    CpuTracer tracer(data->scene);
+    tracer.SetMaxBounces(options.bounces);
+    tracer.SetSampler(data->sampler);
+    if (options.convergence > 0) std::cerr << "[CONVERGENCE] 收敛测试只支持GPU后端, 已忽略" << std::endl;
+    if (options.resizeCheck) std::cerr << "[RESIZE_CHECK] 尺寸桶复用检查只支持GPU后端, 已忽略" << std::endl;
+    CpuDenoiser denoiser;
+    std::unique_ptr<RenderFarm> farm;
+    if (options.farm > 0) {
+        if (options.accumulate || options.denoise > 0) {
+            std::cerr << "[FARM] 累积与降噪需要逐像素的历史与G-buffer, 渲染农场已关闭" << std::endl;
+        } else {
+            farm = std::make_unique<RenderFarm>(data->scene, options);
+            if (!farm->Start()) farm.reset();
+        }
+    }
+    int width = std::max(1, static_cast<int>(std::lround(options.width * options.renderScale)));
+    int height = std::max(1, static_cast<int>(std::lround(options.height * options.renderScale)));
+    std::vector<double> cpuTimes;
+    cpuTimes.reserve(options.frames);
+
+    int totalFrames = options.warmup + options.frames;
+    for (int i = 0; i < totalFrames; i++) {
+        bool measured = i >= options.warmup;
+        float t = measured ? float(i - options.warmup) / float(options.frames) : 0.0f;
+        ApplyCameraPath(data, options.cameraPath, t);
+        data->time = static_cast<float>(i) / 60.0f;
+        data->lightPos = Simulation::LightPosition(data->time);
+        data->UpdateScene();
+
+        CpuCamera camera = { data->cameraPos, data->cameraFront, data->cameraRight, data->cameraUp,
+            static_cast<float>(i) / 60.0f, data->frameIndex, options.accumulate, options.denoise > 0 };
+        if (options.accumulate) data->frameIndex++;
+
+        auto start = Clock::now();
+        if (farm) {
+            PROFILE_SCOPE("FarmRender");
+            farm->Render(camera, data->lightPos, width, height);
+        } else {
+            PROFILE_SCOPE("CpuTrace");
+            tracer.Render(camera, width, height);
+        }
+        if (camera.denoise) {
+            PROFILE_SCOPE("CpuDenoise");
+            denoiser.Run(tracer, camera, options.denoise);
+        }
+        auto end = Clock::now();
+
+        if (measured) {
+            cpuTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+
+    nlohmann::json report;
+    report["renderer"] = farm
+        ? "cpu farm (" + std::to_string(farm->Stats().workers) + " workers)"
+        : string("cpu (") + CpuTracer::SimdName() + ", " + std::to_string(tracer.ThreadCount()) + " threads)";
+    if (farm) report["farm"] = farm->Stats().ToJson();
+    report["denoise"] = options.denoise;
+    report["bounces"] = options.bounces;
+    report["sampler"] = SamplerName(data->sampler);
+    report["width"] = options.width;
+    report["height"] = options.height;
+    report["render_scale"] = options.renderScale;
+    report["render_width"] = width;
+    report["render_height"] = height;
+    report["frames"] = options.frames;
+    report["warmup"] = options.warmup;
+    report["camera_path"] = options.cameraPath;
+    report["spheres"] = data->scene->SphereCount();
+    report["triangles"] = data->scene->TriangleCount();
+    report["meshes"] = MeshReport(*data->scene);
+    report["bvh"] = data->scene->bvh.stats.ToJson();
+    report["animate"] = options.animate;
+    report["scene_updates"] = data->scene->updateStats.ToJson();
+    report["cpu_ms"] = FrameStats::From(cpuTimes).ToJson();
+
+    return WriteResults(report, options, width, height,
+        options.denoise > 0 ? denoiser.Pixels() : farm ? farm->Pixels() : tracer.Pixels());
+}
+
+// 输出JSON报告与最终图像(黄金图像比对)
+int Benchmark::WriteResults(nlohmann::json report, const LaunchOptions& options,
+    int width, int height, const std::vector<float>& pixels)
+{
+#if ENABLE_PROFILER
+    // 各pass耗时(CPU区间与GPU时间戳)
+    report["profile"] = Profiler::ToJson();
+    if (!options.tracePath.empty()) Profiler::DumpTrace(options.tracePath);
+#endif
+
+    if (options.reportPath.empty()) {
+        std::cout << report.dump(4) << std::endl;
+    } else {
+        std::ofstream file(options.reportPath);
+        file << report.dump(4) << std::endl;
+        std::cout << "[BENCH] 报告已写入: " << options.reportPath << std::endl;
+    }
+
+    if (!options.dumpPath.empty()) {
+        if (!ImageIO::Write(options.dumpPath, width, height, pixels)) return 1;
+        std::cout << "[BENCH] 图像已写入: " << options.dumpPath << std::endl;
+    }
+    return 0;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,395 @@
+// src/bvh.cpp
+#include "pch.h"
+#include "bvh.h"
+#include "thread_pool.h"
+
+namespace SimpleDrawingDemo {
+
+nlohmann::json BvhBuildStats::ToJson() const {
+    nlohmann::json j;
+    j["primitives"] = primitiveCount;
+    j["nodes"] = nodeCount;
+    j["leaves"] = leafCount;
+    j["max_depth"] = maxDepth;
+    j["max_leaf_size"] = maxLeafSize;
+    j["sah_cost"] = sahCost;
+    j["build_ms"] = buildMs;
+    return j;
+}
+
+namespace {
+
+struct Aabb {
+    vec3 min = vec3(std::numeric_limits<float>::max());
+    vec3 max = vec3(-std::numeric_limits<float>::max());
+
+    void Grow(const vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+    void Grow(const Aabb& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+    bool Valid() const { return min.x <= max.x; }
+    float Area() const {
+        if (!Valid()) return 0.0f;
+        vec3 e = max - min;
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+};
+
+Aabb NodeBounds(const BvhNode& n) {
+    return Aabb{ vec3(n.boundsMin[0], n.boundsMin[1], n.boundsMin[2]), vec3(n.boundsMax[0], n.boundsMax[1], n.boundsMax[2]) };
+}
+
+double NodeArea(const BvhNode& n) {
+    double ex = n.boundsMax[0] - n.boundsMin[0];
+    double ey = n.boundsMax[1] - n.boundsMin[1];
+    double ez = n.boundsMax[2] - n.boundsMin[2];
+    return 2.0 * (ex * ey + ey * ez + ez * ex);
+}
+
+// SAH中的节点权重: 叶子为图元数(求交), 内部节点为1(遍历)
+double WeightedArea(const BvhNode& n) {
+    return (n.count > 0 ? n.count : 1) * NodeArea(n);
+}
+
+// 每个refit任务处理的节点数
+constexpr int kRefitBatch = 256;
+
+// 构建期间的临时节点
+struct BuildNode {
+    Aabb bounds;
+    int start = 0, count = 0;
+    std::unique_ptr<BuildNode> left, right;
+};
+
+struct Builder {
+    const std::vector<vec3>& boundsMin;
+    const std::vector<vec3>& boundsMax;
+    std::vector<vec3> centroids;
+    std::vector<int>& indices;
+    int parallelDepth;
+
+    std::unique_ptr<BuildNode> Build(int start, int count, int depth) {
+        auto node = std::make_unique<BuildNode>();
+        node->start = start;
+        node->count = count;
+
+        Aabb centroidBounds;
+        for (int i = start; i < start + count; i++) {
+            int p = indices[i];
+            node->bounds.Grow(Aabb{ boundsMin[p], boundsMax[p] });
+            centroidBounds.Grow(centroids[p]);
+        }
+        if (count <= 2) return node;
+
+        // 深度受遍历栈限制: 剩余层数不足以让SAH划分收敛时改为按数量对半划分, 叶子深度不超过kMaxStackDepth - 1
+        if (depth >= kMaxDepth) return node;
+        if (depth + MedianLevels(count) >= kMaxDepth) return SplitMedian(std::move(node), centroidBounds, depth);
+
+        // 在三个轴上分箱, 寻找SAH代价最小的划分
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1, bestSplit = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            float lo = centroidBounds.min[axis], hi = centroidBounds.max[axis];
+            if (hi - lo < 1e-6f) continue;
+
+            Aabb bins[kBins];
+            int binCounts[kBins] = {};
+            float scale = kBins / (hi - lo);
+            for (int i = start; i < start + count; i++) {
+                int p = indices[i];
+                int b = std::min(kBins - 1, static_cast<int>((centroids[p][axis] - lo) * scale));
+                bins[b].Grow(Aabb{ boundsMin[p], boundsMax[p] });
+                binCounts[b]++;
+            }
+
+            // 从右向左累积, 再从左向右扫描
+            float rightArea[kBins];
+            int rightCount[kBins];
+            Aabb acc; int n = 0;
+            for (int b = kBins - 1; b > 0; b--) {
+                acc.Grow(bins[b]); n += binCounts[b];
+                rightArea[b] = acc.Area(); rightCount[b] = n;
+            }
+            acc = Aabb(); n = 0;
+            for (int b = 0; b < kBins - 1; b++) {
+                acc.Grow(bins[b]); n += binCounts[b];
+                if (n == 0 || rightCount[b + 1] == 0) continue;
+                float cost = acc.Area() * n + rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        // 与不划分(叶子)的代价比较: 叶子代价 = 面积 * 图元数, 划分代价另加一次遍历
+        float leafCost = node->bounds.Area() * count;
+        float splitCost = node->bounds.Area() + bestCost;
+        if (bestAxis < 0) {
+            // 质心完全重合, 无法按位置划分: 图元过多时按数量对半划分
+            if (count <= kMaxLeaf) return node;
+            return Split(std::move(node), start + count / 2, depth);
+        }
+        if (splitCost >= leafCost && count <= kMaxLeaf) return node;
+
+        float lo = centroidBounds.min[bestAxis];
+        float scale = kBins / (centroidBounds.max[bestAxis] - lo);
+        auto mid = std::partition(indices.begin() + start, indices.begin() + start + count, [&](int p) {
+            int b = std::min(kBins - 1, static_cast<int>((centroids[p][bestAxis] - lo) * scale));
+            return b <= bestSplit;
+        });
+        return Split(std::move(node), static_cast<int>(mid - indices.begin()), depth);
+    }
+
+    // 按数量对半划分直到叶子不超过kMaxLeaf个图元所需的层数
+    static int MedianLevels(int count) {
+        int levels = 0;
+        for (; count > kMaxLeaf; count = (count + 1) / 2) levels++;
+        return levels;
+    }
+
+    // 沿质心跨度最大的轴按中位数划分
+    std::unique_ptr<BuildNode> SplitMedian(std::unique_ptr<BuildNode> node, const Aabb& centroidBounds, int depth) {
+        vec3 extent = centroidBounds.max - centroidBounds.min;
+        int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        int start = node->start, mid = node->start + node->count / 2;
+        std::nth_element(indices.begin() + start, indices.begin() + mid, indices.begin() + start + node->count,
+            [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+        return Split(std::move(node), mid, depth);
+    }
+
+    std::unique_ptr<BuildNode> Split(std::unique_ptr<BuildNode> node, int mid, int depth) {
+        int start = node->start, count = node->count;
+        int leftCount = mid - start, rightCount = count - leftCount;
+
+        // 大子树交给其他线程, 当前线程继续构建另一半
+        if (depth < parallelDepth && count > Bvh::kParallelThreshold) {
+            auto future = std::async(std::launch::async, [&, start, leftCount, depth] {
+                return Build(start, leftCount, depth + 1);
+            });
+            node->right = Build(mid, rightCount, depth + 1);
+            node->left = future.get();
+        } else {
+            node->left = Build(start, leftCount, depth + 1);
+            node->right = Build(mid, rightCount, depth + 1);
+        }
+        return node;
+    }
+
+    static constexpr int kBins = Bvh::kBinCount;
+    static constexpr int kMaxLeaf = Bvh::kMaxLeafSize;
+    static constexpr int kMaxDepth = Bvh::kMaxStackDepth - 1;
+};
+
+// 深度优先展平
+int Flatten(const BuildNode* node, std::vector<BvhNode>& out, BvhBuildStats& stats, int depth) {
+    int index = static_cast<int>(out.size());
+    out.push_back({});
+    BvhNode flat = {};
+    for (int a = 0; a < 3; a++) {
+        flat.boundsMin[a] = node->bounds.min[a];
+        flat.boundsMax[a] = node->bounds.max[a];
+    }
+    stats.maxDepth = std::max(stats.maxDepth, depth);
+
+    if (!node->left) {
+        flat.offset = node->start;
+        flat.count = node->count;
+        stats.leafCount++;
+        stats.maxLeafSize = std::max(stats.maxLeafSize, node->count);
+    } else {
+        Flatten(node->left.get(), out, stats, depth + 1);
+        flat.offset = Flatten(node->right.get(), out, stats, depth + 1);
+        flat.count = 0;
+    }
+    out[index] = flat;
+    return index;
+}
+}   // namespace
+
+Bvh::~Bvh() {
+    Release();
+}
+
+void Bvh::Build(const std::vector<vec3>& boundsMin, const std::vector<vec3>& boundsMax) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    int count = static_cast<int>(boundsMin.size());
+    nodes.clear();
+    stats = BvhBuildStats();
+    stats.primitiveCount = count;
+    m_boundsMin = boundsMin;
+    m_boundsMax = boundsMax;
+    m_dirtyPrimitives.clear();
+
+    primIndices.resize(count);
+    for (int i = 0; i < count; i++) primIndices[i] = i;
+
+    if (count == 0) {
+        // 空场景: 保留一个包围盒无效(min > max)的根节点, 任何光线都不会命中
+        BvhNode empty = {};
+        for (int a = 0; a < 3; a++) {
+            empty.boundsMin[a] = 1e30f;
+            empty.boundsMax[a] = -1e30f;
+        }
+        nodes.push_back(empty);
+        stats.nodeCount = 1;
+        stats.leafCount = 1;
+        BuildTopology();
+        return;
+    }
+
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    Builder builder{ boundsMin, boundsMax, {}, primIndices, 0 };
+    builder.centroids.resize(count);
+    for (int i = 0; i < count; i++) builder.centroids[i] = (boundsMin[i] + boundsMax[i]) * 0.5f;
+    while ((1 << builder.parallelDepth) < threads) builder.parallelDepth++;
+    builder.parallelDepth += 1;
+
+    auto root = builder.Build(0, count, 0);
+    nodes.reserve(2 * count);
+    Flatten(root.get(), nodes, stats, 0);
+
+    stats.nodeCount = static_cast<int>(nodes.size());
+    stats.sahCost = ComputeSahCost();
+    BuildTopology();
+    stats.buildMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+double Bvh::ComputeSahCost() const {
+    if (stats.primitiveCount == 0 || nodes.empty()) return 0.0;
+
+    double rootArea = std::max(NodeArea(nodes[0]), 1e-12);
+    double cost = 0.0;
+    for (const auto& n : nodes) {
+        cost += WeightedArea(n) / rootArea;
+    }
+    return cost;
+}
+
+// 父节点、深度与图元所在叶子(深度优先排列中子节点总在父节点之后, 一次顺序扫描即可)
+void Bvh::BuildTopology() {
+    size_t count = nodes.size();
+    parents.assign(count, -1);
+    depths.assign(count, 0);
+    primitiveLeaf.assign(stats.primitiveCount, 0);
+    m_marks.assign(count, 0);
+    m_markGeneration = 0;
+    m_weightedArea = 0.0;
+
+    for (size_t i = 0; i < count; i++) {
+        const BvhNode& n = nodes[i];
+        m_weightedArea += WeightedArea(n);
+        if (n.count > 0) {
+            for (int k = n.offset; k < n.offset + n.count; k++) primitiveLeaf[primIndices[k]] = static_cast<int>(i);
+        } else if (stats.primitiveCount > 0) {
+            for (int child : { static_cast<int>(i) + 1, n.offset }) {
+                parents[child] = static_cast<int>(i);
+                depths[child] = depths[i] + 1;
+            }
+        }
+    }
+}
+
+double Bvh::SahCost() const {
+    if (stats.primitiveCount == 0 || nodes.empty()) return 0.0;
+    return m_weightedArea / std::max(NodeArea(nodes[0]), 1e-12);
+}
+
+void Bvh::UpdatePrimitive(int primitive, const vec3& boundsMin, const vec3& boundsMax) {
+    m_boundsMin[primitive] = boundsMin;
+    m_boundsMax[primitive] = boundsMax;
+    m_dirtyPrimitives.push_back(primitive);
+}
+
+// 叶子取其图元包围盒的并集, 内部节点取两个子节点的并集
+double Bvh::RefitNode(int index) {
+    BvhNode& node = nodes[index];
+    double before = WeightedArea(node);
+
+    Aabb bounds;
+    if (node.count > 0) {
+        for (int k = node.offset; k < node.offset + node.count; k++) {
+            int p = primIndices[k];
+            bounds.Grow(Aabb{ m_boundsMin[p], m_boundsMax[p] });
+        }
+    } else {
+        bounds.Grow(NodeBounds(nodes[index + 1]));
+        bounds.Grow(NodeBounds(nodes[node.offset]));
+    }
+    for (int a = 0; a < 3; a++) {
+        node.boundsMin[a] = bounds.min[a];
+        node.boundsMax[a] = bounds.max[a];
+    }
+    return WeightedArea(node) - before;
+}
+
+const std::vector<int>& Bvh::Refit(ThreadPool* pool) {
+    m_refitNodes.clear();
+    if (m_dirtyPrimitives.empty()) return m_refitNodes;
+
+    // 收集脏图元所在的叶子及其祖先, 遇到本次已收集的节点即停止(共同祖先只收集一次)
+    if (++m_markGeneration == 0) {
+        std::fill(m_marks.begin(), m_marks.end(), 0u);
+        m_markGeneration = 1;
+    }
+    for (int primitive : m_dirtyPrimitives) {
+        for (int n = primitiveLeaf[primitive]; n >= 0 && m_marks[n] != m_markGeneration; n = parents[n]) {
+            m_marks[n] = m_markGeneration;
+            m_refitNodes.push_back(n);
+        }
+    }
+    m_dirtyPrimitives.clear();
+
+    // 从最深的一层开始逐层refit: 同层节点只读取更深一层的结果, 可以并行
+    std::sort(m_refitNodes.begin(), m_refitNodes.end(), [this](int a, int b) {
+        return depths[a] != depths[b] ? depths[a] > depths[b] : a < b;
+    });
+    m_refitDeltas.resize(m_refitNodes.size());
+    auto refitRange = [this](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) m_refitDeltas[i] = RefitNode(m_refitNodes[i]);
+    };
+    for (size_t begin = 0; begin < m_refitNodes.size();) {
+        size_t end = begin;
+        int depth = depths[m_refitNodes[begin]];
+        while (end < m_refitNodes.size() && depths[m_refitNodes[end]] == depth) end++;
+
+        size_t count = end - begin;
+        if (pool && count >= static_cast<size_t>(kParallelRefit)) {
+            int batches = static_cast<int>((count + kRefitBatch - 1) / kRefitBatch);
+            pool->ParallelFor(batches, [&](int batch) {
+                size_t first = begin + static_cast<size_t>(batch) * kRefitBatch;
+                refitRange(first, std::min(first + kRefitBatch, end));
+            });
+        } else {
+            refitRange(begin, end);
+        }
+        begin = end;
+    }
+
+    for (double delta : m_refitDeltas) m_weightedArea += delta;
+    std::sort(m_refitNodes.begin(), m_refitNodes.end());
+    return m_refitNodes;
+}
+
+void Bvh::Upload() {
+    if (!nodeBuffer) glCreateBuffers(1, &nodeBuffer);
+    if (!primitiveBuffer) glCreateBuffers(1, &primitiveBuffer);
+
+    static const int emptyIndex = 0;
+    glNamedBufferData(nodeBuffer, nodes.size() * sizeof(BvhNode), nodes.data(), GL_STATIC_DRAW);
+    glNamedBufferData(primitiveBuffer, std::max<size_t>(primIndices.size(), 1) * sizeof(int),
+        primIndices.empty() ? &emptyIndex : primIndices.data(), GL_STATIC_DRAW);
+}
+
+void Bvh::Bind() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BVH_BINDING_NODES, nodeBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BVH_BINDING_PRIMITIVES, primitiveBuffer);
+}
+
+void Bvh::Release() {
+    if (nodeBuffer) glDeleteBuffers(1, &nodeBuffer);
+    if (primitiveBuffer) glDeleteBuffers(1, &primitiveBuffer);
+    nodeBuffer = primitiveBuffer = 0;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,125 @@
+// src/cpu_denoiser.cpp
+#include "pch.h"
+#include "denoiser.h"
+#include "cpu_tracer.h"
+#include "thread_pool.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+constexpr float kMaxDistance = 10000.0f;
+constexpr float kKernel[3] = { 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };   // B3样条, 按|偏移|索引
+
+float Luminance(const float* color) {
+    return 0.2126f * color[0] + 0.7152f * color[1] + 0.0722f * color[2];
+}
+}
+
+CpuDenoiser::CpuDenoiser(ThreadPool* pool)
+    : m_pool(pool ? pool : &ThreadPool::Shared())
+{}
+
+void CpuDenoiser::Run(const CpuTracer& tracer, const CpuCamera& camera, int iterations) {
+    size_t size = static_cast<size_t>(tracer.Width()) * tracer.Height() * 4;
+    for (std::vector<float>& buffer : m_buffers) buffer.resize(size);
+    m_pixels.resize(size);
+
+    const float* input = tracer.Pixels().data();
+    for (int i = 0; i < iterations; i++) {
+        int step = 1 << i;
+        bool finalPass = i == iterations - 1;
+        float* output = finalPass ? m_pixels.data() : m_buffers[i & 1].data();
+        m_pool->ParallelFor(tracer.Height(), [&](int y) {
+            FilterRow(tracer, camera.front, input, output, y, step, finalPass);
+        });
+        input = output;
+    }
+}
+
+// 单行像素的一次迭代(逐项对应denoise.glsl的main)
+void CpuDenoiser::FilterRow(const CpuTracer& tracer, const vec3& cameraFront, const float* input, float* output,
+                            int y, int step, bool finalPass) {
+    const int width = tracer.Width(), height = tracer.Height();
+    const float* normalDepth = tracer.NormalDepth().data();
+
+    for (int x = 0; x < width; x++) {
+        size_t pixel = static_cast<size_t>(y) * width + x;
+        const float* centerColor = &input[pixel * 4];
+        const float* centerNormalDepth = &normalDepth[pixel * 4];
+        vec3 normal(centerNormalDepth[0], centerNormalDepth[1], centerNormalDepth[2]);
+        float depth = centerNormalDepth[3];
+
+        vec4 result(centerColor[0], centerColor[1], centerColor[2], centerColor[3]);
+        if (depth < kMaxDistance) {
+            float footprint = depth * 2.0f / static_cast<float>(height) * static_cast<float>(step);
+            float phiDepth = params.sigmaDepth * footprint / std::max(std::abs(glm::dot(normal, cameraFront)), 0.2f) + 1e-4f;
+
+            // 邻域的几何权重(法线 x 深度), 超出图像或天空为0
+            float geometry[5][5];
+            const float* samples[5][5] = {};
+            for (int dy = -2; dy <= 2; dy++) {
+                for (int dx = -2; dx <= 2; dx++) {
+                    int sx = x + dx * step, sy = y + dy * step;
+                    float weight = 0.0f;
+                    if (sx >= 0 && sx < width && sy >= 0 && sy < height) {
+                        size_t sample = static_cast<size_t>(sy) * width + sx;
+                        const float* sampleNormalDepth = &normalDepth[sample * 4];
+                        samples[dy + 2][dx + 2] = &input[sample * 4];
+                        if (sampleNormalDepth[3] < kMaxDistance) {
+                            vec3 sampleNormal(sampleNormalDepth[0], sampleNormalDepth[1], sampleNormalDepth[2]);
+                            float normalWeight = std::pow(std::max(glm::dot(normal, sampleNormal), 0.0f), params.sigmaNormal);
+                            float depthWeight = std::exp(-std::abs(depth - sampleNormalDepth[3])
+                                / (phiDepth * std::sqrt(static_cast<float>(dx * dx + dy * dy)) + 1e-4f));
+                            weight = kKernel[std::abs(dx)] * kKernel[std::abs(dy)] * normalWeight * depthWeight;
+                        }
+                    }
+                    geometry[dy + 2][dx + 2] = weight;
+                }
+            }
+
+            // 第一次迭代: 用几何权重下的亮度一阶/二阶矩估计方差
+            float variance = centerColor[3];
+            if (step == 1) {
+                float sum = 0.0f, moment1 = 0.0f, moment2 = 0.0f;
+                for (int j = 0; j < 25; j++) {
+                    float w = geometry[j / 5][j % 5];
+                    if (w == 0.0f) continue;
+                    float l = Luminance(samples[j / 5][j % 5]);
+                    sum += w;
+                    moment1 += w * l;
+                    moment2 += w * l * l;
+                }
+                moment1 /= sum;
+                variance = std::max(moment2 / sum - moment1 * moment1, 0.0f);
+            }
+
+            float centerLuminance = Luminance(centerColor);
+            float phiLuminance = params.sigmaLuminance * std::sqrt(variance) + 1e-4f;
+
+            vec3 colorSum(0.0f);
+            float weightSum = 0.0f, varianceSum = 0.0f;
+            for (int j = 0; j < 25; j++) {
+                float w = geometry[j / 5][j % 5];
+                if (w == 0.0f) continue;
+                const float* sampleColor = samples[j / 5][j % 5];
+                float sampleVariance = step == 1 ? variance : sampleColor[3];
+                w *= std::exp(-std::abs(centerLuminance - Luminance(sampleColor)) / phiLuminance);
+                colorSum += w * vec3(sampleColor[0], sampleColor[1], sampleColor[2]);
+                weightSum += w;
+                varianceSum += w * w * sampleVariance;
+            }
+
+            // 中心像素的权重恒为kKernel[0]^2 > 0
+            result = vec4(colorSum / weightSum, varianceSum / (weightSum * weightSum));
+        }
+
+        float* out = &output[pixel * 4];
+        if (finalPass) {
+            vec3 c = ToneMap(vec3(result.x, result.y, result.z));
+            out[0] = c.x; out[1] = c.y; out[2] = c.z; out[3] = 1.0f;
+        } else {
+            out[0] = result.x; out[1] = result.y; out[2] = result.z; out[3] = result.w;
+        }
+    }
+}
+}   // namespace SimpleDrawingDemo
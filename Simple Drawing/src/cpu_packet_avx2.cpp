@@ -0,0 +1,16 @@
+// src/cpu_packet_avx2.cpp
+#include "pch.h"
+#include "cpu_tracer.h"
+#include "scene.h"
+#include "bvh.h"
+
+#if SD_SIMD_DISPATCH_AVX2
+// 之后定义的函数按AVX2+FMA生成代码, simd.h选择__m256实现.
+// 其他头文件必须在此之前包含: 否则其中的内联函数也会按AVX2生成, 并可能被链接器选作全程序共用的版本
+#pragma GCC target("avx2,fma")
+#define SD_SIMD_TARGET_AVX2 1
+#include "simd.h"
+
+#define SD_PACKET_KERNEL TracePacketAvx2
+#include "cpu_packet_kernel.inl"
+#endif
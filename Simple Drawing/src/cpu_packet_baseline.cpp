@@ -0,0 +1,10 @@
+// src/cpu_packet_baseline.cpp
+#include "pch.h"
+#include "cpu_tracer.h"
+#include "scene.h"
+#include "bvh.h"
+#include "simd.h"
+
+// 基线指令集(x86-64为SSE2, 其他平台为标量)的光线包内核
+#define SD_PACKET_KERNEL TracePacketBaseline
+#include "cpu_packet_kernel.inl"
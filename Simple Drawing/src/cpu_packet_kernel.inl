@@ -0,0 +1,319 @@
+// src/cpu_packet_kernel.inl
+// 光线包内核的实现, 由各指令集的编译单元在包含simd.h并定义SD_PACKET_KERNEL(成员函数名)之后包含;
+// 辅助函数均为static, 每个编译单元各自按本单元的指令集生成
+
+namespace SimpleDrawingDemo {
+
+// 八面体编码的单位法线(与scene.glsl的unpackNormal一致)
+static vec3 UnpackNormal(uint32_t packed) {
+    auto snorm = [](uint32_t bits) {
+        return std::clamp(static_cast<float>(static_cast<int16_t>(static_cast<uint16_t>(bits))) / 32767.0f, -1.0f, 1.0f);
+    };
+    vec3 n(snorm(packed & 0xffffu), snorm(packed >> 16), 0.0f);
+    n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+    if (n.z < 0.0f) {
+        float x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        float y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+        n.x = x;
+        n.y = y;
+    }
+    return glm::normalize(n);
+}
+
+// 三角形命中点的插值法线, 翻到入射光线一侧(逐项对应scene.glsl的surfaceNormal)
+static vec3 TriangleNormal(const Scene& scene, int triangle, const vec3& rayDir, const vec3& hitPoint) {
+    const vec4* tri = &scene.triangleVertices[size_t(triangle) * 3];
+    vec3 e1(tri[1].x, tri[1].y, tri[1].z), e2(tri[2].x, tri[2].y, tri[2].z);
+    vec3 s = hitPoint - vec3(tri[0].x, tri[0].y, tri[0].z);
+
+    float d11 = glm::dot(e1, e1), d12 = glm::dot(e1, e2), d22 = glm::dot(e2, e2);
+    float s1 = glm::dot(s, e1), s2 = glm::dot(s, e2);
+    float invDenom = 1.0f / std::max(d11 * d22 - d12 * d12, 1e-30f);
+    float u = std::clamp((d22 * s1 - d12 * s2) * invDenom, 0.0f, 1.0f);
+    float v = std::clamp((d11 * s2 - d12 * s1) * invDenom, 0.0f, 1.0f - u);
+
+    const glm::uvec4& shading = scene.triangleShading[triangle];
+    vec3 normal = glm::normalize(UnpackNormal(shading.x) * (1.0f - u - v) + UnpackNormal(shading.y) * u + UnpackNormal(shading.z) * v);
+    vec3 geometric = glm::cross(e1, e2);
+    if (glm::dot(normal, geometric) < 0.0f) normal = -normal;
+    return glm::dot(geometric, rayDir) < 0.0f ? normal : -normal;
+}
+
+// 与GLSL rand(vec2 co)一致的哈希
+static float Rand(float x, float y) {
+    float v = std::sin(x * 12.9898f + y * 78.233f) * 43758.5453f;
+    return v - std::floor(v);
+}
+
+void CpuTracer::SD_PACKET_KERNEL(const CpuCamera& camera, int x0, int y0) {
+    const Scene& scene = *m_scene;
+    const int numSpheres = scene.SphereCount();
+    const int numPrimitives = scene.PrimitiveCount();
+    const Float8 zero(0.0f), one(1.0f);
+
+    // 生成主光线
+    alignas(32) float px[8], py[8], valid[8], jx[8], jy[8];
+    for (int i = 0; i < 8; i++) {
+        int x = x0 + i % kPacketWidth, y = y0 + i / kPacketWidth;
+        px[i] = static_cast<float>(x);
+        py[i] = static_cast<float>(y);
+        valid[i] = (x < m_width && y < m_height) ? 1.0f : 0.0f;
+
+        // 累积模式下的子像素抖动(与着色器一致)
+        jx[i] = jy[i] = 0.0f;
+        if (camera.accumulate) {
+            vec2 jitter = Sampler::Sample2D(m_sampler, x, y, static_cast<uint32_t>(camera.frameIndex), Sampler::kDimensionJitter);
+            jx[i] = jitter.x - 0.5f;
+            jy[i] = jitter.y - 0.5f;
+        }
+    }
+    Float8 fx = Float8::Load(px) + Float8::Load(jx), fy = Float8::Load(py) + Float8::Load(jy);
+    Float8 active = Float8::Load(valid) > zero;
+
+    float aspectRatio = static_cast<float>(m_width) / static_cast<float>(m_height);
+    Float8 u = (fx + Float8(0.5f)) / Float8(static_cast<float>(m_width)) * Float8(2.0f) - one;
+    Float8 v = (fy + Float8(0.5f)) / Float8(static_cast<float>(m_height)) * Float8(2.0f) - one;
+
+    Vec3x8 rayOrigin(camera.pos);
+    Vec3x8 rayDir = Normalize(Vec3x8(camera.front)
+        + Vec3x8(camera.right * aspectRatio) * u
+        + Vec3x8(camera.up) * v);
+
+    // 场景求交(光线包遍历BVH): 返回最近命中距离和图元索引(未命中为-1)
+    const std::vector<BvhNode>& nodes = scene.bvh.nodes;
+    const std::vector<int>& primIndices = scene.bvh.primIndices;
+    auto intersectScene = [&](const Vec3x8& o, const Vec3x8& d, Float8 mask, Float8& minT, Float8& hitIndex) {
+        minT = Float8(10000.0f);
+        hitIndex = Float8(-1.0f);
+        if (numPrimitives == 0) return;
+
+        Float8 a = Dot(d, d);
+        auto safeInv = [&](Float8 x) {
+            Float8 tiny = (x < Float8(1e-8f)) & (x > Float8(-1e-8f));
+            return one / Select(tiny, Float8(1e-8f), x);
+        };
+        Vec3x8 invDir(safeInv(d.x), safeInv(d.y), safeInv(d.z));
+
+        // 包围盒测试: 返回命中掩码与最近的进入距离
+        auto testNode = [&](int index, float& nearest) {
+            const BvhNode& n = nodes[index];
+            Float8 t0x = (Float8(n.boundsMin[0]) - o.x) * invDir.x, t1x = (Float8(n.boundsMax[0]) - o.x) * invDir.x;
+            Float8 t0y = (Float8(n.boundsMin[1]) - o.y) * invDir.y, t1y = (Float8(n.boundsMax[1]) - o.y) * invDir.y;
+            Float8 t0z = (Float8(n.boundsMin[2]) - o.z) * invDir.z, t1z = (Float8(n.boundsMax[2]) - o.z) * invDir.z;
+            Float8 enter = Max(Max(Min(t0x, t1x), Min(t0y, t1y)), Max(Min(t0z, t1z), zero));
+            Float8 exit = Min(Min(Max(t0x, t1x), Max(t0y, t1y)), Min(Max(t0z, t1z), minT));
+            Float8 hit = mask & (enter <= exit);
+
+            alignas(32) float e[8];
+            Select(hit, enter, Float8(1e30f)).Store(e);
+            nearest = *std::min_element(e, e + 8);
+            return Any(hit);
+        };
+
+        int stack[Bvh::kMaxStackDepth];
+        int sp = 0;
+        int node = 0;
+        float rootT;
+        if (!testNode(0, rootT)) return;
+
+        while (true) {
+            const BvhNode& n = nodes[node];
+            if (n.count > 0) {
+                // 叶子: 逐个图元求交
+                for (int i = n.offset; i < n.offset + n.count; i++) {
+                    int primitive = primIndices[i];
+                    Float8 t, hit;
+                    if (primitive < numSpheres) {
+                        const vec4& s = scene.centerRadius[primitive];
+                        Vec3x8 oc = o - Vec3x8(vec3(s.x, s.y, s.z));
+                        Float8 b = Float8(2.0f) * Dot(oc, d);
+                        Float8 c = Dot(oc, oc) - Float8(s.w * s.w);
+                        Float8 disc = b * b - Float8(4.0f) * a * c;
+                        t = (-b - Sqrt(Max(disc, zero))) / (Float8(2.0f) * a);
+                        hit = disc >= zero;
+                    } else {
+                        // Möller–Trumbore(与scene.glsl的intersectTriangle一致)
+                        const vec4* tri = &scene.triangleVertices[size_t(primitive - numSpheres) * 3];
+                        Vec3x8 e1(vec3(tri[1].x, tri[1].y, tri[1].z)), e2(vec3(tri[2].x, tri[2].y, tri[2].z));
+                        Vec3x8 p = Cross(d, e2);
+                        Float8 det = Dot(e1, p);
+                        Float8 invDet = one / det;
+                        Vec3x8 s = o - Vec3x8(vec3(tri[0].x, tri[0].y, tri[0].z));
+                        Float8 u = Dot(s, p) * invDet;
+                        Vec3x8 q = Cross(s, e1);
+                        Float8 v = Dot(d, q) * invDet;
+                        t = Dot(e2, q) * invDet;
+                        hit = ((det > Float8(1e-12f)) | (det < Float8(-1e-12f)))
+                            & (u >= zero) & (u <= one) & (v >= zero) & (u + v <= one);
+                    }
+                    hit = hit & mask & (t > Float8(0.0001f)) & (t < minT);
+                    minT = Select(hit, t, minT);
+                    hitIndex = Select(hit, Float8(static_cast<float>(primitive)), hitIndex);
+                }
+            } else {
+                // 内部节点: 就近子节点优先
+                int nearNode = node + 1, farNode = n.offset;
+                float nearT, farT;
+                bool nearHit = testNode(nearNode, nearT);
+                bool farHit = testNode(farNode, farT);
+                if (farHit && (!nearHit || farT < nearT)) {
+                    std::swap(nearNode, farNode);
+                    std::swap(nearHit, farHit);
+                }
+                if (nearHit) {
+                    if (farHit && sp < Bvh::kMaxStackDepth) stack[sp++] = farNode;
+                    node = nearNode;
+                    continue;
+                }
+            }
+
+            if (sp == 0) break;
+            node = stack[--sp];
+        }
+    };
+
+    Vec3x8 color(zero, zero, zero);
+    Vec3x8 attenuation(one, one, one);
+
+    // 首次命中(G-buffer)
+    Vec3x8 firstNormal(zero, zero, zero), firstAlbedo(zero, zero, zero);
+    Float8 firstDepth(10000.0f), firstIndex(-1.0f);
+
+    for (int bounce = 0; bounce < m_maxBounces && Any(active); bounce++) {
+        Float8 t, hitIndex;
+        intersectScene(rayOrigin, rayDir, active, t, hitIndex);
+
+        // 未命中: 天空颜色
+        Float8 miss = active & (hitIndex < zero);
+        if (Any(miss)) {
+            Float8 skyT = Float8(0.5f) * (rayDir.y + one);
+            Vec3x8 sky = Vec3x8(vec3(0.1f, 0.1f, 0.3f)) * (one - skyT) + Vec3x8(vec3(0.5f, 0.7f, 1.0f)) * skyT;
+            color = Select(miss, color + attenuation * sky, color);
+            if (bounce == 0) firstAlbedo = Select(miss, sky, firstAlbedo);
+            active = AndNot(miss, active);
+        }
+        if (!Any(active)) break;
+
+        Vec3x8 hitPoint = rayOrigin + rayDir * t;
+
+        // 逐路收集命中图元的材质(gather); 三角形的插值法线逐路标量计算, 球体之后按向量计算
+        alignas(32) float hitIdx[8], cx[8], cy[8], cz[8], mr[8], mg[8], mb[8], ms[8], mRefl[8], mEmit[8], mId[8];
+        alignas(32) float tx[8], ty[8], tz[8], isTriangle[8], hx[8], hy[8], hz[8], dx[8], dy[8], dz[8];
+        hitIndex.Store(hitIdx);
+        hitPoint.x.Store(hx); hitPoint.y.Store(hy); hitPoint.z.Store(hz);
+        rayDir.x.Store(dx); rayDir.y.Store(dy); rayDir.z.Store(dz);
+        for (int i = 0; i < 8; i++) {
+            int index = static_cast<int>(hitIdx[i]);
+            int material = 0;
+            cx[i] = cy[i] = cz[i] = tx[i] = ty[i] = tz[i] = isTriangle[i] = 0.0f;
+            if (index >= 0 && index < numSpheres) {
+                const vec4& cr = scene.centerRadius[index];
+                cx[i] = cr.x; cy[i] = cr.y; cz[i] = cr.z;
+                material = index;
+            } else if (index >= numSpheres) {
+                vec3 n = TriangleNormal(scene, index - numSpheres, vec3(dx[i], dy[i], dz[i]), vec3(hx[i], hy[i], hz[i]));
+                tx[i] = n.x; ty[i] = n.y; tz[i] = n.z;
+                isTriangle[i] = 1.0f;
+                material = static_cast<int>(scene.triangleShading[index - numSpheres].w);
+            }
+            if (index < 0) {
+                mr[i] = mg[i] = mb[i] = ms[i] = mRefl[i] = mEmit[i] = 0.0f;
+            } else {
+                const vec4& cs = scene.colorSpecular[material];
+                mr[i] = cs.x; mg[i] = cs.y; mb[i] = cs.z; ms[i] = cs.w;
+                mRefl[i] = scene.reflectivity[material];
+                mEmit[i] = scene.emission[material];
+            }
+            mId[i] = static_cast<float>(material);
+        }
+        Vec3x8 center(Float8::Load(cx), Float8::Load(cy), Float8::Load(cz));
+        Vec3x8 materialColor(Float8::Load(mr), Float8::Load(mg), Float8::Load(mb));
+        Float8 specular = Float8::Load(ms);
+        Float8 reflectivity = Float8::Load(mRefl);
+        Float8 emission = Float8::Load(mEmit);
+
+        Vec3x8 triangleNormal(Float8::Load(tx), Float8::Load(ty), Float8::Load(tz));
+        Vec3x8 normal = Select(Float8::Load(isTriangle) > zero, triangleNormal, Normalize(hitPoint - center));
+        Vec3x8 viewDir = Normalize(rayOrigin - hitPoint);
+        Vec3x8 shadowOrigin = hitPoint + normal * Float8(0.001f);
+        if (bounce == 0 && camera.denoise) {
+            firstNormal = Select(active, normal, firstNormal);
+            firstAlbedo = Select(active, materialColor, firstAlbedo);
+            firstDepth = Select(active, t * Dot(rayDir, Vec3x8(camera.front)), firstDepth);
+            firstIndex = Select(active, Float8::Load(mId), firstIndex);
+        }
+
+        // 逐个光源累加
+        Vec3x8 lighting(zero, zero, zero);
+        for (int lightIndex : scene.lights) {
+            const vec4& lc = scene.centerRadius[lightIndex];
+            Vec3x8 lightDir = Normalize(Vec3x8(vec3(lc.x, lc.y, lc.z)) - hitPoint);
+
+            // 阴影检测
+            Float8 shadowT, shadowIndex;
+            intersectScene(shadowOrigin, lightDir, active, shadowT, shadowIndex);
+            Float8 lit = (shadowIndex < zero) | (shadowIndex == Float8(static_cast<float>(lightIndex)));
+
+            // 漫反射与镜面反射
+            Float8 diff = Max(Dot(normal, lightDir), zero);
+            Vec3x8 reflectDir = Reflect(-lightDir, normal);
+            Float8 spec = PerLane(Max(Dot(viewDir, reflectDir), zero), specular,
+                [](float x, float e) { return std::pow(x, e); });
+
+            Vec3x8 litColor = materialColor * diff + Vec3x8(vec3(0.8f)) * spec;
+            Vec3x8 shadowColor = materialColor * (diff * Float8(0.3f));
+            lighting = lighting + Select(lit, litColor, shadowColor);
+        }
+
+        // 自发光(光源)
+        lighting = Select(emission > zero, materialColor * emission, lighting);
+        color = Select(active, color + attenuation * lighting, color);
+
+        // 反射
+        Float8 reflective = active & (reflectivity > zero);
+        attenuation = Select(reflective, attenuation * reflectivity, attenuation);
+        rayDir = Select(reflective, Reflect(rayDir, normal), rayDir);
+        rayOrigin = Select(reflective, hitPoint + normal * Float8(0.001f), rayOrigin);
+        active = reflective;
+    }
+    // 胶片颗粒噪声、色调映射与Gamma校正
+    alignas(32) float r[8], g[8], b[8];
+    color.x.Store(r); color.y.Store(g); color.z.Store(b);
+    alignas(32) float gbuffer[8][8];
+    if (camera.denoise) {
+        firstNormal.x.Store(gbuffer[0]); firstNormal.y.Store(gbuffer[1]); firstNormal.z.Store(gbuffer[2]);
+        firstDepth.Store(gbuffer[3]);
+        firstAlbedo.x.Store(gbuffer[4]); firstAlbedo.y.Store(gbuffer[5]); firstAlbedo.z.Store(gbuffer[6]);
+        firstIndex.Store(gbuffer[7]);
+    }
+    for (int i = 0; i < 8; i++) {
+        if (valid[i] == 0.0f) continue;
+        size_t pixel = static_cast<size_t>(py[i]) * m_width + static_cast<size_t>(px[i]);
+        vec3 c(r[i], g[i], b[i]);
+        if (camera.accumulate) {
+            // 逐像素滑动平均
+            float* history = &m_history[pixel * 3];
+            if (camera.frameIndex > 0) {
+                c = glm::mix(vec3(history[0], history[1], history[2]), c, 1.0f / float(camera.frameIndex + 1));
+            }
+            history[0] = c.x; history[1] = c.y; history[2] = c.z;
+        } else if (!camera.denoise) {
+            float noise = 0.05f * Rand(px[i] + camera.time, py[i] + camera.time);
+            c += vec3(noise);
+        }
+
+        // 降噪: 线性颜色与G-buffer交给CpuDenoiser
+        if (camera.denoise) {
+            for (int k = 0; k < 4; k++) {
+                m_normalDepth[pixel * 4 + k] = gbuffer[k][i];
+                m_albedoId[pixel * 4 + k] = gbuffer[4 + k][i];
+            }
+        } else {
+            c = ToneMap(c);
+        }
+
+        float* out = &m_pixels[pixel * 4];
+        out[0] = c.x; out[1] = c.y; out[2] = c.z; out[3] = 1.0f;
+    }
+}
+}   // namespace SimpleDrawingDemo
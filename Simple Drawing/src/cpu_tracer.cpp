@@ -0,0 +1,78 @@
+// src/cpu_tracer.cpp
+#include "pch.h"
+#include "simd.h"
+#include "thread_pool.h"
+#include "cpu_tracer.h"
+
+namespace SimpleDrawingDemo {
+
+CpuTracer::CpuTracer(const Scene* scene, ThreadPool* pool)
+    : m_scene(scene), m_pool(pool ? pool : &ThreadPool::Shared())
+{}
+
+int CpuTracer::ThreadCount() const {
+    return m_pool->ThreadCount();
+}
+
+// CPUID只查询一次
+bool CpuTracer::UseAvx2() {
+#if SD_SIMD_DISPATCH_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+const char* CpuTracer::SimdName() {
+    return UseAvx2() ? "AVX2" : Float8::Name();
+}
+
+void CpuTracer::Render(const CpuCamera& camera, int width, int height) {
+    Resize(camera, width, height);
+
+    // 分块并行
+    int tilesX = (width + kTileSize - 1) / kTileSize;
+    int tilesY = (height + kTileSize - 1) / kTileSize;
+    m_pool->ParallelFor(tilesX * tilesY, [&](int tile) {
+        RenderTile(camera, tile % tilesX, tile / tilesX);
+    });
+}
+
+void CpuTracer::RenderTiles(const CpuCamera& camera, int width, int height, const std::vector<int>& tiles) {
+    Resize(camera, width, height);
+
+    int tilesX = (width + kTileSize - 1) / kTileSize;
+    m_pool->ParallelFor(static_cast<int>(tiles.size()), [&](int i) {
+        RenderTile(camera, tiles[i] % tilesX, tiles[i] / tilesX);
+    });
+}
+
+void CpuTracer::Resize(const CpuCamera& camera, int width, int height) {
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        m_pixels.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    }
+    if (camera.accumulate && m_history.size() != static_cast<size_t>(width) * height * 3) {
+        m_history.assign(static_cast<size_t>(width) * height * 3, 0.0f);
+    }
+    if (camera.denoise && m_normalDepth.size() != static_cast<size_t>(width) * height * 4) {
+        m_normalDepth.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+        m_albedoId.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    }
+}
+
+void CpuTracer::RenderTile(const CpuCamera& camera, int tileX, int tileY) {
+    int x0 = tileX * kTileSize, y0 = tileY * kTileSize;
+    auto tracePacket = &CpuTracer::TracePacketBaseline;
+#if SD_SIMD_DISPATCH_AVX2
+    if (UseAvx2()) tracePacket = &CpuTracer::TracePacketAvx2;
+#endif
+    for (int y = y0; y < std::min(y0 + kTileSize, m_height); y += kPacketHeight) {
+        for (int x = x0; x < std::min(x0 + kTileSize, m_width); x += kPacketWidth) {
+            (this->*tracePacket)(camera, x, y);
+        }
+    }
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,67 @@
+// src/denoiser.cpp
+#include "pch.h"
+#include "denoiser.h"
+#include "render_data.h"
+#include "temporal_reprojection.h"
+#include "shader.h"
+#include "defines.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+// 与denoise.glsl一致
+constexpr int kTileSize = 16;
+constexpr unsigned int kInputUnit = 5;
+constexpr unsigned int kOutputUnit = 6;
+}
+
+Denoiser::Denoiser(const string& defines) {
+    m_program = Shader::CreateComputeShader(ShaderPath(), defines);
+    Reflect();
+}
+
+Denoiser::~Denoiser() {
+    if (m_program) glDeleteProgram(m_program);
+}
+
+string Denoiser::ShaderPath() {
+    return CSH_PATH + string("denoise.glsl");
+}
+
+void Denoiser::Reflect() {
+    ProgramReflection reflection = Shader::Reflect(m_program);
+    m_stepLocation = reflection.Location("stepSize");
+    m_finalLocation = reflection.Location("finalPass");
+    m_sigmaNormalLocation = reflection.Location("sigmaNormal");
+    m_sigmaDepthLocation = reflection.Location("sigmaDepth");
+    m_sigmaLuminanceLocation = reflection.Location("sigmaLuminance");
+}
+
+// 迭代i以2^i为间隔: 每个余数类单独分块, 工作组数为 间隔 x ceil(ceil(尺寸 / 间隔) / 16)
+void Denoiser::Run(const RenderData& data, int iterations) {
+    glUseProgram(m_program);
+    glUniform1f(m_sigmaNormalLocation, params.sigmaNormal);
+    glUniform1f(m_sigmaDepthLocation, params.sigmaDepth);
+    glUniform1f(m_sigmaLuminanceLocation, params.sigmaLuminance);
+
+    // 时域模式下滤波重投影混合后的历史
+    const RenderTarget* input = data.temporal ? &data.reprojection->History() : &data.noisyTarget;
+    for (int i = 0; i < iterations; i++) {
+        int step = 1 << i;
+        bool finalPass = i == iterations - 1;
+        const RenderTarget& output = data.denoiseTargets[i & 1];
+
+        glBindImageTexture(kInputUnit, input->texture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+        if (!finalPass) glBindImageTexture(kOutputUnit, output.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+        glUniform1i(m_stepLocation, step);
+        glUniform1i(m_finalLocation, finalPass);
+
+        int coarseWidth = (data.renderWidth + step - 1) / step;
+        int coarseHeight = (data.renderHeight + step - 1) / step;
+        glDispatchCompute(step * ((coarseWidth + kTileSize - 1) / kTileSize),
+                          step * ((coarseHeight + kTileSize - 1) / kTileSize), 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        input = &output;
+    }
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,61 @@
+// src/dirty_tracker.cpp
+#include "pch.h"
+#include "dirty_tracker.h"
+#include "render_data.h"
+#include "scene.h"
+
+namespace SimpleDrawingDemo {
+
+DirtyTracker::State DirtyTracker::Capture(const RenderData& data) {
+    State state;
+    state.cameraPos = data.cameraPos;
+    state.cameraFront = data.cameraFront;
+    state.cameraRight = data.cameraRight;
+    state.cameraUp = data.cameraUp;
+    state.screenWidth = data.screenWidth;
+    state.screenHeight = data.screenHeight;
+    state.renderWidth = data.renderWidth;
+    state.renderHeight = data.renderHeight;
+    state.targetWidth = data.outputTarget.width;
+    state.targetHeight = data.outputTarget.height;
+    state.program = data.computeShaderID;
+    state.accumulate = data.accumulate;
+    state.denoise = data.denoise;
+    state.temporal = data.temporal;
+    state.denoiseIterations = data.denoiseIterations;
+    state.sampler = data.sampler;
+    state.samplerScramble = data.samplerScramble;
+    return state;
+}
+
+bool DirtyTracker::NeedsFrame(const RenderData& data) const {
+    if (m_dirty || !(Capture(data) == m_state)) return true;
+
+    // 场景动画每帧都有改动; 待处理的尺寸变化在RenderLoop中应用
+    if (data.animator || data.scene->HasPendingUpdates() || data.resizeDeadline > 0.0) return true;
+
+    // 仍在收敛
+    if (data.accumulate && data.frameIndex < kMaxAccumulatedFrames) return true;
+    return data.temporal && m_settleFrames > 0;
+}
+
+void DirtyTracker::BeginFrame(const RenderData& data) {
+    m_pending = Capture(data);
+    if (m_dirty || !(m_pending == m_state)) {
+        m_settleFrames = kTemporalSettleFrames;
+    } else if (m_settleFrames > 0) {
+        m_settleFrames--;
+    }
+}
+
+void DirtyTracker::EndFrame(const RenderData& data) {
+    m_state = m_pending;
+    m_dirty = !(Capture(data) == m_pending);
+    m_stats.renderedFrames++;
+}
+
+void DirtyTracker::Skipped(double idleSeconds) {
+    m_stats.skippedFrames++;
+    m_stats.idleSeconds += idleSeconds;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,282 @@
+// src/frame_capture.cpp
+#include "pch.h"
+#include "frame_capture.h"
+#include "image_io.h"
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
+namespace SimpleDrawingDemo {
+
+FrameCapture::FrameCapture(const string& target) : m_target(target) {
+    string ext = target.size() >= 4 ? target.substr(target.size() - 4) : "";
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (target == "-") {
+        m_mode = Mode::Raw;
+        m_stream = stdout;
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);   // 避免换行符被转换
+#endif
+    } else if (ext == ".raw") {
+        m_mode = Mode::Raw;
+        m_stream = std::fopen(target.c_str(), "wb");
+        if (!m_stream) {
+            std::cerr << "[ERROR_CAPTURE] 无法写入文件: " << target << std::endl;
+            return;
+        }
+    } else if (ext == ".png") {
+        m_mode = Mode::Png;
+    } else if (ext == ".pfm") {
+        m_mode = Mode::Pfm;
+        m_bytesPerPixel = 16;
+    } else {
+        std::cerr << "[ERROR_CAPTURE] 不支持的捕获目标: " << target << " (可用 - / .raw / .png / .pfm)" << std::endl;
+        return;
+    }
+
+    // 图像序列: 解析编号格式, 输出目录不存在时自动创建
+    if (m_mode != Mode::Raw) {
+        if (!ParsePattern(target)) {
+            std::cerr << "[ERROR_CAPTURE] 无效的帧路径格式: " << target
+                      << " (只能包含一个%d/%05d形式的编号, 字面%需写作%%)" << std::endl;
+            return;
+        }
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::path(FramePath(0)).parent_path();
+        if (!directory.empty()) std::filesystem::create_directories(directory, error);
+    }
+
+    m_open = true;
+    m_writer = std::thread(&FrameCapture::WriterThread, this);
+}
+
+FrameCapture::~FrameCapture() {
+    if (!m_open) return;
+
+    Finish();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work.notify_all();
+    m_writer.join();
+
+    for (Slot& slot : m_slots) {
+        if (!slot.buffer) continue;
+        glUnmapNamedBuffer(slot.buffer);
+        glDeleteBuffers(1, &slot.buffer);
+    }
+    if (m_stream && m_stream != stdout) std::fclose(m_stream);
+    PrintStats();
+}
+
+void FrameCapture::Capture(unsigned int texture, int width, int height) {
+    if (!m_open) return;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Raw流没有帧头, 尺寸必须固定
+    if (m_mode == Mode::Raw) {
+        if (m_rawWidth == 0) {
+            m_rawWidth = width;
+            m_rawHeight = height;
+            std::cerr << "[CAPTURE] 原始流: " << width << "x" << height << " rgba8, 行序从上到下" << std::endl;
+        } else if (width != m_rawWidth || height != m_rawHeight) {
+            std::cerr << "[ERROR_CAPTURE] 原始流的帧尺寸不能改变, 跳过第 " << m_frameCount << " 帧" << std::endl;
+            m_frameCount++;
+            m_failed++;
+            return;
+        }
+    }
+
+    Poll(false);
+
+    // 环已满: 等待最早的一帧完成并写出(不丢帧)
+    Slot& slot = m_slots[m_next];
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (slot.state != SlotState::Free) {
+        m_stalls++;
+        lock.unlock();
+        while (std::find(m_inFlight.begin(), m_inFlight.end(), m_next) != m_inFlight.end()) Poll(true);
+        lock.lock();
+        m_slotFreed.wait(lock, [&] { return slot.state == SlotState::Free; });
+    }
+    lock.unlock();
+
+    size_t bytes = static_cast<size_t>(width) * height * m_bytesPerPixel;
+    EnsureCapacity(slot, bytes);
+
+    // 计算着色器的image写入需对纹理读回可见
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glGetTextureSubImage(texture, 0, 0, 0, 0, width, height, 1, GL_RGBA,
+        m_mode == Mode::Pfm ? GL_FLOAT : GL_UNSIGNED_BYTE, static_cast<GLsizei>(bytes), nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.width = width;
+        slot.height = height;
+        slot.frame = m_frameCount++;
+        slot.state = SlotState::InFlight;
+    }
+    m_inFlight.push_back(m_next);
+    m_next = (m_next + 1) % kRingSize;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    m_mainMs += ms;
+    m_maxMainMs = std::max(m_maxMainMs, ms);
+}
+
+void FrameCapture::Poll(bool wait) {
+    while (!m_inFlight.empty()) {
+        int index = m_inFlight.front();
+        Slot& slot = m_slots[index];
+
+        // 只有最早的一帧可能需要等待, 其余只做非阻塞查询
+        GLuint64 timeout = wait ? 1000000000 : 0;
+        GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            if (wait) continue;
+            return;
+        }
+        wait = false;
+
+        glDeleteSync(slot.fence);
+        m_inFlight.pop_front();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            slot.fence = nullptr;
+            slot.state = SlotState::Writing;
+            m_queue.push_back(index);
+        }
+        m_work.notify_one();
+    }
+}
+
+void FrameCapture::Finish() {
+    while (!m_inFlight.empty()) Poll(true);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_slotFreed.wait(lock, [&] {
+        return std::all_of(std::begin(m_slots), std::end(m_slots),
+            [](const Slot& slot) { return slot.state == SlotState::Free; });
+    });
+    if (m_stream) std::fflush(m_stream);
+}
+
+// 持久映射的读回缓冲(客户端内存, GPU写入后CPU直接读取)
+void FrameCapture::EnsureCapacity(Slot& slot, size_t bytes) {
+    if (slot.capacity >= bytes) return;
+    if (slot.buffer) {
+        glUnmapNamedBuffer(slot.buffer);
+        glDeleteBuffers(1, &slot.buffer);
+    }
+
+    const GLbitfield mapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &slot.buffer);
+    glNamedBufferStorage(slot.buffer, bytes, nullptr, mapFlags | GL_CLIENT_STORAGE_BIT);
+    slot.mapped = glMapNamedBufferRange(slot.buffer, 0, bytes, mapFlags);
+    slot.capacity = bytes;
+}
+
+void FrameCapture::WriterThread() {
+    while (true) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) break;
+            index = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        if (WriteFrame(m_slots[index])) m_written++;
+        else m_failed++;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_slots[index].state = SlotState::Free;
+        }
+        m_slotFreed.notify_all();
+    }
+}
+
+bool FrameCapture::WriteFrame(const Slot& slot) {
+    switch (m_mode) {
+    case Mode::Raw: {
+        // OpenGL行序从下到上, 编码器期望从上到下
+        const unsigned char* pixels = static_cast<const unsigned char*>(slot.mapped);
+        size_t rowBytes = static_cast<size_t>(slot.width) * 4;
+        for (int y = slot.height - 1; y >= 0; y--) {
+            if (std::fwrite(pixels + y * rowBytes, 1, rowBytes, m_stream) != rowBytes) {
+                std::cerr << "[ERROR_CAPTURE] 写入失败: 第 " << slot.frame << " 帧" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+    case Mode::Png:
+        return ImageIO::WritePNG(FramePath(slot.frame), slot.width, slot.height,
+            static_cast<const unsigned char*>(slot.mapped));
+    case Mode::Pfm:
+        return ImageIO::WritePFM(FramePath(slot.frame), slot.width, slot.height,
+            static_cast<const float*>(slot.mapped));
+    }
+    return false;
+}
+
+// 拆分路径格式: 编号之前/之后的部分与编号宽度; 没有编号时在扩展名前追加_%05d
+bool FrameCapture::ParsePattern(const string& target) {
+    string parts[2];
+    int conversions = 0;
+    for (size_t i = 0; i < target.size(); i++) {
+        if (target[i] != '%') {
+            parts[conversions] += target[i];
+            continue;
+        }
+        if (i + 1 < target.size() && target[i + 1] == '%') {
+            parts[conversions] += '%';
+            i++;
+            continue;
+        }
+
+        // %[0][宽度]d
+        size_t j = i + 1;
+        bool zeroPad = j < target.size() && target[j] == '0';
+        if (zeroPad) j++;
+        size_t digits = j;
+        while (j < target.size() && std::isdigit(static_cast<unsigned char>(target[j]))) j++;
+        if (j >= target.size() || target[j] != 'd' || j - digits > 2 || conversions > 0) return false;
+        m_frameWidth = j > digits ? std::stoi(target.substr(digits, j - digits)) : 0;
+        m_framePad = zeroPad ? '0' : ' ';
+        conversions++;
+        i = j;
+    }
+
+    if (conversions == 0) {
+        m_pathPrefix = parts[0].substr(0, parts[0].size() - 4) + "_";
+        m_pathSuffix = parts[0].substr(parts[0].size() - 4);
+        m_frameWidth = 5;
+        m_framePad = '0';
+    } else {
+        m_pathPrefix = parts[0];
+        m_pathSuffix = parts[1];
+    }
+    return true;
+}
+
+string FrameCapture::FramePath(long long frame) const {
+    string number = std::to_string(frame);
+    if (static_cast<int>(number.size()) < m_frameWidth) number.insert(0, m_frameWidth - number.size(), m_framePad);
+    return m_pathPrefix + number + m_pathSuffix;
+}
+
+void FrameCapture::PrintStats() const {
+    std::cout << "[CAPTURE] 已写入 " << m_written << " 帧, 失败 " << m_failed
+              << ", 主线程平均 " << (m_frameCount > 0 ? m_mainMs / m_frameCount : 0.0) << " ms / 最大 "
+              << m_maxMainMs << " ms, 等待空闲槽位 " << m_stalls << " 次" << std::endl;
+}
+}   // namespace SimpleDrawingDemo
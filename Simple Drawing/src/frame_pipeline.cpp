@@ -0,0 +1,86 @@
+// src/frame_pipeline.cpp
+#include "pch.h"
+#include "frame_pipeline.h"
+#include "render_data.h"
+
+namespace SimpleDrawingDemo {
+
+FramePipeline::FramePipeline(RenderData& data, int framesInFlight)
+    : m_slots(std::clamp(framesInFlight, 1, kMaxFramesInFlight))
+{
+    for (Slot& slot : m_slots) glGenQueries(1, &slot.query);
+    Resize(data);
+    std::cout << "[PIPELINE] 在途帧数 " << FramesInFlight() << (FramesInFlight() == 1 ? " (低延迟)" : " (高吞吐)")
+              << ", 显存 " << data.targetPool->AllocatedBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+FramePipeline::~FramePipeline() {
+    for (Slot& slot : m_slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        glDeleteQueries(1, &slot.query);
+    }
+}
+
+void FramePipeline::Resize(RenderData& data) {
+    for (int i = 0; i < FramesInFlight(); i++) {
+        if (i == m_current) continue;
+        data.targetPool->Reacquire(m_slots[i].target, data.outputFormat, data.outputTarget.width, data.outputTarget.height);
+    }
+}
+
+void FramePipeline::Release(RenderTargetPool& pool) {
+    for (int i = 0; i < FramesInFlight(); i++) {
+        if (i != m_current) pool.Release(m_slots[i].target);
+    }
+}
+
+// 等待槽位上一帧的栅栏, 并读取该帧的延迟(栅栏通过后时间戳查询必然可用); Drain的等待不计入栅栏等待
+void FramePipeline::Wait(Slot& slot, bool recordWait) {
+    if (!slot.fence) return;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+    if (recordWait) m_fenceWaitMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    GLuint64 completeTime = 0;
+    glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &completeTime);
+    m_latencyMs.push_back(static_cast<double>(static_cast<GLint64>(completeTime) - slot.submitTime) / 1e6);
+}
+
+void FramePipeline::Throttle() {
+    Wait(m_slots[(m_current + 1) % FramesInFlight()], true);
+}
+
+void FramePipeline::BeginFrame(RenderData& data) {
+    Throttle();
+
+    // 归还当前输出图像(可能已随窗口尺寸重新分配), 借出下一张
+    int next = (m_current + 1) % FramesInFlight();
+    m_slots[m_current].target = data.outputTarget;
+    data.outputTarget = m_slots[next].target;
+    m_slots[next].target = RenderTarget();
+    m_current = next;
+
+    glBindImageTexture(0, data.outputTarget.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, FormatInfo(data.outputFormat).internalFormat);
+    glGetInteger64v(GL_TIMESTAMP, &m_slots[m_current].submitTime);
+}
+
+void FramePipeline::EndFrame() {
+    Slot& slot = m_slots[m_current];
+    glQueryCounter(slot.query, GL_TIMESTAMP);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void FramePipeline::Drain() {
+    for (int i = 1; i <= FramesInFlight(); i++) Wait(m_slots[(m_current + i) % FramesInFlight()], false);
+}
+
+void FramePipeline::TakeSamples(std::vector<double>& latencyMs, std::vector<double>& fenceWaitMs) {
+    latencyMs.insert(latencyMs.end(), m_latencyMs.begin(), m_latencyMs.end());
+    fenceWaitMs.insert(fenceWaitMs.end(), m_fenceWaitMs.begin(), m_fenceWaitMs.end());
+    m_latencyMs.clear();
+    m_fenceWaitMs.clear();
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,67 @@
+// src/gpu_timer.cpp
+#include "pch.h"
+#include "gpu_timer.h"
+
+namespace SimpleDrawingDemo {
+
+GpuTimer::GpuTimer(int ringSize) : m_queries(std::max(ringSize, 2) * 2, 0) {
+    glGenQueries(static_cast<int>(m_queries.size()), m_queries.data());
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(static_cast<int>(m_queries.size()), m_queries.data());
+}
+
+void GpuTimer::Begin() {
+    // 环已满: 只能阻塞读取最早的查询, 腾出槽位
+    if (m_pending == SlotCount()) {
+        m_ready.push_back(ReadOldest());
+    }
+    glQueryCounter(m_queries[m_head * 2], GL_TIMESTAMP);
+}
+
+void GpuTimer::End() {
+    glQueryCounter(m_queries[m_head * 2 + 1], GL_TIMESTAMP);
+    m_head = (m_head + 1) % SlotCount();
+    m_pending++;
+}
+
+bool GpuTimer::Poll(double& ms) {
+    if (!m_ready.empty()) {
+        ms = m_ready.front();
+        m_ready.pop_front();
+        return true;
+    }
+    if (m_pending == 0) return false;
+
+    // 检查最早的结束时间戳是否已经可用
+    int size = SlotCount();
+    int oldest = (m_head - m_pending + size) % size;
+    GLint available = 0;
+    glGetQueryObjectiv(m_queries[oldest * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    ms = ReadOldest();
+    return true;
+}
+
+void GpuTimer::Drain(std::vector<double>& out) {
+    while (!m_ready.empty()) {
+        out.push_back(m_ready.front());
+        m_ready.pop_front();
+    }
+    while (m_pending > 0) {
+        out.push_back(ReadOldest());
+    }
+}
+
+double GpuTimer::ReadOldest() {
+    int size = SlotCount();
+    int oldest = (m_head - m_pending + size) % size;
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(m_queries[oldest * 2], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(m_queries[oldest * 2 + 1], GL_QUERY_RESULT, &end);
+    m_pending--;
+    return static_cast<double>(end - begin) / 1.0e6;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,169 @@
+// src/image_io.cpp
+#include "pch.h"
+#include "image_io.h"
+
+namespace SimpleDrawingDemo {
+
+// 读取纹理第0级的RGBA float数据
+std::vector<float> ImageIO::ReadTexture(unsigned int texture, int width, int height) {
+    std::vector<float> pixels(static_cast<size_t>(width) * height * 4);
+    // 只读取左下角width x height区域(动态分辨率下纹理按最大尺寸分配)
+    glGetTextureSubImage(texture, 0, 0, 0, 0, width, height, 1, GL_RGBA, GL_FLOAT,
+        static_cast<int>(pixels.size() * sizeof(float)), pixels.data());
+    return pixels;
+}
+
+bool ImageIO::Write(const string& path, int width, int height, const std::vector<float>& rgba) {
+    string ext = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext == ".pfm") return WritePFM(path, width, height, rgba.data());
+    if (ext == ".ppm") return WritePPM(path, width, height, rgba.data());
+    if (ext == ".png") {
+        std::vector<unsigned char> bytes(rgba.size());
+        for (size_t i = 0; i < rgba.size(); i++) {
+            bytes[i] = static_cast<unsigned char>(std::clamp(rgba[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        return WritePNG(path, width, height, bytes.data());
+    }
+
+    std::cerr << "[ERROR_IMAGE] 不支持的图像格式: " << path << std::endl;
+    return false;
+}
+
+// PFM: 小端RGB float, 行从下到上存储(与OpenGL纹理行序一致)
+bool ImageIO::WritePFM(const string& path, int width, int height, const float* rgba) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR_IMAGE] 无法写入文件: " << path << std::endl;
+        return false;
+    }
+    file << "PF\n" << width << " " << height << "\n-1.0\n";
+
+    std::vector<float> row(static_cast<size_t>(width) * 3);
+    for (int y = 0; y < height; y++) {
+        const float* src = &rgba[static_cast<size_t>(y) * width * 4];
+        for (int x = 0; x < width; x++) {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(float));
+    }
+    return static_cast<bool>(file);
+}
+
+// PPM: 8位RGB, 行从上到下存储, 因此需要翻转
+bool ImageIO::WritePPM(const string& path, int width, int height, const float* rgba) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR_IMAGE] 无法写入文件: " << path << std::endl;
+        return false;
+    }
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+    for (int y = height - 1; y >= 0; y--) {
+        const float* src = &rgba[static_cast<size_t>(y) * width * 4];
+        for (int i = 0; i < width * 3; i++) {
+            float v = std::clamp(src[(i / 3) * 4 + i % 3], 0.0f, 1.0f);
+            row[i] = static_cast<unsigned char>(v * 255.0f + 0.5f);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    return static_cast<bool>(file);
+}
+
+namespace {
+uint32_t Crc32(const unsigned char* data, size_t size, uint32_t crc = 0) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> result = {};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            result[i] = c;
+        }
+        return result;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void PutBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void WriteChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    chunk.reserve(data.size() + 12);
+    PutBigEndian(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    PutBigEndian(chunk, Crc32(chunk.data() + 4, data.size() + 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+}
+
+// PNG: 行从上到下存储, 因此需要翻转
+bool ImageIO::WritePNG(const string& path, int width, int height, const unsigned char* rgba) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR_IMAGE] 无法写入文件: " << path << std::endl;
+        return false;
+    }
+    const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    // IHDR: 8位RGBA, 无隔行
+    std::vector<unsigned char> header;
+    PutBigEndian(header, width);
+    PutBigEndian(header, height);
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });
+    WriteChunk(file, "IHDR", header);
+
+    // 扫描线: 每行前加滤波类型0
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowBytes + 1) * height);
+    for (int y = height - 1; y >= 0; y--) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + y * rowBytes, rgba + (y + 1) * rowBytes);
+    }
+
+    // zlib流: 未压缩的deflate块(每块最多65535字节) + Adler-32
+    std::vector<unsigned char> idat;
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    for (size_t offset = 0;;) {
+        size_t length = std::min<size_t>(65535, raw.size() - offset);
+        bool last = offset + length == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(static_cast<unsigned char>(length));
+        idat.push_back(static_cast<unsigned char>(length >> 8));
+        idat.push_back(static_cast<unsigned char>(~length));
+        idat.push_back(static_cast<unsigned char>(~length >> 8));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+        if (last) break;
+    }
+    // Adler-32: 每5552字节取模一次(zlib的NMAX, 保证32位不溢出)
+    uint32_t a = 1, b = 0;
+    for (size_t offset = 0; offset < raw.size(); offset += 5552) {
+        size_t end = std::min(raw.size(), offset + 5552);
+        for (size_t i = offset; i < end; i++) {
+            a += raw[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    PutBigEndian(idat, (b << 16) | a);
+    WriteChunk(file, "IDAT", idat);
+    WriteChunk(file, "IEND", {});
+    return static_cast<bool>(file);
+}
+}   // namespace SimpleDrawingDemo
@@ -3,31 +3,37 @@
 #include "render_data.h"
 #include "defines.h"
 #include "initer.h"
-#include "main_loop.h"
+#include "launch_options.h"
+#include "profiler.h"
 
 namespace SimpleDrawingDemo {
 
 // 窗口创建
-GLFWwindow* Initer::InitWindow() {
+GLFWwindow* Initer::InitWindow(const LaunchOptions& options) {
     // 初始化GLFW
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);  // 指定OpenGL版本为4.5
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    // 无头模式: 隐藏窗口, 可选EGL上下文(Mesa llvmpipe)
+    if (options.headless) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (options.useEGL) glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+
     // 创建窗口
-    GLFWwindow* window = glfwCreateWindow(1920, 1080, "光线追踪实例", NULL, NULL);
+    GLFWwindow* window = glfwCreateWindow(options.width, options.height, "光线追踪实例", NULL, NULL);
+    if (!window) {
+        std::cerr << "[ERROR_INIT] 窗口创建失败" << std::endl;
+        glfwTerminate();
+        std::exit(1);
+    }
     glfwMakeContextCurrent(window);
-    
-    // 设置窗口回调
-    glfwSetFramebufferSizeCallback(window, MainLoop::FramebufferSizeCallback);
-    glfwSetCursorPosCallback(window, MainLoop::MousePosCallback);
 
     // 初始化GLAD
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
     
     // 设置初始鼠标模式
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (!options.headless) glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     return window;
 }
@@ -35,6 +41,9 @@ GLFWwindow* Initer::InitWindow() {
 // 资源清理
 void Initer::CleanResources(RenderData** data) {
     delete *data; *data = nullptr;
+#if ENABLE_PROFILER
+    Profiler::Release();
+#endif
 
     glfwTerminate();
 }
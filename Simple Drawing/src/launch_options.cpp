@@ -0,0 +1,160 @@
+// src/launch_options.cpp
+#include "pch.h"
+#include "launch_options.h"
+
+namespace SimpleDrawingDemo {
+
+// 解析"1280x720"格式的分辨率
+static bool ParseSize(const string& text, int& width, int& height) {
+    size_t pos = text.find('x');
+    if (pos == string::npos) return false;
+    try {
+        width = std::stoi(text.substr(0, pos));
+        height = std::stoi(text.substr(pos + 1));
+    } catch (...) {
+        return false;
+    }
+    return width > 0 && height > 0;
+}
+
+// 解析命令行参数
+LaunchOptions LaunchOptions::Parse(int argc, char** argv) {
+    LaunchOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        // 取下一个参数值
+        auto next = [&](string& out) {
+            if (i + 1 >= argc) {
+                std::cerr << "[ERROR_ARGS] 参数缺少取值: " << arg << std::endl;
+                return false;
+            }
+            out = argv[++i];
+            return true;
+        };
+        string value;
+
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--accumulate") {
+            options.accumulate = true;
+        } else if (arg == "--denoise") {
+            if (next(value)) options.denoise = std::clamp(std::atoi(value.c_str()), 0, 5);
+        } else if (arg == "--temporal") {
+            options.temporal = true;
+        } else if (arg == "--bounces") {
+            if (next(value)) options.bounces = std::clamp(std::atoi(value.c_str()), 1, 8);
+        } else if (arg == "--sampler") {
+            if (next(value)) options.sampler = value;
+        } else if (arg == "--convergence") {
+            if (next(value)) options.convergence = std::clamp(std::atoi(value.c_str()), 0, 4096);
+        } else if (arg == "--resize-check") {
+            options.resizeCheck = true;
+        } else if (arg == "--workgroup") {
+            if (next(value)) options.workgroup = value;
+        } else if (arg == "--autotune") {
+            options.autotune = true;
+        } else if (arg == "--views") {
+            if (next(value)) options.views = std::clamp(std::atoi(value.c_str()), 0, 256);
+        } else if (arg == "--animate") {
+            if (next(value)) options.animate = std::clamp(static_cast<float>(std::atof(value.c_str())), 0.0f, 1.0f);
+        } else if (arg == "--tile-binning") {
+            options.tileBinning = true;
+        } else if (arg == "--farm") {
+            if (next(value)) options.farm = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--farm-socket") {
+            if (next(value)) options.farmSocket = value;
+        } else if (arg == "--farm-worker") {
+            if (next(value)) options.farmWorker = value;
+        } else if (arg == "--farm-fault") {
+            if (next(value)) options.farmFault = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--no-idle") {
+            options.idle = false;
+        } else if (arg == "--frames-in-flight") {
+            if (next(value)) options.framesInFlight = std::clamp(std::atoi(value.c_str()), 1, 3);
+        } else if (arg == "--no-shader-cache") {
+            options.shaderCache = false;
+        } else if (arg == "--egl") {
+            options.useEGL = true;
+        } else if (arg == "--scene") {
+            if (next(value)) options.scenePath = value;
+        } else if (arg == "--random-spheres") {
+            if (next(value)) options.randomSpheres = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--render-scale") {
+            if (next(value)) options.renderScale = std::clamp(static_cast<float>(std::atof(value.c_str())), 0.1f, 1.0f);
+        } else if (arg == "--target-ms") {
+            if (next(value)) options.targetMs = std::max(0.0, std::atof(value.c_str()));
+        } else if (arg == "--output-format") {
+            if (next(value)) options.outputFormat = value;
+        } else if (arg == "--history-format") {
+            if (next(value)) options.historyFormat = value;
+        } else if (arg == "--backend") {
+            if (next(value)) options.backend = value;
+        } else if (arg == "--size") {
+            if (next(value) && !ParseSize(value, options.width, options.height)) {
+                std::cerr << "[ERROR_ARGS] 无效的分辨率: " << value << std::endl;
+            }
+        } else if (arg == "--frames") {
+            if (next(value)) options.frames = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--warmup") {
+            if (next(value)) options.warmup = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--camera") {
+            if (next(value)) options.cameraPath = value;
+        } else if (arg == "--report") {
+            if (next(value)) options.reportPath = value;
+        } else if (arg == "--dump") {
+            if (next(value)) options.dumpPath = value;
+        } else if (arg == "--trace") {
+            if (next(value)) options.tracePath = value;
+        } else if (arg == "--capture") {
+            if (next(value)) options.capturePath = value;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            std::exit(0);
+        } else {
+            std::cerr << "[ERROR_ARGS] 未知参数: " << arg << std::endl;
+        }
+    }
+    return options;
+}
+
+void LaunchOptions::PrintUsage() {
+    std::cout <<
+        "用法: App.exe [选项]\n"
+        "  --size WxH        渲染分辨率 (默认 1920x1080)\n"
+        "  --scene FILE      场景JSON文件 (默认 resources/scenes/default.json)\n"
+        "  --random-spheres N  生成N个随机小球的测试场景\n"
+        "  --render-scale S  内部渲染比例 0.1~1 (默认 1)\n"
+        "  --target-ms MS    动态分辨率: 按目标帧时间自动调整渲染比例 (如 16.6)\n"
+        "  --output-format F 输出纹理格式: rgba32f / rgba16f / r11g11b10f / rgba8 (默认 rgba8)\n"
+        "  --history-format F 累积历史格式 (默认 rgba16f, 长时间累积建议 rgba32f)\n"
+        "  --backend NAME    渲染后端: gpu / wavefront / cpu (默认 gpu)\n"
+        "  --accumulate      启用渐进累积模式 (运行时按R切换)\n"
+        "  --denoise N       边缘保持降噪, N为à-trous迭代次数 1~5, 0为关闭 (运行时按N切换)\n"
+        "  --temporal        时域重投影: 移动中复用上一帧历史 (运行时按T切换, 仅GPU后端)\n"
+        "  --bounces N       反弹次数 1~8 (默认 3)\n"
+        "  --sampler NAME    子像素抖动的采样序列: hash / r2 / sobol / bluenoise (默认 sobol)\n"
+        "  --convergence N   无头模式收敛测试: 各采样序列累积到N个样本, 输出对照参考图的RMSE曲线 (仅GPU后端)\n"
+        "  --resize-check    无头模式: 在两个尺寸桶之间往返调整渲染目标, 检查回到原尺寸时不新建纹理 (仅GPU后端)\n"
+        "  --workgroup WxH   单内核的工作组形状, 如 32x8 (默认使用保存的调优结果或 16x16)\n"
+        "  --autotune        测量各候选工作组形状, 选用最快的并按驱动保存\n"
+        "  --views N         无头模式下每帧一次分派渲染N个转台视图到纹理数组 (仅gpu后端, --dump按视图分别输出)\n"
+        "  --animate F       场景动画: 光源随时间移动, 比例F(0~1)的球体上下浮动 (增量上传与BVH refit)\n"
+        "  --tile-binning    主光线只测试所在屏幕块的图元列表 (仅gpu后端)\n"
+        "  --farm N          渲染农场: 画面分块分发给N个本机工作进程 (仅cpu后端, 不支持累积与降噪)\n"
+        "  --farm-socket P   渲染农场的Unix域套接字路径 (默认 /tmp/simple_drawing_farm_<pid>.sock)\n"
+        "  --farm-fault N    测试用: 第一个工作进程渲染N个分块后退出, 验证分块重新分配\n"
+        "  --no-idle         关闭按需渲染: 画面不变时也持续追踪 (默认在静止时跳过帧并等待输入)\n"
+        "  --frames-in-flight N  在途帧数上限 1~3: 1为低延迟, 3为高吞吐 (默认 2)\n"
+        "  --no-shader-cache 禁用着色器程序二进制缓存\n"
+        "  --headless        无头基准测试模式 (隐藏窗口, 不交换缓冲)\n"
+        "  --egl             使用EGL创建OpenGL上下文\n"
+        "  --frames N        计时帧数 (默认 300)\n"
+        "  --warmup N        预热帧数 (默认 30)\n"
+        "  --camera PATH     相机路径: static / orbit / dolly (默认 orbit)\n"
+        "  --report FILE     帧时间统计JSON输出文件 (默认stdout)\n"
+        "  --dump FILE       输出最终图像 (.pfm / .ppm)\n"
+        "  --capture TARGET  逐帧异步捕获: - (stdout原始RGBA8) / *.raw / *.png / *.pfm\n"
+        "  --trace FILE      退出时导出性能trace (Chrome trace_event JSON, 运行时按F12导出)\n";
+}
+}   // namespace SimpleDrawingDemo
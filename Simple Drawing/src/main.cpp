@@ -4,30 +4,202 @@
 #include "initer.h"
 #include "main_loop.h"
 #include "shader.h"
+#include "launch_options.h"
+#include "benchmark.h"
+#include "cpu_tracer.h"
+#include "defines.h"
+#include "scene.h"
+#include "shader_cache.h"
+#include "shader_reloader.h"
+#include "profiler.h"
+#include "resolution_controller.h"
+#include "frame_capture.h"
+#include "simulation.h"
+#include "wavefront_tracer.h"
+#include "denoiser.h"
+#include "temporal_reprojection.h"
+#include "workgroup_tuner.h"
+#include "tile_binner.h"
+#include "scene_animator.h"
+#include "render_farm.h"
+#include "multi_view.h"
 
 using namespace SimpleDrawingDemo;
 
-int main() {
+int main(int argc, char** argv) {
+    // 解析命令行参数
+    LaunchOptions options = LaunchOptions::Parse(argc, argv);
+
+    // stdout被捕获的帧数据占用时, 日志改写到stderr
+    if (options.capturePath == "-") std::cout.rdbuf(std::cerr.rdbuf());
+    bool cpuBackend = options.backend == "cpu";
+
+    // 加载场景
+    RenderData* data = RenderData::GetInstance();
+    if (options.randomSpheres > 0) {
+        data->scene->LoadRandom(options.randomSpheres);
+    } else {
+        data->LoadScene(options.scenePath.empty() ? SCENE_PATH + string("default.json") : options.scenePath);
+    }
+
+    if (options.animate > 0.0f) data->animator = new SceneAnimator(*data->scene, options.animate);
+    if (!ParseSampler(options.sampler, data->sampler)) {
+        std::cerr << "[ERROR_ARGS] 未知的采样序列: " << options.sampler << ", 使用sobol" << std::endl;
+    }
+
+    // 渲染农场的工作进程: 只追踪协调进程分发的分块
+    if (!options.farmWorker.empty()) {
+        int code = RenderFarm::RunWorker(data, options);
+        Initer::CleanResources(&data);
+        return code;
+    }
+
+    // 无GPU节点: 纯CPU离屏渲染, 不创建窗口与GL上下文
+    if (options.headless && cpuBackend) {
+        int code = Benchmark::RunCpu(data, options);
+        Initer::CleanResources(&data);
+        return code;
+    }
+
     // 创建窗口
-    GLFWwindow* window = Initer::InitWindow();
+    GLFWwindow* window = Initer::InitWindow(options);
     
-    // 获取渲染数据实例并初始化
-    RenderData* data = RenderData::GetInstance();
-    data->screenWidth = 1920;
-    data->screenHeight = 1080;
+    // 初始化渲染资源
+    data->screenWidth = options.width;
+    data->screenHeight = options.height;
+    data->accumulate = options.accumulate;
+    if (options.denoise > 0) data->denoiseIterations = options.denoise;
+    data->renderScale = options.renderScale;
+    if (!ParseTargetFormat(options.outputFormat, data->outputFormat)) {
+        std::cerr << "[ERROR_ARGS] 未知的输出格式: " << options.outputFormat << std::endl;
+    }
+    if (!ParseTargetFormat(options.historyFormat, data->historyFormat)) {
+        std::cerr << "[ERROR_ARGS] 未知的历史格式: " << options.historyFormat << std::endl;
+    }
+    if (options.targetMs > 0.0) data->resolution = new ResolutionController(options.targetMs);
+    data->maxBounces = options.bounces;
+    data->tileBinning = options.tileBinning && options.backend == "gpu";
+    if (options.tileBinning && !data->tileBinning) std::cerr << "[TILES] 分块求交只支持gpu后端, 已忽略" << std::endl;
+    if (!options.workgroup.empty()) {
+        if (!WorkgroupSize::Parse(options.workgroup, data->workgroup) || !data->workgroup.Supported()) {
+            std::cerr << "[ERROR_ARGS] 无效或不受支持的工作组形状: " << options.workgroup << ", 使用16x16" << std::endl;
+            data->workgroup = WorkgroupSize();
+        }
+    } else if (WorkgroupTuner::Load(data->workgroup)) {
+        std::cout << "[AUTOTUNE] 使用保存的工作组形状 " << data->workgroup.Name() << std::endl;
+    }
+    data->framesInFlight = options.framesInFlight;
+    ShaderCache::s_enabled = options.shaderCache;
     data->InitRayTracingResources();
+    if (options.autotune) WorkgroupTuner::Run(window, data);
+    if (!options.capturePath.empty()) {
+        data->capture = new FrameCapture(options.capturePath);
+        if (data->capture->GetMode() == FrameCapture::Mode::Raw && data->resolution) {
+            std::cerr << "[CAPTURE] 原始流需要固定帧尺寸, 已禁用动态分辨率" << std::endl;
+            delete data->resolution;
+            data->resolution = nullptr;
+        }
+    }
+    if (cpuBackend) {
+        data->backend = RenderBackend::CPU;
+        data->cpuTracer = new CpuTracer(data->scene);
+        data->cpuTracer->SetMaxBounces(data->maxBounces);
+        data->cpuTracer->SetSampler(data->sampler);
+        data->cpuDenoiser = new CpuDenoiser();
+        if (options.farm > 0) {
+            data->renderFarm = new RenderFarm(data->scene, options);
+            if (!data->renderFarm->Start()) {
+                delete data->renderFarm;
+                data->renderFarm = nullptr;
+            }
+        }
+    } else if (options.backend == "wavefront") {
+        data->backend = RenderBackend::Wavefront;
+        data->wavefront = new WavefrontTracer(data->ComputeDefines(), data->maxBounces);
+    } else if (options.backend != "gpu") {
+        std::cerr << "[ERROR_ARGS] 未知的渲染后端: " << options.backend << ", 使用gpu" << std::endl;
+    }
+    if (options.farm > 0 && !cpuBackend) std::cerr << "[FARM] 渲染农场只支持cpu后端, 已忽略" << std::endl;
+
+    if (options.views > 0) {
+        if (options.backend == "gpu" && options.headless) {
+            data->multiView = new MultiViewRenderer(*data);
+        } else {
+            std::cerr << "[MULTI_VIEW] 多视图只支持gpu后端的无头模式, 已忽略" << std::endl;
+        }
+    }
+
+    data->SetDenoise(options.denoise > 0);
+    data->SetTemporal(options.temporal);
+
+    // 场景动画每帧都在变化, 逐帧捕获需要连续的帧序列: 这两种情况下不跳帧
+    data->idle = options.idle && !options.headless && !data->animator && !data->capture;
+
+    // 无头基准测试模式
+    if (options.headless) {
+        int code = options.resizeCheck ? Benchmark::RunResizeCheck(window, data, options)
+            : options.convergence > 0 ? Benchmark::RunConvergence(window, data, options) : Benchmark::Run(window, data, options);
+        Initer::CleanResources(&data);
+        return code;
+    }
     
-    // 设置鼠标回调
-    glfwSetCursorPosCallback(window, MainLoop::MousePosCallback);
+    {
+        // 着色器热重载(后台编译, 成功后在帧间替换)
+        ShaderReloader reloader(window);
+        reloader.Watch({ { GL_COMPUTE_SHADER, CSH_PATH + string("ray_tracing.glsl") } }, &data->computeShaderID, [data] {
+            data->ReflectComputeShader();
+            data->ResetAccumulation();
+        }, data->TraceDefines());
+        reloader.Watch({ { GL_VERTEX_SHADER, VSH_PATH + string("general.glsl") }, { GL_FRAGMENT_SHADER, FSH_PATH + string("general.glsl") } },
+            &Shader::s_programID, [data] {
+            data->shader->Reflect();
+            data->shader->Use();
+            data->shader->SetUniform1i("screenTexture", 0);
+        });
+        if (data->wavefront) {
+            for (int pass = 0; pass < WavefrontTracer::kPassCount; pass++) {
+                auto wavefrontPass = static_cast<WavefrontTracer::Pass>(pass);
+                reloader.Watch({ { GL_COMPUTE_SHADER, WavefrontTracer::PassPath(wavefrontPass) } }, data->wavefront->Program(wavefrontPass), [data] {
+                    data->wavefront->Reflect();
+                    data->ResetAccumulation();
+                }, data->ComputeDefines());
+            }
+        }
+        if (data->tileBinner) {
+            reloader.Watch({ { GL_COMPUTE_SHADER, TileBinner::ShaderPath() } }, data->tileBinner->Program(), [data] {
+                data->tileBinner->Reflect();
+                data->ResetAccumulation();
+            }, data->ComputeDefines() + TileBinner::Defines());
+        }
+        reloader.Watch({ { GL_COMPUTE_SHADER, Denoiser::ShaderPath() } }, data->denoiser->Program(), [data] {
+            data->denoiser->Reflect();
+        }, data->ComputeDefines());
+        reloader.Watch({ { GL_COMPUTE_SHADER, TemporalReprojection::ShaderPath() } }, data->reprojection->Program(), [data] {
+            data->reprojection->Reflect();
+        }, data->ComputeDefines());
+
+        // 主循环: 主线程运行固定步长模拟并处理窗口事件, GL上下文交给渲染线程
+        Simulation simulation(window, data);
+        std::atomic<bool> running{ true };
+        glfwMakeContextCurrent(NULL);
+        std::thread renderThread(MainLoop::RenderThread, window, data, &simulation, &reloader, std::cref(running));
+
+        simulation.Run();
+
+        running.store(false, std::memory_order_release);
+        renderThread.join();
+        glfwMakeContextCurrent(window);
+    }
 
-    // 主循环
-    while (!glfwWindowShouldClose(window)) {
-        MainLoop::InputHandles(window);
-        MainLoop::RenderLoop(window, data);
+#if ENABLE_PROFILER
+    if (!options.tracePath.empty()) {
+        Profiler::DumpTrace(options.tracePath);
+        Profiler::PrintSummary();
     }
+#endif
 
     // 资源清理
     Initer::CleanResources(&data);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -3,129 +3,28 @@
 #include "render_data.h"
 #include "defines.h"
 #include "main_loop.h"
+#include "cpu_tracer.h"
+#include "scene.h"
+#include "uniform_ring.h"
+#include "frame_uniforms.h"
+#include "profiler.h"
+#include "resolution_controller.h"
+#include "frame_capture.h"
+#include "simulation.h"
+#include "shader_reloader.h"
+#include "wavefront_tracer.h"
+#include "denoiser.h"
+#include "temporal_reprojection.h"
+#include "tile_binner.h"
+#include "render_farm.h"
+#include "dirty_tracker.h"
+#include "frame_pipeline.h"
 
 namespace SimpleDrawingDemo {
 
-// 窗口大小变化回调
-void MainLoop::FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
-    RenderData* data = RenderData::GetInstance();
-    
-    // 更新视口
-    glViewport(0, 0, width, height);
-    
-    // 更新屏幕尺寸
-    data->screenWidth = width;
-    data->screenHeight = height;
-    
-    // 重新创建输出纹理
-    glDeleteTextures(1, &data->outputTexture);
-    glGenTextures(1, &data->outputTexture);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, data->outputTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    glBindImageTexture(0, data->outputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
-    
-    std::cout << "窗口大小已更新: " << width << "x" << height << std::endl;
-}
-
-// 鼠标位置回调
-void MainLoop::MousePosCallback(GLFWwindow* window, double xpos, double ypos) {
-    RenderData* data = RenderData::GetInstance();
-    if (!data->mouseCaptured) return;
-    
-    if (data->firstMouse) {
-        data->lastX = xpos;
-        data->lastY = ypos;
-        data->firstMouse = false;
-    }
-    
-    float xoffset = xpos - data->lastX;
-    float yoffset = data->lastY - ypos; // 反转Y轴
-    data->lastX = xpos;
-    data->lastY = ypos;
-    
-    const float sensitivity = 0.1f;
-    xoffset *= sensitivity;
-    yoffset *= sensitivity;
-    
-    // 使用四元数避免万向节死锁
-    data->yaw += xoffset;
-    data->pitch += yoffset;
-    
-    // 限制俯仰角
-    if (data->pitch > 89.0f) data->pitch = 89.0f;
-    if (data->pitch < -89.0f) data->pitch = -89.0f;
-    
-    using namespace glm;
-
-    // 使用四元数计算旋转
-    quat pitchQuat = angleAxis(radians(-data->pitch), vec3(1.0f, 0.0f, 0.0f));
-    quat yawQuat = angleAxis(radians(data->yaw), vec3(0.0f, 1.0f, 0.0f));
-    quat orientation = yawQuat * pitchQuat;
-    orientation = normalize(orientation);
-    
-    // 计算摄像机方向
-    // 根据欧拉角计算前向量
-    vec3 front;
-    front.x = cos(radians(data->yaw)) * cos(radians(data->pitch));
-    front.y = sin(radians(data->pitch));
-    front.z = sin(radians(data->yaw)) * cos(radians(data->pitch));
-    data->cameraFront = normalize(front);
-
-    // 重新计算右向量和上向量
-    data->cameraRight = normalize(cross(data->cameraFront, data->worldUp));
-    data->cameraUp = normalize(cross(data->cameraRight, data->cameraFront));
-}
-
-void MainLoop::InputHandles(GLFWwindow* window) {
-    // 获取RenderData实例
-    static RenderData* data = RenderData::GetInstance();
-    static float cameraSpeed = 0.1f;
-    
-    // 处理ESC键切换鼠标捕获状态
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        // 防止重复触发
-        static double lastPressTime = 0.0;
-        double currentTime = glfwGetTime();
-        
-        if (currentTime - lastPressTime > 0.5) { // 0.5秒防抖
-            data->mouseCaptured = !data->mouseCaptured;
-            glfwSetInputMode(window, GLFW_CURSOR, 
-                data->mouseCaptured ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
-            
-            if (data->mouseCaptured) {
-                // 重新捕获鼠标时重置firstMouse标志
-                data->firstMouse = true;
-            }
-            
-            lastPressTime = currentTime;
-            std::cout << "Mouse capture: " << (data->mouseCaptured ? "ON" : "OFF") << std::endl;
-        }
-    }
-    
-    // 仅在捕获鼠标时处理移动
-    if (!data->mouseCaptured) return;
-    
-    // 相机控制 - 使用四元数计算的方向向量
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        data->cameraPos += cameraSpeed * data->cameraFront;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        data->cameraPos -= cameraSpeed * data->cameraFront;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        data->cameraPos -= cameraSpeed * data->cameraRight;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        data->cameraPos += cameraSpeed * data->cameraRight;
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
-        data->cameraPos += cameraSpeed * data->worldUp;
-    if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
-        data->cameraPos -= cameraSpeed * data->worldUp;
-}
-
 void MainLoop::BeginFrame(GLFWwindow* window) {
+    PROFILE_BEGIN_FRAME();
+
     // 清除颜色缓冲
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -133,43 +32,241 @@ void MainLoop::BeginFrame(GLFWwindow* window) {
 
 void MainLoop::EndFrame(GLFWwindow* window) {
     // 交换缓冲并处理事件
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    {
+        PROFILE_SCOPE("SwapBuffers");
+        if (s_presentEnabled) glfwSwapBuffers(window);
+    }
+    if (s_pollEvents) {
+        PROFILE_SCOPE("PollEvents");
+        glfwPollEvents();
+    }
+
+    PROFILE_END_FRAME();
 }
 
 // 渲染循环
 void MainLoop::RenderLoop(GLFWwindow* window, RenderData* data) {
     BeginFrame(window);
+
+    // 窗口拖动停止后调整渲染目标
+    data->ApplyPendingResize(glfwGetTime());
+
+    // 轮换到下一张空闲的输出图像(在途帧数达到上限时在此等待)
+    {
+        PROFILE_SCOPE("FrameFence");
+        data->pipeline->BeginFrame(*data);
+    }
+
+    // 场景动画与增量更新(只上传改动的范围, BVH自底向上refit)
+    {
+        PROFILE_SCOPE("SceneUpdate");
+        data->UpdateScene();
+    }
+
+    float time = data->time;
     
-    // 更新光源位置（动画效果）
-    float time = static_cast<float>(glfwGetTime());
-    data->lightPos = vec3(
-        3.0f * sin(time * 0.5f),
-        4.0f + sin(time * 0.7f),
-        -8.0f + cos(time * 0.5f)
-    );
-    
-    // 使用计算着色器进行光线追踪
-    glUseProgram(data->computeShaderID);
-    
-    // 设置uniform
-    glUniform3f(glGetUniformLocation(data->computeShaderID, "cameraPos"), data->cameraPos.x, data->cameraPos.y, data->cameraPos.z);
-    glUniform3f(glGetUniformLocation(data->computeShaderID, "cameraFront"), data->cameraFront.x, data->cameraFront.y, data->cameraFront.z);
-    glUniform3f(glGetUniformLocation(data->computeShaderID, "cameraRight"), data->cameraRight.x, data->cameraRight.y, data->cameraRight.z);
-    glUniform3f(glGetUniformLocation(data->computeShaderID, "cameraUp"), data->cameraUp.x, data->cameraUp.y, data->cameraUp.z);
-    glUniform1f(glGetUniformLocation(data->computeShaderID, "time"), time);
+    if (data->backend == RenderBackend::CPU) {
+        // CPU光线追踪, 结果上传到输出纹理
+        CpuCamera camera = { data->cameraPos, data->cameraFront, data->cameraRight, data->cameraUp, time,
+            data->frameIndex, data->accumulate, data->denoise };
+        bool farm = data->renderFarm && !data->accumulate && !data->denoise;   // 逐像素的累积历史与G-buffer只在本进程
+        {
+            PROFILE_SCOPE(farm ? "FarmRender" : "CpuTrace");
+            auto start = std::chrono::high_resolution_clock::now();
+            if (farm) {
+                data->renderFarm->Render(camera, data->lightPos, data->renderWidth, data->renderHeight);
+            } else {
+                data->cpuTracer->Render(camera, data->renderWidth, data->renderHeight);
+            }
+            if (data->denoise) data->cpuDenoiser->Run(*data->cpuTracer, camera, data->denoiseIterations);
+            if (data->resolution) {
+                data->resolution->AddSample(std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start).count());
+            }
+        }
+        PROFILE_GPU_SCOPE("Upload");
+        glTextureSubImage2D(data->outputTarget.texture, 0, 0, 0, data->renderWidth, data->renderHeight,
+            GL_RGBA, GL_FLOAT, (data->denoise ? data->cpuDenoiser->Pixels() : farm ? data->renderFarm->Pixels() : data->cpuTracer->Pixels()).data());
+    } else {
+        // 使用计算着色器进行光线追踪(动态分辨率按这部分GPU耗时调整)
+        if (data->resolution) data->resolution->Begin();
+        {
+            PROFILE_GPU_SCOPE("RayTrace");
+
+            // 每帧数据写入环形UBO(一次memcpy + 一次绑定)
+            FrameUniforms frame = {};
+            frame.cameraPos = data->cameraPos;     frame.time = time;
+            frame.cameraFront = data->cameraFront; frame.frameIndex = data->frameIndex;
+            frame.cameraRight = data->cameraRight; frame.numSpheres = data->scene->SphereCount();
+            frame.cameraUp = data->cameraUp;       frame.numLights = data->scene->LightCount();
+            frame.accumulate = data->accumulate && !data->temporal;   // 时域模式使用自己的历史
+            frame.renderWidth = data->renderWidth;
+            frame.renderHeight = data->renderHeight;
+            frame.denoise = data->denoise;
+            frame.temporal = data->temporal;
+            frame.jitterIndex = data->reprojection->JitterIndex();
+            frame.numTriangles = data->scene->TriangleCount();
+            data->frameUniforms->Update(&frame, UNIFORM_BINDING_FRAME);
+            data->scene->Bind();
+
+            if (data->backend == RenderBackend::Wavefront) {
+                // 波前: 多个pass, 光线经SSBO队列传递
+                data->wavefront->Render(data->renderWidth, data->renderHeight);
+            } else {
+                // 主光线的图元分块(块与下面的工作组一一对应)
+                if (data->tileBinner) {
+                    PROFILE_GPU_SCOPE("TileBinning");
+                    data->tileBinner->Run(*data);
+                }
+
+                // 分派计算着色器(工作组数随注入的工作组形状计算)
+                glUseProgram(data->computeShaderID);
+                glDispatchCompute(data->workgroup.GroupsX(data->renderWidth), data->workgroup.GroupsY(data->renderHeight), 1);
+            }
+            data->frameUniforms->Advance();
+        }
+        if (data->accumulate || data->temporal || data->denoise) {
+            // 之后以imageLoad读取追踪结果的只有时域/降噪pass与下一帧的累积(历史与G-buffer)
+            PROFILE_GPU_SCOPE("Barrier");
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+        if (data->temporal) {
+            // 与重投影的上一帧历史混合
+            PROFILE_GPU_SCOPE("Temporal");
+            data->reprojection->Run(*data);
+        }
+        if (data->denoise) {
+            // 线性颜色经à-trous滤波后色调映射写入输出目标
+            PROFILE_GPU_SCOPE("Denoise");
+            data->denoiser->Run(*data, data->denoiseIterations);
+        }
+        if (data->temporal) data->reprojection->EndFrame(*data);
+        if (data->resolution) data->resolution->End();
+
+        // 本帧输出图像之后只经纹理采样(blit)或纹理读回(基准测试、截图)访问
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+    }
+
+    // 异步捕获本帧输出(只提交读回命令, 文件写入在后台线程)
+    if (data->capture) {
+        PROFILE_SCOPE("Capture");
+        data->capture->Capture(data->outputTarget.texture, data->renderWidth, data->renderHeight);
+    }
+
+    // 累积帧数递增(相机或尺寸变化时由回调重置)
+    if (data->accumulate) data->frameIndex++;
     
-    // 分派计算着色器
-    glDispatchCompute((data->screenWidth + 15) / 16, (data->screenHeight + 15) / 16, 1);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    Blit(data);
+    data->pipeline->EndFrame();
+
+    // 根据测得的耗时调整下一帧的渲染比例
+    if (data->resolution) data->SetRenderScale(data->resolution->Update(data->renderScale));
     
-    // 渲染全屏四边形
-    glUseProgram(data->shader->s_programID);
+    EndFrame(window);    
+}
+
+void MainLoop::Present(GLFWwindow* window, RenderData* data) {
+    BeginFrame(window);
+    Blit(data);
+    EndFrame(window);
+}
+
+// 渲染全屏四边形(把渲染区域放大到整个窗口)
+void MainLoop::Blit(RenderData* data) {
+    PROFILE_GPU_SCOPE("Blit");
+    data->shader->Use();
+    data->shader->SetUniform2f("renderSize", vec2(data->renderWidth, data->renderHeight));
     glBindVertexArray(data->quadVAO);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, data->outputTexture);
+    glBindTexture(GL_TEXTURE_2D, data->outputTarget.texture);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    EndFrame(window);    
+}
+
+// 渲染线程: 持有主窗口的GL上下文, 每帧取最新快照后渲染, 不处理任何输入事件
+// 按需渲染时画面不变则跳过整帧, 阻塞到下一个快照(窗口重绘请求只重新显示上一帧)
+void MainLoop::RenderThread(GLFWwindow* window, RenderData* data, Simulation* simulation,
+    ShaderReloader* reloader, const std::atomic<bool>& running)
+{
+    glfwMakeContextCurrent(window);
+    s_pollEvents = false;   // 事件由主线程(模拟)处理
+
+    FrameSnapshot snapshot;
+    unsigned int traceRequests = 0;
+    unsigned int refreshRequests = 0;
+    DirtyTracker tracker;
+    double latencySum = 0.0, latencyMax = 0.0;
+    long long latencyCount = 0;
+
+    // 流水线: 提交到GPU完成的延迟与等待空闲输出图像的时间
+    std::vector<double> pipelineLatency, fenceWait;
+    double pipelineLatencySum = 0.0, fenceWaitSum = 0.0;
+    size_t pipelineCount = 0, fenceWaitCount = 0;
+    auto collectPipeline = [&] {
+        data->pipeline->TakeSamples(pipelineLatency, fenceWait);
+        for (double ms : pipelineLatency) pipelineLatencySum += ms;
+        for (double ms : fenceWait) fenceWaitSum += ms;
+        pipelineCount += pipelineLatency.size();
+        fenceWaitCount += fenceWait.size();
+        pipelineLatency.clear();
+        fenceWait.clear();
+    };
+
+    while (running.load(std::memory_order_acquire)) {
+        // 先等待输出图像空闲再取快照: 低延迟模式下渲染的总是GPU空闲时最新的输入
+        data->pipeline->Throttle();
+        bool fresh = simulation->Consume(snapshot);
+        if (fresh) data->ApplySnapshot(snapshot);
+
+#if ENABLE_PROFILER
+        if (snapshot.traceRequests != traceRequests) {
+            traceRequests = snapshot.traceRequests;
+            Profiler::DumpTrace("profile_trace.json");
+            Profiler::PrintSummary();
+        }
+#endif
+
+        // 在两帧之间替换重新编译的程序
+        if (reloader && reloader->Poll() > 0) tracker.Invalidate();
+
+        bool rendered = !data->idle || tracker.NeedsFrame(*data);
+        if (rendered) {
+            tracker.BeginFrame(*data);
+            RenderLoop(window, data);
+            tracker.EndFrame(*data);
+        } else if (snapshot.refreshRequests != refreshRequests) {
+            Present(window, data);
+            tracker.Presented();
+        } else {
+            double start = glfwGetTime();
+            simulation->WaitForSnapshot(kIdlePollSeconds);
+            tracker.Skipped(glfwGetTime() - start);
+        }
+        refreshRequests = snapshot.refreshRequests;
+
+        collectPipeline();
+
+        // 输入延迟: 从模拟采样输入到包含该输入的帧提交完毕
+        if (fresh && rendered) {
+            double latency = (glfwGetTime() - snapshot.sampleTime) * 1000.0;
+            latencySum += latency;
+            latencyMax = std::max(latencyMax, latency);
+            latencyCount++;
+        }
+    }
+
+    std::cout << "[SIM] 模拟步数 " << simulation->TickCount() << ", 输入到提交延迟 平均 "
+              << (latencyCount ? latencySum / latencyCount : 0.0) << " ms / 最大 " << latencyMax << " ms" << std::endl;
+    data->pipeline->Drain();
+    collectPipeline();
+    std::cout << "[PIPELINE] 在途帧数 " << data->pipeline->FramesInFlight() << ", 提交到GPU完成 平均 "
+              << (pipelineCount ? pipelineLatencySum / pipelineCount : 0.0) << " ms, 栅栏等待 平均 "
+              << (fenceWaitCount ? fenceWaitSum / fenceWaitCount : 0.0) << " ms" << std::endl;
+    if (data->idle) {
+        const IdleStats& stats = tracker.Stats();
+        std::cout << "[IDLE] 追踪 " << stats.renderedFrames << " 帧, 重新显示 " << stats.presentedFrames
+                  << " 帧, 跳过 " << stats.skippedFrames << " 帧 (阻塞等待 " << stats.idleSeconds << " s), 模拟空闲等待 "
+                  << simulation->IdleWaits() << " 次" << std::endl;
+    }
+    glfwMakeContextCurrent(NULL);
 }
 } // namespace SimpleDrawingDemo
@@ -0,0 +1,74 @@
+// src/mapped_file.cpp
+#include "pch.h"
+#include "mapped_file.h"
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace SimpleDrawingDemo {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const string& path) {
+    Close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m_file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        Close();
+        return false;
+    }
+    m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m_mapping) {
+        Close();
+        return false;
+    }
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // 映射建立后不再需要文件描述符
+    if (data == MAP_FAILED) return false;
+
+    madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    m_mapping = NULL;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data) munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,407 @@
+// src/mesh.cpp
+#include "pch.h"
+#include "mesh.h"
+#include "thread_pool.h"
+#include "defines.h"
+#include <charconv>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace SimpleDrawingDemo {
+
+namespace {
+// 缓存文件头, 其后依次为: 位置[P] 法线[N] 位置索引[3T] 法线索引[3T](仅N>0时)
+struct CacheHeader {
+    char magic[4];           // "SDMC"
+    uint32_t version;        // 文件格式版本
+    uint64_t sourceSize;     // OBJ的大小与修改时间, 不一致时重建
+    int64_t sourceTime;
+    uint32_t positionCount;
+    uint32_t normalCount;
+    uint32_t triangleCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(CacheHeader) == 40, "CacheHeader必须为40字节");
+static_assert(sizeof(vec3) == 12, "vec3必须紧凑排列才能直接映射");
+constexpr uint32_t kCacheVersion = 1;
+
+// 分块: 每个线程约4块(行长不均时靠多分块平衡负载), 小文件不必切得太碎
+constexpr int kChunksPerThread = 4;
+constexpr size_t kMinChunkBytes = 1 << 20;
+
+// 映射缓存后检查索引时每个任务处理的索引数
+constexpr size_t kIndexBatch = 1 << 16;
+
+// 单块的解析结果. 索引已转为从0开始; 负数(相对)索引先记为块内位置, 合并时再加上前面各块的数量
+struct ObjChunk {
+    std::vector<vec3> positions, normals;
+    std::vector<int> indices, normalIndices;         // 每个三角形3项, 法线缺省为-1
+    std::vector<size_t> relativeIndices;             // indices中需要加上位置偏移的下标
+    std::vector<size_t> relativeNormalIndices;
+    int skippedFaces = 0;
+};
+
+const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+bool ParseFloat(const char*& p, const char* end, float& value) {
+    p = SkipSpaces(p, end);
+    if (p < end && *p == '+') p++;   // from_chars不接受前导'+'
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+bool ParseVec3(const char*& p, const char* end, vec3& v) {
+    return ParseFloat(p, end, v.x) && ParseFloat(p, end, v.y) && ParseFloat(p, end, v.z);
+}
+
+bool ParseInt(const char*& p, const char* end, int& value) {
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+// 解析一个面顶点"v", "v/vt", "v//vn"或"v/vt/vn"(纹理坐标忽略), 法线缺省时为0
+bool ParseCorner(const char*& p, const char* end, int& position, int& normal) {
+    normal = 0;
+    if (!ParseInt(p, end, position) || position == 0) return false;
+    if (p >= end || *p != '/') return true;
+    p++;
+    int texcoord;
+    if (p < end && *p != '/') ParseInt(p, end, texcoord);
+    if (p >= end || *p != '/') return true;
+    p++;
+    return ParseInt(p, end, normal) && normal != 0;
+}
+
+// OBJ索引(从1开始, 负数为相对当前已读数量)转为从0开始; 相对索引返回块内位置并标记
+int ResolveIndex(int index, size_t localCount, bool& relative) {
+    relative = index < 0;
+    return relative ? static_cast<int>(localCount) + index : index - 1;
+}
+
+// 解析[begin, end)内的所有行(只处理v/vn/f, 其余语句忽略)
+void ParseChunk(const char* begin, const char* end, ObjChunk& chunk) {
+    struct Corner { int position, normal; bool relativePosition, relativeNormal; };
+    std::vector<Corner> corners;
+
+    const char* line = begin;
+    while (line < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (!lineEnd) lineEnd = end;
+        const char* p = SkipSpaces(line, lineEnd);
+        line = lineEnd + 1;
+        if (lineEnd - p < 2) continue;
+
+        if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            // 格式错误的顶点仍占一个索引(记为原点), 保证后续面的索引不错位
+            p += 2;
+            vec3 v(0.0f);
+            if (!ParseVec3(p, lineEnd, v)) v = vec3(0.0f);
+            chunk.positions.push_back(v);
+        } else if (p[0] == 'v' && p[1] == 'n') {
+            p += 2;
+            vec3 n(0.0f, 1.0f, 0.0f);
+            if (!ParseVec3(p, lineEnd, n)) n = vec3(0.0f, 1.0f, 0.0f);
+            chunk.normals.push_back(n);
+        } else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            p += 2;
+            corners.clear();
+            bool valid = true;
+            while (true) {
+                p = SkipSpaces(p, lineEnd);
+                if (p >= lineEnd || *p == '\r' || *p == '#') break;
+                int position, normal;
+                if (!ParseCorner(p, lineEnd, position, normal)) {
+                    valid = false;
+                    break;
+                }
+                Corner corner;
+                corner.position = ResolveIndex(position, chunk.positions.size(), corner.relativePosition);
+                corner.normal = normal != 0 ? ResolveIndex(normal, chunk.normals.size(), corner.relativeNormal) : -1;
+                if (normal == 0) corner.relativeNormal = false;
+                corners.push_back(corner);
+            }
+            if (!valid || corners.size() < 3) {
+                chunk.skippedFaces++;
+                continue;
+            }
+
+            // 多边形按扇形拆成三角形
+            for (size_t k = 1; k + 1 < corners.size(); k++) {
+                for (const Corner& c : { corners[0], corners[k], corners[k + 1] }) {
+                    if (c.relativePosition) chunk.relativeIndices.push_back(chunk.indices.size());
+                    if (c.relativeNormal) chunk.relativeNormalIndices.push_back(chunk.normalIndices.size());
+                    chunk.indices.push_back(c.position);
+                    chunk.normalIndices.push_back(c.normal);
+                }
+            }
+        }
+    }
+}
+
+// FNV-1a 64位哈希(缓存文件名)
+uint64_t HashPath(const string& text) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+string CachePathOf(const string& path) {
+    std::error_code error;
+    fs::path absolute = fs::absolute(path, error).lexically_normal();
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.smesh",
+        static_cast<unsigned long long>(HashPath(absolute.generic_string())));
+    return MESH_CACHE_PATH + string(name);
+}
+
+double MillisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+}
+
+nlohmann::json MeshLoadStats::ToJson() const {
+    nlohmann::json json;
+    json["path"] = path;
+    json["from_cache"] = fromCache;
+    json["triangles"] = triangleCount;
+    json["parse_ms"] = parseMs;
+    json["load_ms"] = loadMs;
+    json["convert_ms"] = convertMs;
+    return json;
+}
+
+bool Mesh::Load(const string& path, ThreadPool* pool) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_stats = MeshLoadStats();
+    m_stats.path = path;
+
+    std::error_code error;
+    uint64_t sourceSize = fs::file_size(path, error);
+    if (error) {
+        std::cerr << "[ERROR_MESH] 无法打开网格文件: " << path << std::endl;
+        return false;
+    }
+    int64_t sourceTime = static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count());
+
+    string cachePath = CachePathOf(path);
+    ThreadPool& threads = pool ? *pool : ThreadPool::Shared();
+    if (MapCache(cachePath, sourceSize, sourceTime, threads)) {
+        m_stats.fromCache = true;
+    } else {
+        auto parseStart = std::chrono::high_resolution_clock::now();
+        if (!ParseObj(path, threads)) return false;
+        m_stats.parseMs = MillisecondsSince(parseStart);
+        WriteCache(cachePath, sourceSize, sourceTime);
+        PointToParsed();
+    }
+
+    m_stats.triangleCount = static_cast<int>(m_triangleCount);
+    m_stats.loadMs = MillisecondsSince(startTime);
+    std::cout << "[MESH] 已加载 " << path << ": " << m_triangleCount << " 个三角形, "
+              << (m_stats.fromCache ? "映射缓存 " : "解析OBJ ") << m_stats.loadMs << " ms" << std::endl;
+    return true;
+}
+
+bool Mesh::ParseObj(const string& path, ThreadPool& pool) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        std::cerr << "[ERROR_MESH] 无法读取网格文件: " << path << std::endl;
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(file.Data());
+    size_t size = file.Size();
+
+    // 按字节均分后, 每个分界点推进到下一行行首
+    int chunkCount = static_cast<int>(std::clamp<size_t>(size / kMinChunkBytes, 1,
+        static_cast<size_t>(pool.ThreadCount() * kChunksPerThread)));
+    std::vector<size_t> bounds(chunkCount + 1);
+    bounds[0] = 0;
+    bounds[chunkCount] = size;
+    for (int i = 1; i < chunkCount; i++) {
+        size_t pos = std::max(size * i / chunkCount, bounds[i - 1]);
+        const void* newline = pos < size ? std::memchr(data + pos, '\n', size - pos) : nullptr;
+        bounds[i] = newline ? static_cast<const char*>(newline) - data + 1 : size;
+    }
+
+    std::vector<ObjChunk> chunks(chunkCount);
+    pool.ParallelFor(chunkCount, [&](int i) {
+        ParseChunk(data + bounds[i], data + bounds[i + 1], chunks[i]);
+    });
+
+    // 各块在合并结果中的起始位置
+    std::vector<size_t> positionBase(chunkCount + 1, 0), normalBase(chunkCount + 1, 0), indexBase(chunkCount + 1, 0);
+    int skippedFaces = 0;
+    for (int i = 0; i < chunkCount; i++) {
+        positionBase[i + 1] = positionBase[i] + chunks[i].positions.size();
+        normalBase[i + 1] = normalBase[i] + chunks[i].normals.size();
+        indexBase[i + 1] = indexBase[i] + chunks[i].indices.size();
+        skippedFaces += chunks[i].skippedFaces;
+    }
+    size_t positionCount = positionBase[chunkCount], normalCount = normalBase[chunkCount];
+    size_t indexCount = indexBase[chunkCount];
+    if (positionCount > 0xfffffff0u || indexCount / 3 > 0x7fffffffu) {
+        std::cerr << "[ERROR_MESH] 网格过大: " << path << std::endl;
+        return false;
+    }
+
+    m_parsedPositions.resize(positionCount);
+    m_parsedNormals.resize(normalCount);
+    m_parsedIndices.resize(indexCount);
+    m_parsedNormalIndices.resize(normalCount > 0 ? indexCount : 0);
+
+    // 并行合并: 修正相对索引, 检查越界, 拷贝到连续数组
+    std::atomic<bool> outOfRange{ false };
+    pool.ParallelFor(chunkCount, [&](int i) {
+        ObjChunk& chunk = chunks[i];
+        for (size_t slot : chunk.relativeIndices) chunk.indices[slot] += static_cast<int>(positionBase[i]);
+        for (size_t slot : chunk.relativeNormalIndices) chunk.normalIndices[slot] += static_cast<int>(normalBase[i]);
+
+        std::copy(chunk.positions.begin(), chunk.positions.end(), m_parsedPositions.begin() + positionBase[i]);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), m_parsedNormals.begin() + normalBase[i]);
+        for (size_t k = 0; k < chunk.indices.size(); k++) {
+            int index = chunk.indices[k];
+            if (index < 0 || static_cast<size_t>(index) >= positionCount) outOfRange = true;
+            m_parsedIndices[indexBase[i] + k] = static_cast<uint32_t>(index);
+
+            if (normalCount == 0) continue;
+            int normal = chunk.normalIndices[k];
+            if (normal >= 0 && static_cast<size_t>(normal) >= normalCount) outOfRange = true;
+            m_parsedNormalIndices[indexBase[i] + k] = normal >= 0 ? static_cast<uint32_t>(normal) : kNoNormal;
+        }
+        chunk = ObjChunk();   // 尽早释放块内存
+    });
+
+    if (outOfRange) {
+        std::cerr << "[ERROR_MESH] 网格文件中的面索引越界: " << path << std::endl;
+        return false;
+    }
+    if (skippedFaces > 0) {
+        std::cerr << "[MESH] 跳过 " << skippedFaces << " 个无效的面: " << path << std::endl;
+    }
+    return true;
+}
+
+bool Mesh::MapCache(const string& cachePath, uint64_t sourceSize, int64_t sourceTime, ThreadPool& pool) {
+    if (!m_cache.Open(cachePath)) return false;
+
+    CacheHeader header;
+    bool valid = m_cache.Size() >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, m_cache.Data(), sizeof(header));
+        valid = std::memcmp(header.magic, "SDMC", 4) == 0 && header.version == kCacheVersion
+            && header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+    }
+    if (valid) {
+        uint64_t triangles = header.triangleCount;
+        uint64_t expected = sizeof(header) + (uint64_t(header.positionCount) + header.normalCount) * sizeof(vec3)
+            + triangles * 3 * sizeof(uint32_t) * (header.normalCount > 0 ? 2 : 1);
+        valid = m_cache.Size() == expected;
+    }
+    if (!valid) {
+        m_cache.Close();
+        return false;
+    }
+
+    // 各段都是4字节的整数倍, 映射起点按页对齐, 可以直接作为数组访问
+    const unsigned char* p = m_cache.Data() + sizeof(header);
+    m_positions = reinterpret_cast<const vec3*>(p);
+    p += size_t(header.positionCount) * sizeof(vec3);
+    m_normals = header.normalCount > 0 ? reinterpret_cast<const vec3*>(p) : nullptr;
+    p += size_t(header.normalCount) * sizeof(vec3);
+    m_indices = reinterpret_cast<const uint32_t*>(p);
+    p += size_t(header.triangleCount) * 3 * sizeof(uint32_t);
+    m_normalIndices = header.normalCount > 0 ? reinterpret_cast<const uint32_t*>(p) : nullptr;
+    m_positionCount = header.positionCount;
+    m_normalCount = header.normalCount;
+    m_triangleCount = header.triangleCount;
+
+    // 索引同样检查越界(与ParseObj一致): 损坏的缓存按未命中处理, 重新解析OBJ
+    if (!IndicesInRange(pool)) {
+        std::cerr << "[MESH] 网格缓存中的索引越界, 重新解析: " << cachePath << std::endl;
+        m_cache.Close();
+        m_positions = m_normals = nullptr;
+        m_indices = m_normalIndices = nullptr;
+        m_positionCount = m_normalCount = m_triangleCount = 0;
+        return false;
+    }
+    return true;
+}
+
+bool Mesh::IndicesInRange(ThreadPool& pool) const {
+    size_t indexCount = size_t(m_triangleCount) * 3;
+    int batches = static_cast<int>((indexCount + kIndexBatch - 1) / kIndexBatch);
+    std::atomic<bool> outOfRange{ false };
+    pool.ParallelFor(batches, [&](int batch) {
+        size_t end = std::min(indexCount, (size_t(batch) + 1) * kIndexBatch);
+        for (size_t k = size_t(batch) * kIndexBatch; k < end; k++) {
+            if (m_indices[k] >= m_positionCount) outOfRange = true;
+            if (m_normalIndices && m_normalIndices[k] >= m_normalCount && m_normalIndices[k] != kNoNormal) outOfRange = true;
+        }
+    });
+    return !outOfRange;
+}
+
+void Mesh::WriteCache(const string& cachePath, uint64_t sourceSize, int64_t sourceTime) const {
+    std::error_code error;
+    fs::create_directories(fs::path(cachePath).parent_path(), error);
+
+    // 先写临时文件再改名, 中途退出不会留下不完整的缓存
+    string tempPath = cachePath + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "[ERROR_MESH] 无法写入网格缓存: " << cachePath << std::endl;
+        return;
+    }
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, "SDMC", 4);
+    header.version = kCacheVersion;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.positionCount = static_cast<uint32_t>(m_parsedPositions.size());
+    header.normalCount = static_cast<uint32_t>(m_parsedNormals.size());
+    header.triangleCount = static_cast<uint32_t>(m_parsedIndices.size() / 3);
+
+    auto write = [&](const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+    write(&header, sizeof(header));
+    write(m_parsedPositions.data(), m_parsedPositions.size() * sizeof(vec3));
+    write(m_parsedNormals.data(), m_parsedNormals.size() * sizeof(vec3));
+    write(m_parsedIndices.data(), m_parsedIndices.size() * sizeof(uint32_t));
+    write(m_parsedNormalIndices.data(), m_parsedNormalIndices.size() * sizeof(uint32_t));
+    file.close();
+
+    if (!file) {
+        std::cerr << "[ERROR_MESH] 网格缓存写入失败: " << cachePath << std::endl;
+        fs::remove(tempPath, error);
+        return;
+    }
+    fs::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cerr << "[ERROR_MESH] 网格缓存写入失败: " << cachePath << std::endl;
+        fs::remove(tempPath, error);
+    }
+}
+
+void Mesh::PointToParsed() {
+    m_positions = m_parsedPositions.data();
+    m_normals = m_parsedNormals.empty() ? nullptr : m_parsedNormals.data();
+    m_indices = m_parsedIndices.data();
+    m_normalIndices = m_parsedNormalIndices.empty() ? nullptr : m_parsedNormalIndices.data();
+    m_positionCount = static_cast<uint32_t>(m_parsedPositions.size());
+    m_normalCount = static_cast<uint32_t>(m_parsedNormals.size());
+    m_triangleCount = static_cast<uint32_t>(m_parsedIndices.size() / 3);
+}
+}   // namespace SimpleDrawingDemo
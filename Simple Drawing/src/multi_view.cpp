@@ -0,0 +1,106 @@
+// src/multi_view.cpp
+#include "pch.h"
+#include "multi_view.h"
+#include "render_data.h"
+#include "scene.h"
+#include "shader.h"
+#include "defines.h"
+#include "uniform_ring.h"
+#include "frame_uniforms.h"
+
+namespace SimpleDrawingDemo {
+
+MultiViewRenderer::MultiViewRenderer(const RenderData& data)
+    : m_format(data.outputFormat), m_workgroup(data.workgroup)
+{
+    m_program = Shader::CreateComputeShader(CSH_PATH + string("ray_tracing.glsl"),
+        data.ComputeDefines() + m_workgroup.Defines() + Defines());
+}
+
+MultiViewRenderer::~MultiViewRenderer() {
+    if (m_program) glDeleteProgram(m_program);
+    if (m_texture) glDeleteTextures(1, &m_texture);
+    if (m_viewBuffer) glDeleteBuffers(1, &m_viewBuffer);
+}
+
+string MultiViewRenderer::Defines() {
+    return "#define MULTI_VIEW\n";
+}
+
+size_t MultiViewRenderer::AllocatedBytes() const {
+    return static_cast<size_t>(m_width) * m_height * m_layers * FormatInfo(m_format).bytesPerPixel;
+}
+
+// 纹理数组只增不减(视图数或视口变小时直接复用)
+void MultiViewRenderer::Reserve(int width, int height, int layers) {
+    if (width <= m_width && height <= m_height && layers <= m_layers) return;
+    if (m_texture) glDeleteTextures(1, &m_texture);
+    m_width = std::max(width, m_width);
+    m_height = std::max(height, m_height);
+    m_layers = std::max(layers, m_layers);
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_texture);
+    glTextureStorage3D(m_texture, 1, FormatInfo(m_format).internalFormat, m_width, m_height, m_layers);
+    glTextureParameteri(m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+    std::cout << "[MULTI_VIEW] " << m_width << "x" << m_height << " x " << m_layers << " 层 ("
+              << FormatInfo(m_format).name << "), 显存 " << AllocatedBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+void MultiViewRenderer::Render(RenderData& data, const std::vector<ViewCamera>& views) {
+    m_views = views;
+    if (views.empty()) return;
+
+    // 层尺寸覆盖全部视口
+    int width = 0, height = 0;
+    std::vector<ViewData> packed(views.size());
+    for (size_t i = 0; i < views.size(); i++) {
+        const ViewCamera& view = views[i];
+        width = std::max(width, view.x + view.width);
+        height = std::max(height, view.y + view.height);
+        packed[i] = { vec4(view.pos, 0.0f), vec4(view.front, 0.0f), vec4(view.right, 0.0f), vec4(view.up, 0.0f),
+            { view.x, view.y, view.width, view.height } };
+    }
+    Reserve(width, height, static_cast<int>(views.size()));
+
+    if (views.size() > m_viewCapacity) {
+        if (m_viewBuffer) glDeleteBuffers(1, &m_viewBuffer);
+        m_viewCapacity = views.size();
+        glCreateBuffers(1, &m_viewBuffer);
+        glNamedBufferStorage(m_viewBuffer, m_viewCapacity * sizeof(ViewData), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+    glNamedBufferSubData(m_viewBuffer, 0, packed.size() * sizeof(ViewData), packed.data());
+
+    // 帧数据只用到场景规模与时间(相机来自视图数组, 不累积、不输出G-buffer)
+    FrameUniforms frame = {};
+    frame.time = data.time;
+    frame.numSpheres = data.scene->SphereCount();
+    frame.numLights = data.scene->LightCount();
+    frame.renderWidth = width;
+    frame.renderHeight = height;
+    frame.numTriangles = data.scene->TriangleCount();
+    data.frameUniforms->Update(&frame, UNIFORM_BINDING_FRAME);
+    data.scene->Bind();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MULTI_VIEW_BINDING_VIEWS, m_viewBuffer);
+
+    // 整个纹理数组绑定到输出的图像单元(layered), 一次分派覆盖全部视图
+    glBindImageTexture(0, m_texture, 0, GL_TRUE, 0, GL_WRITE_ONLY, FormatInfo(m_format).internalFormat);
+    glUseProgram(m_program);
+    glDispatchCompute(m_workgroup.GroupsX(width), m_workgroup.GroupsY(height), static_cast<unsigned int>(views.size()));
+    data.frameUniforms->Advance();
+
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+    glBindImageTexture(0, data.outputTarget.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, FormatInfo(data.outputFormat).internalFormat);
+}
+
+std::vector<float> MultiViewRenderer::ReadView(int view) const {
+    const ViewCamera& camera = m_views[view];
+    std::vector<float> pixels(static_cast<size_t>(camera.width) * camera.height * 4);
+    glGetTextureSubImage(m_texture, 0, camera.x, camera.y, view, camera.width, camera.height, 1, GL_RGBA, GL_FLOAT,
+        static_cast<int>(pixels.size() * sizeof(float)), pixels.data());
+    return pixels;
+}
+}   // namespace SimpleDrawingDemo
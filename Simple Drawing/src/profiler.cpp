@@ -0,0 +1,277 @@
+// src/profiler.cpp
+#include "pch.h"
+#include "profiler.h"
+
+#if ENABLE_PROFILER
+#include "benchmark.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+struct TraceEvent {
+    const char* name;
+    double startUs, durationUs;
+    uint32_t thread;     // 0为GPU时间线
+};
+
+struct GpuQuery {
+    const char* name;
+    unsigned int begin, end;
+};
+
+// 一帧的GPU时间戳查询(查询对象跨帧复用)
+struct GpuFrame {
+    std::vector<GpuQuery> zones;
+    std::vector<unsigned int> pool;
+};
+
+// 固定容量的滚动样本
+struct RollingSamples {
+    std::vector<double> samples;
+    size_t next = 0;
+
+    void Add(double value) {
+        if (samples.size() < Profiler::kHistorySize) {
+            samples.push_back(value);
+        } else {
+            samples[next] = value;
+            next = (next + 1) % samples.size();
+        }
+    }
+};
+
+struct PassHistory {
+    RollingSamples cpu, gpu;
+};
+
+struct State {
+    std::mutex mutex;    // CPU区间可能来自工作线程
+    std::deque<TraceEvent> events;
+    std::map<string, PassHistory> passes;
+
+    // 以下只在GL线程访问
+    std::array<GpuFrame, Profiler::kFrameLatency> gpuFrames;
+    unsigned long long frame = 0;
+    double frameStartUs = 0.0;
+    double gpuOffsetUs = 0.0;   // GPU时间戳 -> CPU时钟
+    bool calibrated = false;
+    int droppedFrames = 0;      // 读回时结果仍未就绪而丢弃的帧数
+};
+
+State& GetState() {
+    static State state;
+    return state;
+}
+
+uint32_t ThreadId() {
+    static std::atomic<uint32_t> counter{ 0 };
+    thread_local uint32_t id = ++counter;
+    return id;
+}
+
+void PushEvent(State& state, const TraceEvent& event) {
+    if (state.events.size() >= Profiler::kMaxTraceEvents) state.events.pop_front();
+    state.events.push_back(event);
+}
+
+// 耗时分布: 以2为底的对数分桶, 上界从1/64 ms到64 ms, 最后一桶为溢出
+constexpr int kHistogramBuckets = 14;
+
+double BucketBound(int bucket) {
+    return std::ldexp(1.0, bucket - 6);
+}
+
+std::array<int, kHistogramBuckets> Histogram(const std::vector<double>& samples) {
+    std::array<int, kHistogramBuckets> buckets = {};
+    for (double ms : samples) {
+        int bucket = 0;
+        while (bucket < kHistogramBuckets - 1 && ms >= BucketBound(bucket)) bucket++;
+        buckets[bucket]++;
+    }
+    return buckets;
+}
+
+nlohmann::json HistogramJson(const std::vector<double>& samples) {
+    nlohmann::json result = nlohmann::json::array();
+    auto buckets = Histogram(samples);
+    for (int i = 0; i < kHistogramBuckets; i++) {
+        nlohmann::json bucket;
+        bucket["le_ms"] = i < kHistogramBuckets - 1 ? BucketBound(i) : -1.0;   // -1表示无上界
+        bucket["count"] = buckets[i];
+        result.push_back(bucket);
+    }
+    return result;
+}
+}
+
+double Profiler::NowUs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::RecordCpu(const char* name, double startUs, double endUs) {
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    PushEvent(state, { name, startUs, endUs - startUs, ThreadId() });
+    state.passes[name].cpu.Add((endUs - startUs) / 1000.0);
+}
+
+void Profiler::BeginFrame() {
+    State& state = GetState();
+    state.frameStartUs = NowUs();
+
+    // 一次性校准GPU与CPU时钟的偏移
+    if (!state.calibrated) {
+        GLint64 gpuNs = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNs);
+        state.gpuOffsetUs = NowUs() - gpuNs / 1000.0;
+        state.calibrated = true;
+    }
+
+    // 读回kFrameLatency帧前的查询; 未就绪则丢弃, 绝不阻塞
+    GpuFrame& slot = state.gpuFrames[state.frame % kFrameLatency];
+    if (slot.zones.empty()) return;
+
+    GLint available = 0;
+    glGetQueryObjectiv(slot.zones.back().end, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (const GpuQuery& zone : slot.zones) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(zone.begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(zone.end, GL_QUERY_RESULT, &end);
+            double durationUs = (end - begin) / 1000.0;
+            PushEvent(state, { zone.name, begin / 1000.0 + state.gpuOffsetUs, durationUs, 0 });
+            state.passes[zone.name].gpu.Add(durationUs / 1000.0);
+        }
+    } else {
+        state.droppedFrames++;
+    }
+    slot.zones.clear();
+}
+
+void Profiler::EndFrame() {
+    State& state = GetState();
+    RecordCpu("Frame", state.frameStartUs, NowUs());
+    state.frame++;
+}
+
+// 区间不能跨越帧边界
+int Profiler::BeginGpu(const char* name) {
+    GpuFrame& slot = GetState().gpuFrames[GetState().frame % kFrameLatency];
+    size_t used = slot.zones.size() * 2;
+    if (used + 2 > slot.pool.size()) {
+        slot.pool.resize(used + 2);
+        glGenQueries(2, &slot.pool[used]);
+    }
+    slot.zones.push_back({ name, slot.pool[used], slot.pool[used + 1] });
+    glQueryCounter(slot.pool[used], GL_TIMESTAMP);
+    return static_cast<int>(slot.zones.size()) - 1;
+}
+
+void Profiler::EndGpu(int zone) {
+    GpuFrame& slot = GetState().gpuFrames[GetState().frame % kFrameLatency];
+    glQueryCounter(slot.zones[zone].end, GL_TIMESTAMP);
+}
+
+bool Profiler::DumpTrace(const string& path) {
+    State& state = GetState();
+    nlohmann::json events = nlohmann::json::array();
+    std::unordered_set<uint32_t> threads;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (const TraceEvent& event : state.events) {
+            nlohmann::json entry;
+            entry["name"] = event.name;
+            entry["cat"] = event.thread == 0 ? "gpu" : "cpu";
+            entry["ph"] = "X";
+            entry["ts"] = event.startUs;
+            entry["dur"] = event.durationUs;
+            entry["pid"] = 1;
+            entry["tid"] = event.thread;
+            events.push_back(entry);
+            threads.insert(event.thread);
+        }
+    }
+
+    // 线程名称元数据
+    for (uint32_t thread : threads) {
+        nlohmann::json meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = 1;
+        meta["tid"] = thread;
+        meta["args"]["name"] = thread == 0 ? string("GPU") : "CPU " + std::to_string(thread);
+        events.push_back(meta);
+    }
+
+    nlohmann::json trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+
+    std::ofstream file(path);
+    file << trace.dump();
+    if (!file) {
+        std::cerr << "[ERROR_PROFILE] trace写入失败: " << path << std::endl;
+        return false;
+    }
+    std::cout << "[PROFILE] trace已写入: " << path << " (" << events.size() << " 个事件)" << std::endl;
+    return true;
+}
+
+void Profiler::PrintSummary() {
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    auto printHistogram = [](const char* label, const std::vector<double>& samples) {
+        auto buckets = Histogram(samples);
+        std::cout << "    " << label << "分布:";
+        for (int i = 0; i < kHistogramBuckets; i++) {
+            if (!buckets[i]) continue;
+            if (i < kHistogramBuckets - 1) std::cout << " <" << BucketBound(i) << "ms:" << buckets[i];
+            else std::cout << " >=" << BucketBound(i - 1) << "ms:" << buckets[i];
+        }
+        std::cout << std::endl;
+    };
+
+    std::cout << "[PROFILE] 最近" << kHistorySize << "个样本 (GPU丢弃帧 " << state.droppedFrames << ")" << std::endl;
+    for (const auto& [name, history] : state.passes) {
+        FrameStats cpu = FrameStats::From(history.cpu.samples);
+        FrameStats gpu = FrameStats::From(history.gpu.samples);
+        std::cout << "  " << name << ": CPU 中位 " << cpu.median << " ms, p99 " << cpu.p99 << " ms";
+        if (gpu.count) std::cout << " | GPU 中位 " << gpu.median << " ms, p99 " << gpu.p99 << " ms";
+        std::cout << std::endl;
+        if (cpu.count) printHistogram("CPU", history.cpu.samples);
+        if (gpu.count) printHistogram("GPU", history.gpu.samples);
+    }
+}
+
+nlohmann::json Profiler::ToJson() {
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    nlohmann::json result;
+    for (const auto& [name, history] : state.passes) {
+        nlohmann::json pass;
+        pass["cpu_ms"] = FrameStats::From(history.cpu.samples).ToJson();
+        pass["cpu_histogram"] = HistogramJson(history.cpu.samples);
+        if (!history.gpu.samples.empty()) {
+            pass["gpu_ms"] = FrameStats::From(history.gpu.samples).ToJson();
+            pass["gpu_histogram"] = HistogramJson(history.gpu.samples);
+        }
+        result["passes"][name] = pass;
+    }
+    result["dropped_gpu_frames"] = state.droppedFrames;
+    return result;
+}
+
+void Profiler::Release() {
+    for (GpuFrame& slot : GetState().gpuFrames) {
+        if (!slot.pool.empty()) glDeleteQueries(static_cast<GLsizei>(slot.pool.size()), slot.pool.data());
+        slot.pool.clear();
+        slot.zones.clear();
+    }
+}
+}   // namespace SimpleDrawingDemo
+
+#endif
@@ -3,6 +3,23 @@
 #include "render_data.h"
 #include "shader.h"
 #include "defines.h"
+#include "cpu_tracer.h"
+#include "scene.h"
+#include "uniform_ring.h"
+#include "frame_uniforms.h"
+#include "shader_cache.h"
+#include "resolution_controller.h"
+#include "frame_capture.h"
+#include "simulation.h"
+#include "wavefront_tracer.h"
+#include "denoiser.h"
+#include "temporal_reprojection.h"
+#include "tile_binner.h"
+#include "staging_buffer.h"
+#include "scene_animator.h"
+#include "render_farm.h"
+#include "multi_view.h"
+#include "frame_pipeline.h"
 
 namespace SimpleDrawingDemo {
 
@@ -10,25 +27,53 @@ namespace SimpleDrawingDemo {
 RenderData* RenderData::instance = nullptr;
 
 RenderData::RenderData() 
-    : shader(new Shader()), screenWidth(1920), screenHeight(1080),
+    : shader(new Shader()), scene(new Scene()), screenWidth(1920), screenHeight(1080),
       cameraPos(0.0f, 0.0f, 3.0f), cameraFront(0.0f, 0.0f, -1.0f), cameraUp(0.0f, 1.0f, 0.0f),
-      outputTexture(0), quadVAO(0), quadVBO(0), computeShaderID(0) 
+      quadVAO(0), quadVBO(0), computeShaderID(0) 
 {
+    // 默认场景
+    scene->LoadDefault();
+
     // 初始化顶点数组（空）
     vertices = nullptr;
     segments = 0;
 }
 
 RenderData::~RenderData() {
-    // 删除光线追踪资源
-    glDeleteTextures(1, &outputTexture);
-    glDeleteVertexArrays(1, &quadVAO);
-    glDeleteBuffers(1, &quadVBO);
-    glDeleteProgram(computeShaderID);
+    // 删除光线追踪资源(纯CPU模式下未创建任何GL对象)
+    if (quadVAO) {
+        delete capture;     // 等待在途帧写完
+        delete wavefront;
+        delete tileBinner;
+        delete multiView;
+        delete staging;
+        delete denoiser;
+        reprojection->Release(*targetPool);
+        delete reprojection;
+        pipeline->Release(*targetPool);
+        delete pipeline;
+        targetPool->Release(outputTarget);
+        targetPool->Release(historyTarget);
+        for (RenderTarget* target : { &gbufferNormalDepth, &gbufferAlbedoId, &noisyTarget, &denoiseTargets[0], &denoiseTargets[1] }) {
+            targetPool->Release(*target);
+        }
+        delete targetPool;
+        glDeleteVertexArrays(1, &quadVAO);
+        glDeleteBuffers(1, &quadVBO);
+        glDeleteProgram(computeShaderID);
+        if (blueNoiseBuffer) glDeleteBuffers(1, &blueNoiseBuffer);
+        delete frameUniforms;
+    }
+    delete animator;
+    delete resolution;
+    delete cpuDenoiser;
+    delete cpuTracer;
+    delete renderFarm;
+    delete scene;
     
     // 删除着色器程序
     if (shader) {
-        glDeleteProgram(shader->s_programID);
+        if (shader->s_programID) glDeleteProgram(shader->s_programID);
         delete shader;
     }
     
@@ -41,18 +86,22 @@ RenderData::~RenderData() {
 // 初始化光线追踪资源
 void RenderData::InitRayTracingResources() {
     // 创建计算着色器
-    computeShaderID = Shader::CreateComputeShader(CSH_PATH + string("ray_tracing.glsl"));
+    if (sampler == SamplerType::BlueNoise) SetSampler(sampler, samplerScramble);
+    computeShaderID = Shader::CreateComputeShader(CSH_PATH + string("ray_tracing.glsl"), TraceDefines());
+    ReflectComputeShader();
+    if (tileBinning) tileBinner = new TileBinner(ComputeDefines() + TileBinner::Defines());
+    denoiser = new Denoiser(ComputeDefines());
+    reprojection = new TemporalReprojection(ComputeDefines());
+    frameUniforms = new UniformRing(sizeof(FrameUniforms));
+
+    // 上传场景数据(之后的改动经暂存缓冲增量上传)
+    scene->Upload();
+    staging = new StagingBuffer(1 << 20);
     
-    // 创建输出纹理
-    glGenTextures(1, &outputTexture);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, outputTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, screenWidth, screenHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
-    glBindImageTexture(0, outputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+    // 创建输出纹理与累积历史纹理
+    targetPool = new RenderTargetPool();
+    ResizeRenderTargets();
+    pipeline = new FramePipeline(*this, framesInFlight);
     
     // 创建全屏四边形
     float quadVertices[] = {
@@ -84,9 +133,211 @@ void RenderData::InitRayTracingResources() {
         shader_paths.gsh_path, shader_paths.csh_path
     );
     
+    shader->Reflect();
+
     // 设置纹理采样器
-    glUseProgram(shader->s_programID);
-    glUniform1i(glGetUniformLocation(shader->s_programID, "screenTexture"), 0);
+    shader->Use();
+    shader->SetUniform1i("screenTexture", 0);
+
+    const ShaderCacheStats& stats = ShaderCache::s_stats;
+    std::cout << "[SHADER_CACHE] 命中 " << stats.hits << ", 未命中 " << stats.misses
+              << ", 拒绝 " << stats.rejected << ", 编译 " << stats.compileMs << " ms, 加载 "
+              << stats.loadMs << " ms" << std::endl;
+}
+
+// 反射计算着色器(初始化与热重载后调用)
+void RenderData::ReflectComputeShader() {
+    computeReflection = Shader::Reflect(computeShaderID);
+
+    // 校验FrameData块与CPU端结构体布局一致
+    const BlockInfo* frameBlock = computeReflection.UniformBlock("FrameData");
+    if (!frameBlock || frameBlock->dataSize != sizeof(FrameUniforms) || frameBlock->binding != UNIFORM_BINDING_FRAME) {
+        std::cerr << "[ERROR_SHADER] FrameData块与FrameUniforms布局不一致" << std::endl;
+    }
+}
+
+// 按当前的工作组形状与宏重新构建单内核程序(各变体分别进入程序二进制缓存)
+void RenderData::RebuildComputeShader() {
+    glDeleteProgram(computeShaderID);
+    computeShaderID = Shader::CreateComputeShader(CSH_PATH + string("ray_tracing.glsl"), TraceDefines());
+    ReflectComputeShader();
+    ResetAccumulation();
+}
+
+// 计算着色器的公共宏: 格式(image格式限定符需与渲染目标一致)、反弹次数与采样序列
+string RenderData::ComputeDefines() const {
+    return string("#define OUTPUT_FORMAT ") + FormatInfo(outputFormat).glslFormat + "\n"
+         + "#define HISTORY_FORMAT " + FormatInfo(historyFormat).glslFormat + "\n"
+         + "#define MAX_BOUNCES " + std::to_string(maxBounces) + "\n"
+         + Sampler::Defines(sampler, samplerScramble);
+}
+
+// 单内核的宏: 公共宏 + 工作组形状 + 分块求交开关
+string RenderData::TraceDefines() const {
+    return ComputeDefines() + workgroup.Defines() + (tileBinning ? TileBinner::Defines() : "");
+}
+
+// 确保渲染目标能容纳当前屏幕尺寸; 仍在同一尺寸桶内时不做任何分配
+void RenderData::ResizeRenderTargets() {
+    int bucketWidth = RenderTargetPool::Bucket(screenWidth);
+    int bucketHeight = RenderTargetPool::Bucket(screenHeight);
+    if (outputTarget.width != bucketWidth || outputTarget.height != bucketHeight) {
+        targetPool->Reacquire(outputTarget, outputFormat, screenWidth, screenHeight);
+        targetPool->Reacquire(historyTarget, historyFormat, screenWidth, screenHeight);
+
+        glBindImageTexture(0, outputTarget.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, FormatInfo(outputFormat).internalFormat);
+        glBindImageTexture(1, historyTarget.texture, 0, GL_FALSE, 0, GL_READ_WRITE, FormatInfo(historyFormat).internalFormat);
+        if (pipeline) pipeline->Resize(*this);
+        if (gbufferNormalDepth.texture) ResizeAuxTargets();
+
+        std::cout << "[TARGETS] " << outputTarget.width << "x" << outputTarget.height << " ("
+                  << FormatInfo(outputFormat).name << " + " << FormatInfo(historyFormat).name << "), 显存 "
+                  << targetPool->AllocatedBytes() / (1024.0 * 1024.0) << " MB, 累计新建 " << targetPool->CreatedCount()
+                  << " / 复用 " << targetPool->ReusedCount() << std::endl;
+    }
+    SetRenderScale(renderScale);
+    ResetAccumulation();
+}
+
+// 附加目标与输出目标同一尺寸桶: G-buffer与线性颜色(降噪/时域共用)总是分配,
+// 降噪乒乓目标与时域历史只在对应功能开启过之后分配. G-buffer固定为rgba32f(深度与图元ID需要完整精度)
+void RenderData::ResizeAuxTargets() {
+    auto reacquire = [this](RenderTarget& target, TargetFormat format) {
+        targetPool->Reacquire(target, format, outputTarget.width, outputTarget.height);
+    };
+    reacquire(gbufferNormalDepth, TargetFormat::RGBA32F);
+    reacquire(gbufferAlbedoId, TargetFormat::RGBA32F);
+    reacquire(noisyTarget, TargetFormat::RGBA16F);
+    if (denoise || denoiseTargets[0].texture) {
+        for (RenderTarget& target : denoiseTargets) reacquire(target, TargetFormat::RGBA16F);
+    }
+    if (temporal || reprojection->Allocated()) {
+        reprojection->Resize(*targetPool, outputTarget.width, outputTarget.height);
+    }
+
+    BindGBuffer();
+    glBindImageTexture(4, noisyTarget.texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+
+    std::cout << "[TARGETS] 附加目标 " << outputTarget.width << "x" << outputTarget.height << ", 显存 "
+              << targetPool->AllocatedBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+// 本帧G-buffer的图像单元(时域模式下每帧与上一帧交换后重新绑定; 单元5~7由各pass自行绑定)
+void RenderData::BindGBuffer() {
+    glBindImageTexture(2, gbufferNormalDepth.texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    glBindImageTexture(3, gbufferAlbedoId.texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+}
+
+// 开关降噪(渲染线程调用); GPU后端首次开启时分配目标
+void RenderData::SetDenoise(bool enabled) {
+    denoise = enabled;
+    if (denoise && backend != RenderBackend::CPU && !denoiseTargets[0].texture) ResizeAuxTargets();
+}
+
+// 开关时域重投影(渲染线程调用); 只支持GPU后端, 每次开启都从当前帧重新开始
+void RenderData::SetTemporal(bool enabled) {
+    temporal = enabled;
+    if (!temporal) return;
+    if (backend == RenderBackend::CPU) {
+        std::cerr << "[TEMPORAL] CPU后端不支持时域重投影, 已忽略" << std::endl;
+        return;
+    }
+    if (!reprojection->Allocated()) ResizeAuxTargets();
+    reprojection->Reset();
+}
+
+// 切换采样序列: 蓝噪声掩码在首次使用时上传; 已创建的单内核与波前各pass按新宏重建
+void RenderData::SetSampler(SamplerType type, uint32_t scramble) {
+    sampler = type;
+    samplerScramble = scramble;
+    if (sampler == SamplerType::BlueNoise && !blueNoiseBuffer) {
+        const std::vector<vec2>& texels = BlueNoise::Get();
+        glCreateBuffers(1, &blueNoiseBuffer);
+        glNamedBufferStorage(blueNoiseBuffer, texels.size() * sizeof(vec2), texels.data(), 0);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SAMPLER_BINDING_BLUE_NOISE, blueNoiseBuffer);
+    }
+    if (computeShaderID) RebuildComputeShader();
+    if (wavefront) {
+        delete wavefront;
+        wavefront = new WavefrontTracer(ComputeDefines(), maxBounces);
+    }
+    if (cpuTracer) cpuTracer->SetSampler(sampler);
+    ResetAccumulation();
+}
+
+// 窗口尺寸变化: 立即更新屏幕尺寸(超出已分配范围的部分暂时降低渲染比例), 渲染目标的调整延后到拖动停止
+void RenderData::RequestResize(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    SetRenderScale(renderScale);
+    resizeDeadline = glfwGetTime() + 0.15;
+}
+
+void RenderData::ApplyPendingResize(double now) {
+    if (resizeDeadline <= 0.0 || now < resizeDeadline) return;
+    resizeDeadline = 0.0;
+    ResizeRenderTargets();
+}
+
+// 应用模拟线程发布的快照(渲染线程调用): 相机、光源、降噪/时域开关与窗口尺寸
+void RenderData::ApplySnapshot(const FrameSnapshot& snapshot) {
+    cameraPos = snapshot.cameraPos;
+    cameraFront = snapshot.cameraFront;
+    cameraRight = snapshot.cameraRight;
+    cameraUp = snapshot.cameraUp;
+    lightPos = snapshot.lightPos;
+    time = snapshot.time;
+
+    // 相机变化或切换累积模式时重新开始累积
+    if (snapshot.cameraVersion != cameraVersion || snapshot.accumulate != accumulate) ResetAccumulation();
+    cameraVersion = snapshot.cameraVersion;
+    accumulate = snapshot.accumulate;
+    if (snapshot.denoise != denoise) SetDenoise(snapshot.denoise);
+    if (snapshot.temporal != temporal) SetTemporal(snapshot.temporal);
+
+    // 更新视口与屏幕尺寸, 渲染目标在拖动停止后再调整(防抖)
+    if (snapshot.framebufferWidth != screenWidth || snapshot.framebufferHeight != screenHeight) {
+        glViewport(0, 0, snapshot.framebufferWidth, snapshot.framebufferHeight);
+        RequestResize(snapshot.framebufferWidth, snapshot.framebufferHeight);
+        std::cout << "窗口大小已更新: " << screenWidth << "x" << screenHeight << std::endl;
+    }
+}
+
+// 推进场景动画并应用本帧的场景改动(渲染线程调用): GPU后端增量上传, CPU后端只refit; 有改动时重置累积
+void RenderData::UpdateScene() {
+    if (animator) animator->Apply(*scene, time, lightPos);
+    if (scene->Update(backend == RenderBackend::CPU ? nullptr : staging)) {
+        if (staging) staging->Advance();
+        ResetAccumulation();
+    }
+}
+
+// 设置内部渲染比例(不重新分配渲染目标), 尺寸变化时重置累积
+void RenderData::SetRenderScale(float scale) {
+    renderScale = std::clamp(scale, 0.1f, 1.0f);
+
+    // 保持宽高比, 不超出已分配的渲染目标
+    float fit = 1.0f;
+    if (outputTarget.texture) {
+        fit = std::min({ 1.0f, outputTarget.width / (screenWidth * renderScale),
+                         outputTarget.height / (screenHeight * renderScale) });
+    }
+    int width = std::max(1, static_cast<int>(std::lround(screenWidth * renderScale * fit)));
+    int height = std::max(1, static_cast<int>(std::lround(screenHeight * renderScale * fit)));
+    if (width != renderWidth || height != renderHeight) {
+        renderWidth = width;
+        renderHeight = height;
+        ResetAccumulation();
+    }
+}
+
+// 加载场景文件, 失败时保留当前场景
+bool RenderData::LoadScene(const string& path) {
+    if (!scene->LoadFromJson(path)) return false;
+    if (quadVAO) scene->Upload();
+    if (reprojection) reprojection->Reset();
+    ResetAccumulation();
+    return true;
 }
 
 RenderData* RenderData::GetInstance() {
@@ -0,0 +1,529 @@
+// src/render_farm.cpp
+#include "pch.h"
+#include "render_farm.h"
+#include "render_data.h"
+#include "launch_options.h"
+#include "thread_pool.h"
+#include <cstring>
+#include <numeric>
+#ifndef _WIN32
+    #include <cerrno>
+    #include <csignal>
+    #include <poll.h>
+    #include <spawn.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    extern char** environ;
+#endif
+
+namespace SimpleDrawingDemo {
+
+using namespace FarmProtocol;
+
+nlohmann::json FarmStats::ToJson() const {
+    return {
+        { "workers", workers },
+        { "frames", frames },
+        { "tiles", tiles },
+        { "local_tiles", localTiles },
+        { "steals", steals },
+        { "failures", failures },
+        { "reassigned", reassigned },
+        { "bytes_sent", bytesSent },
+        { "bytes_received", bytesReceived },
+    };
+}
+
+RenderFarm::RenderFarm(const Scene* scene, const LaunchOptions& options)
+    : m_scene(scene), m_options(options)
+{}
+
+int RenderFarm::WorkerCount() const {
+    return static_cast<int>(std::count_if(m_workers.begin(), m_workers.end(), [](const Worker& w) { return w.alive; }));
+}
+
+// 协调进程自己渲染(没有可用的工作进程时), 结果拷入组装缓冲
+void RenderFarm::RenderLocally(const std::vector<int>& tiles) {
+    if (tiles.empty()) return;
+    if (!m_localTracer) {
+        m_localTracer = new CpuTracer(m_scene);
+        m_localTracer->SetMaxBounces(m_options.bounces);
+    }
+    const Camera& snapshot = m_job.camera;
+    CpuCamera camera = { snapshot.pos, snapshot.front, snapshot.right, snapshot.up, snapshot.time, snapshot.frameIndex };
+    m_localTracer->RenderTiles(camera, m_width, m_height, tiles);
+
+    const std::vector<float>& source = m_localTracer->Pixels();
+    for (int tile : tiles) {
+        int x0 = (tile % m_tilesX) * CpuTracer::kTileSize, y0 = (tile / m_tilesX) * CpuTracer::kTileSize;
+        for (int y = y0; y < std::min(y0 + CpuTracer::kTileSize, m_height); y++) {
+            size_t begin = (static_cast<size_t>(y) * m_width + x0) * 4;
+            size_t count = static_cast<size_t>(std::min(CpuTracer::kTileSize, m_width - x0)) * 4;
+            std::copy_n(source.begin() + begin, count, m_pixels.begin() + begin);
+        }
+    }
+    m_stats.localTiles += static_cast<long long>(tiles.size());
+}
+
+#ifndef _WIN32
+
+namespace {
+double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 完整收发size字节(处理EINTR与部分传输); 对端断开或超时(SO_RCVTIMEO/SO_SNDTIMEO)返回false
+bool ReadAll(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool WriteAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);   // 对端已退出时返回EPIPE而不是触发SIGPIPE
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 消息头与负载合并为一次发送
+template<typename T>
+bool SendMessage(int fd, MessageType type, const T& payload, const void* extra = nullptr, size_t extraSize = 0) {
+    std::vector<char> message(sizeof(Header) + sizeof(T) + extraSize);
+    Header header;
+    header.type = static_cast<uint16_t>(type);
+    header.size = static_cast<uint32_t>(sizeof(T) + extraSize);
+    std::memcpy(message.data(), &header, sizeof(Header));
+    std::memcpy(message.data() + sizeof(Header), &payload, sizeof(T));
+    if (extraSize > 0) std::memcpy(message.data() + sizeof(Header) + sizeof(T), extra, extraSize);
+    return WriteAll(fd, message.data(), message.size());
+}
+
+bool ReadHeader(int fd, Header& header) {
+    return ReadAll(fd, &header, sizeof(header)) && header.magic == kMagic && header.version == kVersion;
+}
+
+void SetTimeouts(int fd, int milliseconds) {
+    timeval timeout = { milliseconds / 1000, (milliseconds % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+bool MakeAddress(const string& path, sockaddr_un& address) {
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    address = {};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+}
+
+RenderFarm::~RenderFarm() {
+    for (Worker& worker : m_workers) {
+        if (!worker.alive) continue;
+        Header quit;
+        quit.type = static_cast<uint16_t>(MessageType::Quit);
+        WriteAll(worker.fd, &quit, sizeof(quit));
+        close(worker.fd);
+    }
+    // 等待全部子进程退出(未连上的直接结束); 已回收的pid可能属于其他进程, 跳过
+    for (const Process& process : m_spawned) {
+        if (process.reaped) continue;
+        int pid = process.pid;
+        bool connected = std::any_of(m_workers.begin(), m_workers.end(), [pid](const Worker& w) { return w.pid == pid && w.alive; });
+        if (!connected) kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+    if (m_listenFd >= 0) {
+        close(m_listenFd);
+        unlink(m_socketPath.c_str());
+    }
+    delete m_localTracer;
+}
+
+// 工作进程的命令行: 与协调进程相同的场景与追踪参数, 不带任何输出参数
+std::vector<string> RenderFarm::WorkerArgs(int index) const {
+    std::vector<string> args = { "/proc/self/exe", "--headless", "--backend", "cpu", "--farm-worker", m_socketPath };
+    if (m_options.randomSpheres > 0) {
+        args.insert(args.end(), { "--random-spheres", std::to_string(m_options.randomSpheres) });
+    } else if (!m_options.scenePath.empty()) {
+        args.insert(args.end(), { "--scene", m_options.scenePath });
+    }
+    args.insert(args.end(), { "--bounces", std::to_string(m_options.bounces) });
+    if (m_options.animate > 0.0f) args.insert(args.end(), { "--animate", std::to_string(m_options.animate) });
+    if (index == 0 && m_options.farmFault > 0) args.insert(args.end(), { "--farm-fault", std::to_string(m_options.farmFault) });
+    return args;
+}
+
+bool RenderFarm::Spawn(const std::vector<string>& args) {
+    std::vector<char*> argv;
+    for (const string& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    // 工作进程的日志改写到stderr, 避免混入协调进程输出到stdout的报告
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, STDERR_FILENO, STDOUT_FILENO);
+    pid_t pid = 0;
+    int error = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        std::cerr << "[ERROR_FARM] 无法启动工作进程: " << std::strerror(error) << std::endl;
+        return false;
+    }
+    m_spawned.push_back({ pid });
+    return true;
+}
+
+RenderFarm::Process* RenderFarm::FindProcess(int pid) {
+    auto it = std::find_if(m_spawned.begin(), m_spawned.end(), [pid](const Process& p) { return p.pid == pid; });
+    return it == m_spawned.end() ? nullptr : &*it;
+}
+
+bool RenderFarm::Start() {
+    m_socketPath = m_options.farmSocket.empty()
+        ? "/tmp/simple_drawing_farm_" + std::to_string(getpid()) + ".sock" : m_options.farmSocket;
+    sockaddr_un address;
+    if (!MakeAddress(m_socketPath, address)) {
+        std::cerr << "[ERROR_FARM] 套接字路径过长: " << m_socketPath << std::endl;
+        return false;
+    }
+    unlink(m_socketPath.c_str());
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(m_listenFd, m_options.farm) != 0) {
+        std::cerr << "[ERROR_FARM] 无法监听套接字: " << m_socketPath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < m_options.farm; i++) {
+        if (!Spawn(WorkerArgs(i))) break;
+    }
+    if (!Accept()) return false;
+
+    m_stats.workers = WorkerCount();
+    std::cout << "[FARM] " << m_stats.workers << "/" << m_options.farm << " 个工作进程已连接 (" << m_socketPath << ")" << std::endl;
+    return true;
+}
+
+// 等待已启动的进程连接并发送Hello; 进程提前退出或超时则不再等待
+bool RenderFarm::Accept() {
+    double deadline = Now() + kConnectTimeoutMs / 1000.0;
+    int exited = 0;
+    while (static_cast<int>(m_workers.size()) + exited < static_cast<int>(m_spawned.size()) && Now() < deadline) {
+        pollfd listenPoll = { m_listenFd, POLLIN, 0 };
+        if (poll(&listenPoll, 1, 100) <= 0) {
+            // 加载场景失败等原因提前退出的进程: 回收并记录, 之后不再探测
+            for (Process& process : m_spawned) {
+                if (process.reaped || waitpid(process.pid, nullptr, WNOHANG) != process.pid) continue;
+                process.reaped = true;
+                int pid = process.pid;
+                if (std::none_of(m_workers.begin(), m_workers.end(), [pid](const Worker& w) { return w.pid == pid; })) exited++;
+            }
+            continue;
+        }
+        int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        SetTimeouts(fd, kWorkerTimeoutMs);
+
+        Header header;
+        Hello hello;
+        if (!ReadHeader(fd, header) || header.type != static_cast<uint16_t>(MessageType::Hello)
+            || header.size != sizeof(Hello) || !ReadAll(fd, &hello, sizeof(hello))
+            || !FindProcess(hello.pid) || FindProcess(hello.pid)->reaped) {
+            std::cerr << "[ERROR_FARM] 拒绝未知的连接" << std::endl;
+            close(fd);
+            continue;
+        }
+        Worker worker;
+        worker.fd = fd;
+        worker.pid = hello.pid;
+        worker.alive = true;
+        m_workers.push_back(worker);
+    }
+
+    if (m_workers.empty()) {
+        std::cerr << "[ERROR_FARM] 没有工作进程连接到 " << m_socketPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 先取自己队列的头部; 空了就从最长队列的尾部窃取(尾部离其所有者当前位置最远)
+bool RenderFarm::NextTile(Worker& worker, int& tile) {
+    if (!worker.queue.empty()) {
+        tile = worker.queue.front();
+        worker.queue.pop_front();
+        return true;
+    }
+    Worker* victim = nullptr;
+    for (Worker& other : m_workers) {
+        if (other.alive && !other.queue.empty() && (!victim || other.queue.size() > victim->queue.size())) victim = &other;
+    }
+    if (!victim) return false;
+    tile = victim->queue.back();
+    victim->queue.pop_back();
+    m_stats.steals++;
+    return true;
+}
+
+bool RenderFarm::Send(Worker& worker, int tile) {
+    if (worker.inFlight.empty()) worker.lastProgress = Now();
+    worker.inFlight.push_back(tile);   // 发送失败时随在途任务一起重新分配
+
+    Job job = m_job;
+    job.tile = tile;
+    int x0 = (tile % m_tilesX) * CpuTracer::kTileSize, y0 = (tile / m_tilesX) * CpuTracer::kTileSize;
+    job.rect = { static_cast<uint16_t>(x0), static_cast<uint16_t>(y0),
+        static_cast<uint16_t>(std::min(CpuTracer::kTileSize, m_width - x0)),
+        static_cast<uint16_t>(std::min(CpuTracer::kTileSize, m_height - y0)) };
+    if (!SendMessage(worker.fd, MessageType::Job, job)) return false;
+    m_stats.bytesSent += sizeof(Header) + sizeof(Job);
+    return true;
+}
+
+// 读取一个结果(应对应最早的在途分块)并写入组装缓冲
+bool RenderFarm::Receive(Worker& worker) {
+    Header header;
+    Result result;
+    if (!ReadHeader(worker.fd, header) || header.type != static_cast<uint16_t>(MessageType::Result)
+        || header.size < sizeof(Result) || !ReadAll(worker.fd, &result, sizeof(result))) return false;
+
+    const TileRect& rect = result.rect;
+    size_t pixelCount = static_cast<size_t>(rect.width) * rect.height;
+    if (result.frame != m_job.frame || worker.inFlight.empty() || result.tile != worker.inFlight.front()
+        || header.size != sizeof(Result) + pixelCount * 3 * sizeof(float)
+        || rect.x + rect.width > m_width || rect.y + rect.height > m_height) return false;
+
+    m_buffer.resize(pixelCount * 3);
+    if (!ReadAll(worker.fd, m_buffer.data(), m_buffer.size() * sizeof(float))) return false;
+    for (int y = 0; y < rect.height; y++) {
+        const float* source = &m_buffer[static_cast<size_t>(y) * rect.width * 3];
+        float* target = &m_pixels[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4];
+        for (int x = 0; x < rect.width; x++) {
+            target[x * 4 + 0] = source[x * 3 + 0];
+            target[x * 4 + 1] = source[x * 3 + 1];
+            target[x * 4 + 2] = source[x * 3 + 2];
+            target[x * 4 + 3] = 1.0f;
+        }
+    }
+
+    worker.inFlight.pop_front();
+    worker.lastProgress = Now();
+    m_stats.tiles++;
+    m_stats.bytesReceived += sizeof(Header) + header.size;
+    return true;
+}
+
+// 结束失效的进程, 其在途与排队的分块逐个交给当前负载最轻的存活进程
+void RenderFarm::Fail(Worker& worker, const char* reason) {
+    std::cerr << "[FARM] 工作进程 " << worker.pid << " 失效(" << reason << "), 重新分配 "
+              << worker.inFlight.size() + worker.queue.size() << " 个分块" << std::endl;
+    close(worker.fd);
+    Process* process = FindProcess(worker.pid);
+    if (process && !process->reaped) kill(worker.pid, SIGKILL);
+    worker.alive = false;
+    m_stats.failures++;
+
+    std::vector<int> orphans(worker.inFlight.begin(), worker.inFlight.end());
+    orphans.insert(orphans.end(), worker.queue.begin(), worker.queue.end());
+    worker.inFlight.clear();
+    worker.queue.clear();
+    m_stats.reassigned += static_cast<long long>(orphans.size());
+
+    for (int tile : orphans) {
+        Worker* target = nullptr;
+        for (Worker& other : m_workers) {
+            if (other.alive && (!target || other.queue.size() + other.inFlight.size() < target->queue.size() + target->inFlight.size())) {
+                target = &other;
+            }
+        }
+        // 没有存活的进程: 暂存在失效进程的队列中, 由协调进程本地渲染
+        (target ? target : &worker)->queue.push_back(tile);
+    }
+}
+
+void RenderFarm::Render(const CpuCamera& camera, const vec3& lightPos, int width, int height) {
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        m_pixels.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    }
+    m_tilesX = (width + CpuTracer::kTileSize - 1) / CpuTracer::kTileSize;
+    int tileCount = m_tilesX * ((height + CpuTracer::kTileSize - 1) / CpuTracer::kTileSize);
+
+    m_job.frame++;
+    m_job.frameWidth = width;
+    m_job.frameHeight = height;
+    m_job.camera = { camera.pos, camera.front, camera.right, camera.up, lightPos, camera.time, camera.frameIndex };
+    m_stats.frames++;
+
+    // 按连续区间预分配(相邻分块的场景相近, 各进程的缓存命中更好)
+    std::vector<Worker*> alive;
+    for (Worker& worker : m_workers) {
+        if (worker.alive) alive.push_back(&worker);
+    }
+    for (size_t i = 0; i < alive.size(); i++) {
+        int begin = static_cast<int>(tileCount * i / alive.size());
+        int end = static_cast<int>(tileCount * (i + 1) / alive.size());
+        for (int tile = begin; tile < end; tile++) alive[i]->queue.push_back(tile);
+    }
+    if (alive.empty()) {
+        std::vector<int> tiles(tileCount);
+        std::iota(tiles.begin(), tiles.end(), 0);
+        RenderLocally(tiles);
+        return;
+    }
+
+    std::vector<pollfd> polls;
+    std::vector<Worker*> polled;
+    while (true) {
+        // 补满各进程的流水线
+        for (Worker& worker : m_workers) {
+            int tile;
+            while (worker.alive && worker.inFlight.size() < kPipelineDepth && NextTile(worker, tile)) {
+                if (!Send(worker, tile)) Fail(worker, "发送失败");
+            }
+        }
+
+        polls.clear();
+        polled.clear();
+        for (Worker& worker : m_workers) {
+            if (!worker.alive || worker.inFlight.empty()) continue;
+            polls.push_back({ worker.fd, POLLIN, 0 });
+            polled.push_back(&worker);
+        }
+        if (polls.empty()) break;   // 全部完成, 或者已经没有存活的进程
+
+        if (poll(polls.data(), polls.size(), 100) < 0 && errno != EINTR) break;
+        double now = Now();
+        for (size_t i = 0; i < polls.size(); i++) {
+            Worker& worker = *polled[i];
+            if (polls[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                if (!Receive(worker)) Fail(worker, "连接断开或数据错误");
+            } else if (now - worker.lastProgress > kWorkerTimeoutMs / 1000.0) {
+                Fail(worker, "超时");
+            }
+        }
+    }
+
+    // 失效进程遗留的分块
+    std::vector<int> remaining;
+    for (Worker& worker : m_workers) {
+        remaining.insert(remaining.end(), worker.queue.begin(), worker.queue.end());
+        remaining.insert(remaining.end(), worker.inFlight.begin(), worker.inFlight.end());
+        worker.queue.clear();
+        worker.inFlight.clear();
+    }
+    if (!remaining.empty()) std::cerr << "[FARM] 没有可用的工作进程, 本地渲染 " << remaining.size() << " 个分块" << std::endl;
+    RenderLocally(remaining);
+}
+
+int RenderFarm::RunWorker(RenderData* data, const LaunchOptions& options) {
+    sockaddr_un address;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || !MakeAddress(options.farmWorker, address)
+        || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "[ERROR_FARM] 无法连接协调进程: " << options.farmWorker << std::endl;
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    // 单线程追踪: 并行度由进程数决定
+    ThreadPool pool(1);
+    CpuTracer tracer(data->scene, &pool);
+    tracer.SetMaxBounces(options.bounces);
+    if (!SendMessage(fd, MessageType::Hello, Hello{ static_cast<int32_t>(getpid()), tracer.ThreadCount() })) {
+        close(fd);
+        return 1;
+    }
+
+    std::vector<float> packed;
+    float sceneTime = -1.0f;
+    int completed = 0;
+    Header header;
+    Job job;
+    while (ReadHeader(fd, header) && header.type == static_cast<uint16_t>(MessageType::Job)
+        && header.size == sizeof(Job) && ReadAll(fd, &job, sizeof(job))) {
+        // 动画场景按快照的时间重放(与协调进程的更新一致)
+        if (data->animator && job.camera.time != sceneTime) {
+            sceneTime = job.camera.time;
+            data->time = job.camera.time;
+            data->lightPos = job.camera.lightPos;
+            data->UpdateScene();
+        }
+
+        const Camera& snapshot = job.camera;
+        CpuCamera camera = { snapshot.pos, snapshot.front, snapshot.right, snapshot.up, snapshot.time, snapshot.frameIndex };
+        tracer.RenderTiles(camera, job.frameWidth, job.frameHeight, { job.tile });
+
+        const TileRect& rect = job.rect;
+        packed.resize(static_cast<size_t>(rect.width) * rect.height * 3);
+        const std::vector<float>& pixels = tracer.Pixels();
+        for (int y = 0; y < rect.height; y++) {
+            const float* source = &pixels[(static_cast<size_t>(rect.y + y) * job.frameWidth + rect.x) * 4];
+            float* target = &packed[static_cast<size_t>(y) * rect.width * 3];
+            for (int x = 0; x < rect.width; x++) {
+                target[x * 3 + 0] = source[x * 4 + 0];
+                target[x * 3 + 1] = source[x * 4 + 1];
+                target[x * 3 + 2] = source[x * 4 + 2];
+            }
+        }
+
+        // 故障注入(测试用): 在途任务未回传即退出
+        if (options.farmFault > 0 && ++completed >= options.farmFault) {
+            std::cerr << "[FARM] 工作进程 " << getpid() << " 按--farm-fault退出" << std::endl;
+            _exit(3);
+        }
+
+        Result result = { job.frame, job.tile, rect };
+        if (!SendMessage(fd, MessageType::Result, result, packed.data(), packed.size() * sizeof(float))) break;
+    }
+    close(fd);
+    return 0;
+}
+
+#else
+
+RenderFarm::~RenderFarm() {
+    delete m_localTracer;
+}
+
+bool RenderFarm::Start() {
+    std::cerr << "[ERROR_FARM] 渲染农场需要POSIX(AF_UNIX + posix_spawn), 当前平台不支持" << std::endl;
+    return false;
+}
+
+void RenderFarm::Render(const CpuCamera& camera, const vec3& lightPos, int width, int height) {
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        m_pixels.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    }
+    m_tilesX = (width + CpuTracer::kTileSize - 1) / CpuTracer::kTileSize;
+    m_job.camera = { camera.pos, camera.front, camera.right, camera.up, lightPos, camera.time, camera.frameIndex };
+    std::vector<int> tiles(m_tilesX * ((height + CpuTracer::kTileSize - 1) / CpuTracer::kTileSize));
+    std::iota(tiles.begin(), tiles.end(), 0);
+    RenderLocally(tiles);
+}
+
+int RenderFarm::RunWorker(RenderData*, const LaunchOptions&) {
+    std::cerr << "[ERROR_FARM] 渲染农场需要POSIX(AF_UNIX + posix_spawn), 当前平台不支持" << std::endl;
+    return 1;
+}
+
+#endif
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,114 @@
+// src/render_targets.cpp
+#include "pch.h"
+#include "render_targets.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+const TargetFormatInfo kFormats[] = {
+    { "rgba32f",    GL_RGBA32F,        "rgba32f",        16 },
+    { "rgba16f",    GL_RGBA16F,        "rgba16f",        8 },
+    { "r11g11b10f", GL_R11F_G11F_B10F, "r11f_g11f_b10f", 4 },
+    { "rgba8",      GL_RGBA8,          "rgba8",          4 },
+};
+}
+
+const TargetFormatInfo& FormatInfo(TargetFormat format) {
+    return kFormats[static_cast<int>(format)];
+}
+
+bool ParseTargetFormat(const string& name, TargetFormat& format) {
+    for (int i = 0; i < static_cast<int>(std::size(kFormats)); i++) {
+        if (name == kFormats[i].name) {
+            format = static_cast<TargetFormat>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+RenderTargetPool::~RenderTargetPool() {
+    Clear();
+}
+
+int RenderTargetPool::Bucket(int size) {
+    int bucket = 64;
+    while (bucket < size) bucket *= 2;
+    return bucket;
+}
+
+RenderTarget RenderTargetPool::Acquire(TargetFormat format, int width, int height) {
+    int bucketWidth = Bucket(width), bucketHeight = Bucket(height);
+
+    // 优先复用池中同格式同尺寸的目标
+    for (size_t i = 0; i < m_free.size(); i++) {
+        const RenderTarget& target = m_free[i];
+        if (target.format == format && target.width == bucketWidth && target.height == bucketHeight) {
+            RenderTarget result = target;
+            m_free.erase(m_free.begin() + i);
+            m_reused++;
+            return result;
+        }
+    }
+
+    RenderTarget target = { 0, bucketWidth, bucketHeight, format };
+    glCreateTextures(GL_TEXTURE_2D, 1, &target.texture);
+    glTextureStorage2D(target.texture, 1, FormatInfo(format).internalFormat, bucketWidth, bucketHeight);
+    glTextureParameteri(target.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(target.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(target.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(target.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+    m_allocatedBytes += static_cast<size_t>(bucketWidth) * bucketHeight * FormatInfo(format).bytesPerPixel;
+    m_created++;
+    return target;
+}
+
+void RenderTargetPool::Release(RenderTarget& target) {
+    if (!target.texture) return;
+    m_free.push_back(target);
+    target = RenderTarget();
+
+    // 从最近放回的开始数尺寸桶, 超出kMaxSpareBuckets个桶的空闲目标全部删除
+    std::vector<std::pair<int, int>> buckets;
+    for (auto it = m_free.rbegin(); it != m_free.rend(); ++it) {
+        std::pair<int, int> bucket(it->width, it->height);
+        if (std::find(buckets.begin(), buckets.end(), bucket) == buckets.end()) buckets.push_back(bucket);
+    }
+    if (buckets.size() <= kMaxSpareBuckets) return;
+    buckets.resize(kMaxSpareBuckets);
+    std::erase_if(m_free, [&](const RenderTarget& spare) {
+        bool keep = std::find(buckets.begin(), buckets.end(), std::pair<int, int>(spare.width, spare.height)) != buckets.end();
+        if (!keep) Destroy(spare);
+        return !keep;
+    });
+}
+
+void RenderTargetPool::Reacquire(RenderTarget& target, TargetFormat format, int width, int height) {
+    if (target.texture && target.format == format && target.width == Bucket(width) && target.height == Bucket(height)) return;
+
+    // 先获取再放回: 放回的旧目标不会挤掉本次要复用的空闲目标
+    RenderTarget next = Acquire(format, width, height);
+    Release(target);
+    target = next;
+}
+
+std::vector<unsigned int> RenderTargetPool::SpareTextures() const {
+    std::vector<unsigned int> names;
+    for (const RenderTarget& target : m_free) names.push_back(target.texture);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void RenderTargetPool::Clear() {
+    for (const RenderTarget& target : m_free) {
+        Destroy(target);
+    }
+    m_free.clear();
+}
+
+void RenderTargetPool::Destroy(const RenderTarget& target) {
+    glDeleteTextures(1, &target.texture);
+    m_allocatedBytes -= static_cast<size_t>(target.width) * target.height * FormatInfo(target.format).bytesPerPixel;
+}
+}   // namespace SimpleDrawingDemo
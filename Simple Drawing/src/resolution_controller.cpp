@@ -0,0 +1,41 @@
+// src/resolution_controller.cpp
+#include "pch.h"
+#include "resolution_controller.h"
+
+namespace SimpleDrawingDemo {
+
+ResolutionController::ResolutionController(double targetMs, float minScale, float maxScale)
+    : m_targetMs(targetMs), m_minScale(minScale), m_maxScale(maxScale) {}
+
+void ResolutionController::AddSample(double ms) {
+    // 冷却期内的样本仍可能来自旧比例, 直接丢弃
+    if (m_cooldown > 0) {
+        m_cooldown--;
+        return;
+    }
+    m_smoothedMs = m_sampleCount == 0 ? ms : m_smoothedMs * 0.8 + ms * 0.2;
+    m_sampleCount++;
+}
+
+float ResolutionController::Update(float currentScale) {
+    double ms;
+    while (m_timer.Poll(ms)) AddSample(ms);
+
+    if (m_sampleCount < kMinSamples) return currentScale;
+
+    // 死区: 实测在目标的87%~105%之间不调整(超出预算比留有余量更需要及时响应)
+    double ratio = m_targetMs / std::max(m_smoothedMs, 1e-3);
+    if (ratio > 0.95 && ratio < 1.15) return currentScale;
+
+    float desired = currentScale * static_cast<float>(std::sqrt(ratio));
+    desired = std::clamp(desired, currentScale * 0.9f, currentScale * 1.1f);   // 单步限幅
+    desired = std::round(desired / kStep) * kStep;
+    desired = std::clamp(desired, m_minScale, m_maxScale);
+
+    if (desired != currentScale) {
+        m_cooldown = kCooldownFrames;
+        m_sampleCount = 0;      // 新比例下重新统计
+    }
+    return desired;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,260 @@
+// src/sampler.cpp
+#include "pch.h"
+#include "sampler.h"
+#include "defines.h"
+#include <random>
+
+namespace SimpleDrawingDemo {
+
+namespace {
+constexpr uint32_t kCacheMagic = 0x45534e42;   // "BNSE"
+constexpr float kSigma = 1.9f;                 // void-and-cluster的高斯核宽度(Ulichney推荐1.5)
+
+// R2序列的步长(塑料数的倒数, 32位定点)
+constexpr uint32_t kR2X = 3242174889u;
+constexpr uint32_t kR2Y = 2447445414u;
+
+// 以下函数与common/sampler.glsl逐项对应
+uint32_t HashUint(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+uint32_t HashPixel(int x, int y, uint32_t dimension) {
+    return HashUint(static_cast<uint32_t>(x) ^ HashUint(static_cast<uint32_t>(y) ^ HashUint(dimension)));
+}
+
+float ToUnit(uint32_t x) {
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+uint32_t ReverseBits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+uint32_t NestedUniformScramble(uint32_t x, uint32_t seed) {
+    x = ReverseBits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return ReverseBits(x);
+}
+
+uint32_t SobolSecond(uint32_t index) {
+    uint32_t result = 0;
+    for (uint32_t v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1) {
+        if (index & 1u) result ^= v;
+    }
+    return result;
+}
+
+// 与GLSL rand(vec2 co)一致的哈希
+float Rand(float x, float y) {
+    float v = std::sin(x * 12.9898f + y * 78.233f) * 43758.5453f;
+    return v - std::floor(v);
+}
+}
+
+const char* SamplerName(SamplerType type) {
+    switch (type) {
+    case SamplerType::Hash: return "hash";
+    case SamplerType::R2: return "r2";
+    case SamplerType::Sobol: return "sobol";
+    case SamplerType::BlueNoise: return "bluenoise";
+    }
+    return "";
+}
+
+bool ParseSampler(const string& name, SamplerType& type) {
+    for (SamplerType candidate : { SamplerType::Hash, SamplerType::R2, SamplerType::Sobol, SamplerType::BlueNoise }) {
+        if (name == SamplerName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ------- 蓝噪声 ------- */
+
+// void-and-cluster: 能量为已选点的环绕高斯核之和, 能量最高的点为"最紧的簇", 最低的空位为"最大的空洞"
+std::vector<float> BlueNoise::Generate(unsigned int seed) {
+    const int count = kSize * kSize;
+    const int mask = kSize - 1;
+
+    // 按偏移查表的环绕高斯核
+    std::vector<float> kernel(count);
+    for (int dy = 0; dy < kSize; dy++) {
+        for (int dx = 0; dx < kSize; dx++) {
+            float x = static_cast<float>(std::min(dx, kSize - dx)), y = static_cast<float>(std::min(dy, kSize - dy));
+            kernel[dy * kSize + dx] = std::exp(-(x * x + y * y) / (2.0f * kSigma * kSigma));
+        }
+    }
+
+    std::vector<unsigned char> pattern(count, 0);
+    std::vector<float> energy(count, 0.0f);
+    auto toggle = [&](int index, bool set) {
+        pattern[index] = set ? 1 : 0;
+        int x0 = index % kSize, y0 = index / kSize;
+        float sign = set ? 1.0f : -1.0f;
+        for (int y = 0; y < kSize; y++) {
+            const float* row = &kernel[((y - y0) & mask) * kSize];
+            float* target = &energy[y * kSize];
+            for (int x = 0; x < kSize; x++) target[x] += sign * row[(x - x0) & mask];
+        }
+    };
+    auto tightestCluster = [&] {
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            if (pattern[i] && (best < 0 || energy[i] > energy[best])) best = i;
+        }
+        return best;
+    };
+    auto largestVoid = [&] {
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            if (!pattern[i] && (best < 0 || energy[i] < energy[best])) best = i;
+        }
+        return best;
+    };
+
+    // 初始二值图: 十分之一的随机点, 反复把最紧的簇移到最大的空洞, 直到移回原处
+    std::mt19937 rng(seed);
+    int initial = count / 10;
+    for (int placed = 0; placed < initial;) {
+        int index = static_cast<int>(rng() % count);
+        if (pattern[index]) continue;
+        toggle(index, true);
+        placed++;
+    }
+    while (true) {
+        int cluster = tightestCluster();
+        toggle(cluster, false);
+        int hole = largestVoid();
+        toggle(hole, true);
+        if (hole == cluster) break;
+    }
+
+    // 第一阶段: 从初始图中逐个去掉最紧的簇, 秩从initial - 1递减
+    std::vector<int> rank(count);
+    std::vector<unsigned char> prototype = pattern;
+    std::vector<float> prototypeEnergy = energy;
+    for (int r = initial - 1; r >= 0; r--) {
+        int cluster = tightestCluster();
+        toggle(cluster, false);
+        rank[cluster] = r;
+    }
+
+    // 第二、三阶段: 从初始图开始逐个填入最大的空洞, 直到填满
+    pattern = prototype;
+    energy = prototypeEnergy;
+    for (int r = initial; r < count; r++) {
+        int hole = largestVoid();
+        toggle(hole, true);
+        rank[hole] = r;
+    }
+
+    std::vector<float> values(count);
+    for (int i = 0; i < count; i++) values[i] = (rank[i] + 0.5f) / count;
+    return values;
+}
+
+bool BlueNoise::LoadCache(std::vector<vec2>& texels) {
+    std::ifstream file(BLUE_NOISE_PATH, std::ios::binary);
+    if (!file) return false;
+
+    uint32_t header[2] = {};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || header[0] != kCacheMagic || header[1] != static_cast<uint32_t>(kSize)) return false;
+
+    texels.resize(static_cast<size_t>(kSize) * kSize);
+    file.read(reinterpret_cast<char*>(texels.data()), texels.size() * sizeof(vec2));
+    return static_cast<bool>(file);
+}
+
+void BlueNoise::WriteCache(const std::vector<vec2>& texels) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(BLUE_NOISE_PATH).parent_path(), error);
+
+    // 先写临时文件再改名, 中途退出不会留下不完整的缓存
+    string tempPath = string(BLUE_NOISE_PATH) + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    uint32_t header[2] = { kCacheMagic, static_cast<uint32_t>(kSize) };
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(texels.data()), texels.size() * sizeof(vec2));
+    file.close();
+
+    if (file) std::filesystem::rename(tempPath, BLUE_NOISE_PATH, error);
+    if (!file || error) {
+        std::cerr << "[SAMPLER] 蓝噪声缓存写入失败: " << BLUE_NOISE_PATH << std::endl;
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+const std::vector<vec2>& BlueNoise::Get() {
+    static const std::vector<vec2> texels = [] {
+        std::vector<vec2> result;
+        if (LoadCache(result)) return result;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<float> first = Generate(1), second = Generate(2);
+        result.resize(first.size());
+        for (size_t i = 0; i < result.size(); i++) result[i] = vec2(first[i], second[i]);
+        WriteCache(result);
+        std::cout << "[SAMPLER] 已生成 " << kSize << "x" << kSize << " 蓝噪声 (void-and-cluster, "
+                  << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count()
+                  << " ms), 缓存到 " << BLUE_NOISE_PATH << std::endl;
+        return result;
+    }();
+    return texels;
+}
+
+/* ------- 采样器 ------- */
+
+string Sampler::Defines(SamplerType type, uint32_t scramble) {
+    string defines = "#define SAMPLER " + std::to_string(static_cast<int>(type)) + "\n";
+    if (scramble != 0) defines += "#define SAMPLER_SCRAMBLE " + std::to_string(scramble) + "u\n";
+    return defines;
+}
+
+vec2 Sampler::Sample2D(SamplerType type, int x, int y, uint32_t index, uint32_t dimension) {
+    switch (type) {
+    case SamplerType::Hash: {
+        float seed = static_cast<float>(index);
+        return vec2(Rand(x + seed * 0.7548777f, y + seed * 0.7548777f),
+                    Rand(x + seed * 0.5698403f + 17.0f, y + seed * 0.5698403f + 17.0f));
+    }
+    case SamplerType::R2: {
+        uint32_t seed = HashPixel(x, y, dimension);
+        return vec2(ToUnit(HashUint(seed) + index * kR2X), ToUnit(HashUint(seed + 1u) + index * kR2Y));
+    }
+    case SamplerType::Sobol: {
+        uint32_t seed = HashPixel(x, y, dimension);
+        uint32_t shuffled = NestedUniformScramble(index, seed);
+        uint32_t sx = NestedUniformScramble(ReverseBits(shuffled), HashUint(seed));
+        uint32_t sy = NestedUniformScramble(SobolSecond(shuffled), HashUint(seed + 1u));
+        return vec2(ToUnit(sx), ToUnit(sy));
+    }
+    case SamplerType::BlueNoise: {
+        uint32_t shift = HashUint(dimension);
+        uint32_t tx = (static_cast<uint32_t>(x) + shift) & (BlueNoise::kSize - 1);
+        uint32_t ty = (static_cast<uint32_t>(y) + (shift >> 8)) & (BlueNoise::kSize - 1);
+        vec2 noise = BlueNoise::Get()[ty * BlueNoise::kSize + tx];
+        uint32_t ox = static_cast<uint32_t>(noise.x * 16777216.0f) << 8;
+        uint32_t oy = static_cast<uint32_t>(noise.y * 16777216.0f) << 8;
+        return vec2(ToUnit(ox + index * kR2X), ToUnit(oy + index * kR2Y));
+    }
+    }
+    return vec2(0.5f);
+}
+}   // namespace SimpleDrawingDemo
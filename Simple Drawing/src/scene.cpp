@@ -0,0 +1,442 @@
+// src/scene.cpp
+#include "pch.h"
+#include "scene.h"
+#include "thread_pool.h"
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace SimpleDrawingDemo {
+
+Scene::~Scene() {
+    Release();
+}
+
+void Scene::Clear() {
+    centerRadius.clear();
+    colorSpecular.clear();
+    reflectivity.clear();
+    emission.clear();
+    lights.clear();
+    triangleVertices.clear();
+    triangleShading.clear();
+    meshes.clear();
+    dirtyCenterRadius.Clear();
+    dirtyMaterials.Clear();
+    dirtyTriangles.Clear();
+    dirtyLights = false;
+}
+
+int Scene::AddSphere(const vec3& center, float radius, const vec3& color,
+    float specular, float reflect, float emit)
+{
+    if (colorSpecular.size() != centerRadius.size()) {
+        std::cerr << "[ERROR_SCENE] 球体必须在网格之前添加" << std::endl;
+        return -1;
+    }
+
+    int index = SphereCount();
+    centerRadius.push_back(vec4(center, radius));
+    colorSpecular.push_back(vec4(color, specular));
+    reflectivity.push_back(reflect);
+    emission.push_back(emit);
+    if (emit > 0.0f) lights.push_back(index);
+    return index;
+}
+
+namespace {
+// 单位法线的八面体编码, 两个分量按snorm16打包(与GLSL unpackSnorm2x16一致, x在低16位)
+uint32_t PackNormal(vec3 n) {
+    n = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    float x = n.x, y = n.y;
+    if (n.z < 0.0f) {
+        x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    auto snorm = [](float v) {
+        int q = static_cast<int>(std::round(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+        return static_cast<uint32_t>(static_cast<uint16_t>(static_cast<int16_t>(q)));
+    };
+    return snorm(x) | (snorm(y) << 16);
+}
+
+// 每个任务转换的三角形数
+constexpr int kTriangleBatch = 16384;
+
+// 间隔不超过该字节数的脏范围合并为一次复制
+constexpr size_t kCoalesceGapBytes = 256;
+
+// 三角形记录(v0, e1, e2)的包围盒
+void TriangleBounds(const vec4* tri, vec3& boundsMin, vec3& boundsMax) {
+    vec3 v0(tri[0].x, tri[0].y, tri[0].z);
+    vec3 v1 = v0 + vec3(tri[1].x, tri[1].y, tri[1].z);
+    vec3 v2 = v0 + vec3(tri[2].x, tri[2].y, tri[2].z);
+    boundsMin = glm::min(v0, glm::min(v1, v2));
+    boundsMax = glm::max(v0, glm::max(v1, v2));
+}
+}
+
+int Scene::AddMesh(const Mesh& mesh, const vec3& position, const vec3& scale, const vec3& color,
+    float specular, float reflect, float emit)
+{
+    const vec3* positions = mesh.Positions();
+    const vec3* normals = mesh.Normals();
+    const uint32_t* indices = mesh.Indices();
+    const uint32_t* normalIndices = mesh.NormalIndices();
+    size_t first = triangleShading.size();
+    int count = static_cast<int>(mesh.TriangleCount());
+    int material = static_cast<int>(colorSpecular.size());
+    triangleVertices.resize((first + count) * 3);
+    triangleShading.resize(first + count);
+
+    // 逐三角形转换到世界空间并预先算好两条边(缓存中的索引同样检查越界, 损坏的缓存不会越界读)
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::atomic<bool> outOfRange{ false };
+    vec3 normalScale = vec3(1.0f) / scale;   // 缩放的逆转置
+    ThreadPool::Shared().ParallelFor((count + kTriangleBatch - 1) / kTriangleBatch, [&](int batch) {
+        int end = std::min(count, (batch + 1) * kTriangleBatch);
+        for (int t = batch * kTriangleBatch; t < end; t++) {
+            const uint32_t* tri = &indices[size_t(t) * 3];
+            if (tri[0] >= mesh.PositionCount() || tri[1] >= mesh.PositionCount() || tri[2] >= mesh.PositionCount()) {
+                outOfRange = true;
+                continue;
+            }
+            vec3 v0 = positions[tri[0]] * scale + position;
+            vec3 e1 = positions[tri[1]] * scale + position - v0;
+            vec3 e2 = positions[tri[2]] * scale + position - v0;
+            vec4* out = &triangleVertices[(first + t) * 3];
+            out[0] = vec4(v0, 0.0f);
+            out[1] = vec4(e1, 0.0f);
+            out[2] = vec4(e2, 0.0f);
+
+            // 顶点法线缺省时使用几何法线(退化三角形取+Y)
+            vec3 geometric = glm::cross(e1, e2);
+            float area = glm::length(geometric);
+            geometric = area > 0.0f ? geometric / area : vec3(0.0f, 1.0f, 0.0f);
+            uint32_t packed[3];
+            for (int k = 0; k < 3; k++) {
+                vec3 n = geometric;
+                uint32_t normalIndex = normalIndices ? normalIndices[size_t(t) * 3 + k] : Mesh::kNoNormal;
+                if (normalIndex < mesh.NormalCount()) {
+                    n = normals[normalIndex] * normalScale;
+                    float length = glm::length(n);
+                    n = length > 0.0f ? n / length : geometric;
+                }
+                packed[k] = PackNormal(n);
+            }
+            triangleShading[first + t] = glm::uvec4(packed[0], packed[1], packed[2], static_cast<uint32_t>(material));
+        }
+    });
+
+    if (outOfRange) {
+        std::cerr << "[ERROR_SCENE] 网格索引越界: " << mesh.Stats().path << std::endl;
+        triangleVertices.resize(first * 3);
+        triangleShading.resize(first);
+        return -1;
+    }
+
+    colorSpecular.push_back(vec4(color, specular));
+    reflectivity.push_back(reflect);
+    emission.push_back(emit);
+    MeshLoadStats stats = mesh.Stats();
+    stats.convertMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    meshes.push_back(stats);
+    return material;
+}
+
+void Scene::LoadDefault() {
+    Clear();
+    AddSphere(vec3(0.0f, 0.0f, -5.0f), 1.0f, vec3(1.0f, 0.0f, 0.0f), 32.0f, 0.3f);       // 红色球
+    AddSphere(vec3(-2.0f, 1.0f, -6.0f), 1.0f, vec3(0.0f, 1.0f, 0.0f), 64.0f, 0.5f);      // 绿色球
+    AddSphere(vec3(2.0f, -1.0f, -7.0f), 1.0f, vec3(0.0f, 0.0f, 1.0f), 128.0f, 0.7f);     // 蓝色球
+    AddSphere(vec3(0.0f, -101.0f, -5.0f), 100.0f, vec3(0.8f, 0.8f, 0.8f), 16.0f, 0.2f);  // 地面
+    AddSphere(vec3(0.0f, 5.0f, -10.0f), 1.5f, vec3(1.0f, 1.0f, 0.8f), 256.0f, 0.1f, 5.0f); // 光源
+    BuildBvh();
+}
+
+void Scene::LoadRandom(int count, unsigned int seed) {
+    Clear();
+    AddSphere(vec3(0.0f, -101.0f, -5.0f), 100.0f, vec3(0.8f, 0.8f, 0.8f), 16.0f, 0.2f);    // 地面
+    AddSphere(vec3(0.0f, 15.0f, -20.0f), 3.0f, vec3(1.0f, 1.0f, 0.8f), 256.0f, 0.1f, 5.0f); // 光源
+
+    // 在相机前方的体积内随机分布小球
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float extent = std::cbrt(static_cast<float>(std::max(count, 1))) * 0.6f;
+    for (int i = 0; i < count; i++) {
+        vec3 center(
+            (unit(rng) - 0.5f) * 2.0f * extent,
+            unit(rng) * extent * 0.5f,
+            -5.0f - unit(rng) * 2.0f * extent
+        );
+        vec3 color(unit(rng), unit(rng), unit(rng));
+        AddSphere(center, 0.1f + 0.2f * unit(rng), color, 8.0f + 120.0f * unit(rng), 0.5f * unit(rng));
+    }
+
+    std::cout << "[SCENE] 已生成随机场景: " << SphereCount() << " 个球体" << std::endl;
+    BuildBvh();
+}
+
+void Scene::BuildBvh() {
+    size_t sphereCount = centerRadius.size();
+    std::vector<vec3> boundsMin(PrimitiveCount()), boundsMax(PrimitiveCount());
+    for (size_t i = 0; i < sphereCount; i++) {
+        vec3 c(centerRadius[i].x, centerRadius[i].y, centerRadius[i].z);
+        vec3 r(centerRadius[i].w);
+        boundsMin[i] = c - r;
+        boundsMax[i] = c + r;
+    }
+    for (size_t t = 0; t < triangleShading.size(); t++) {
+        TriangleBounds(&triangleVertices[t * 3], boundsMin[sphereCount + t], boundsMax[sphereCount + t]);
+    }
+    bvh.Build(boundsMin, boundsMax);
+
+    const auto& s = bvh.stats;
+    std::cout << "[BVH] 图元 " << s.primitiveCount << ", 节点 " << s.nodeCount
+              << ", 叶子 " << s.leafCount << ", 最大深度 " << s.maxDepth
+              << ", SAH代价 " << s.sahCost << ", 构建耗时 " << s.buildMs << " ms" << std::endl;
+}
+
+// 读取JSON中的三维向量
+static vec3 ReadVec3(const nlohmann::json& j, const char* key, const vec3& fallback) {
+    if (!j.contains(key)) return fallback;
+    const auto& a = j.at(key);
+    if (!a.is_array() || a.size() != 3) return fallback;
+    return vec3(a.at(0).get<float>(), a.at(1).get<float>(), a.at(2).get<float>());
+}
+
+bool Scene::LoadFromJson(const string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "[ERROR_SCENE] 无法打开场景文件: " << path << std::endl;
+        return false;
+    }
+
+    nlohmann::json root;
+    try {
+        root = nlohmann::json::parse(file);
+    } catch (std::exception& e) {
+        std::cerr << "[ERROR_SCENE] 场景文件解析失败: " << path << std::endl;
+        std::cerr << "错误信息: " << e.what() << std::endl;
+        return false;
+    }
+
+    bool hasSpheres = root.contains("spheres") && root["spheres"].is_array();
+    bool hasMeshes = root.contains("meshes") && root["meshes"].is_array();
+    if (!hasSpheres && !hasMeshes) {
+        std::cerr << "[ERROR_SCENE] 场景文件缺少spheres或meshes数组: " << path << std::endl;
+        return false;
+    }
+
+    // 先加载全部网格(Load成功即保证索引有效, AddMesh不会失败), 任何一个失败都保持原场景不变
+    static const nlohmann::json empty = nlohmann::json::array();
+    const auto& meshList = hasMeshes ? root["meshes"] : empty;
+    std::vector<std::unique_ptr<Mesh>> loadedMeshes;
+    for (const auto& m : meshList) {
+        fs::path file = m.value("file", string());
+        if (file.is_relative()) file = fs::path(path).parent_path() / file;
+        loadedMeshes.push_back(std::make_unique<Mesh>());
+        if (!loadedMeshes.back()->Load(file.string())) return false;
+    }
+
+    Clear();
+    const auto& spheres = hasSpheres ? root["spheres"] : empty;
+    centerRadius.reserve(spheres.size());
+    colorSpecular.reserve(spheres.size() + meshList.size());
+    reflectivity.reserve(spheres.size() + meshList.size());
+    emission.reserve(spheres.size() + meshList.size());
+
+    for (const auto& s : spheres) {
+        AddSphere(
+            ReadVec3(s, "center", vec3(0.0f)),
+            s.value("radius", 1.0f),
+            ReadVec3(s, "color", vec3(1.0f)),
+            s.value("specular", 32.0f),
+            s.value("reflectivity", 0.0f),
+            s.value("emission", 0.0f)
+        );
+    }
+
+    for (size_t i = 0; i < meshList.size(); i++) {
+        const auto& m = meshList[i];
+        // scale可以是单个数或三维向量
+        vec3 scale = m.contains("scale") && m["scale"].is_number() ? vec3(m["scale"].get<float>()) : ReadVec3(m, "scale", vec3(1.0f));
+        AddMesh(*loadedMeshes[i],
+            ReadVec3(m, "position", vec3(0.0f)),
+            scale,
+            ReadVec3(m, "color", vec3(1.0f)),
+            m.value("specular", 32.0f),
+            m.value("reflectivity", 0.0f),
+            m.value("emission", 0.0f)
+        );
+    }
+
+    std::cout << "[SCENE] 已加载 " << path << ": " << SphereCount() << " 个球体, "
+              << TriangleCount() << " 个三角形, " << LightCount() << " 个光源" << std::endl;
+    BuildBvh();
+    return true;
+}
+
+// 创建或更新单个SSBO(空数组时保留一个元素, 避免绑定零大小缓冲)
+template <typename T>
+static void UploadArray(unsigned int& buffer, const std::vector<T>& values) {
+    if (!buffer) glCreateBuffers(1, &buffer);
+    static const T empty{};
+    const T* ptr = values.empty() ? &empty : values.data();
+    size_t size = std::max<size_t>(values.size(), 1) * sizeof(T);
+    glNamedBufferData(buffer, size, ptr, GL_STATIC_DRAW);
+}
+
+void Scene::Upload() {
+    dirtyCenterRadius.Clear();
+    dirtyMaterials.Clear();
+    dirtyTriangles.Clear();
+    dirtyLights = false;
+    UploadArray(buffers[0], centerRadius);
+    UploadArray(buffers[1], colorSpecular);
+    UploadArray(buffers[2], reflectivity);
+    UploadArray(buffers[3], emission);
+    UploadArray(buffers[4], lights);
+    UploadArray(triangleBuffers[0], triangleVertices);
+    UploadArray(triangleBuffers[1], triangleShading);
+    bvh.Upload();
+}
+
+/* ------- 动态更新 ------- */
+
+void SceneUpdateStats::Add(const SceneUpdateStats& other) {
+    frames += other.frames;
+    primitives += other.primitives;
+    ranges += other.ranges;
+    bytes += other.bytes;
+    refitNodes += other.refitNodes;
+    rebuilds += other.rebuilds;
+    updateMs += other.updateMs;
+}
+
+nlohmann::json SceneUpdateStats::ToJson() const {
+    nlohmann::json j;
+    j["frames"] = frames;
+    j["primitives"] = primitives;
+    j["ranges"] = ranges;
+    j["bytes"] = bytes;
+    j["refit_nodes"] = refitNodes;
+    j["rebuilds"] = rebuilds;
+    j["update_ms"] = updateMs;
+    return j;
+}
+
+void Scene::SetSphere(int index, const vec3& center, float radius) {
+    centerRadius[index] = vec4(center, radius);
+    dirtyCenterRadius.Add(index);
+    bvh.UpdatePrimitive(index, center - vec3(radius), center + vec3(radius));
+}
+
+void Scene::SetTriangle(int index, const vec3& v0, const vec3& v1, const vec3& v2) {
+    vec4* tri = &triangleVertices[size_t(index) * 3];
+    tri[0] = vec4(v0, 0.0f);
+    tri[1] = vec4(v1 - v0, 0.0f);
+    tri[2] = vec4(v2 - v0, 0.0f);
+    dirtyTriangles.Add(size_t(index) * 3, 3);
+
+    vec3 boundsMin, boundsMax;
+    TriangleBounds(tri, boundsMin, boundsMax);
+    bvh.UpdatePrimitive(SphereCount() + index, boundsMin, boundsMax);
+}
+
+void Scene::SetMaterial(int index, const vec3& color, float specular, float reflect, float emit) {
+    bool wasLight = emission[index] > 0.0f;
+    colorSpecular[index] = vec4(color, specular);
+    reflectivity[index] = reflect;
+    emission[index] = emit;
+    dirtyMaterials.Add(index);
+
+    // 球体的发光状态改变时重建光源列表
+    if (index < SphereCount() && wasLight != (emit > 0.0f)) {
+        lights.clear();
+        for (int i = 0; i < SphereCount(); i++) {
+            if (emission[i] > 0.0f) lights.push_back(i);
+        }
+        dirtyLights = true;
+    }
+}
+
+bool Scene::Update(StagingBuffer* staging) {
+    if (bvh.DirtyCount() == 0 && dirtyCenterRadius.Empty() && dirtyMaterials.Empty() && dirtyTriangles.Empty() && !dirtyLights) {
+        return false;
+    }
+    auto startTime = std::chrono::high_resolution_clock::now();
+    SceneUpdateStats frame;
+    frame.frames = 1;
+    frame.primitives = bvh.DirtyCount();
+
+    // BVH只refit改动图元的祖先; 物体移动使树的质量退化过多时完整重建
+    const std::vector<int>& refitNodes = bvh.Refit(&ThreadPool::Shared());
+    frame.refitNodes = static_cast<int>(refitNodes.size());
+    bool rebuilt = bvh.NeedsRebuild();
+    if (rebuilt) {
+        std::cout << "[BVH] refit后SAH代价 " << bvh.SahCost() << " 超过构建时 " << bvh.stats.sahCost
+                  << " 的 " << Bvh::kRebuildThreshold << " 倍, 重新构建" << std::endl;
+        BuildBvh();
+        frame.rebuilds = 1;
+    }
+
+    if (staging) {
+        auto upload = [&](unsigned int buffer, const DirtyRanges& ranges, const void* data, size_t stride) {
+            for (const DirtyRanges::Range& range : ranges.Coalesce(std::max<size_t>(1, kCoalesceGapBytes / stride))) {
+                staging->Upload(buffer, range.first * stride, static_cast<const char*>(data) + range.first * stride, range.count * stride);
+                frame.ranges++;
+                frame.bytes += range.count * stride;
+            }
+        };
+        upload(buffers[0], dirtyCenterRadius, centerRadius.data(), sizeof(vec4));
+        upload(buffers[1], dirtyMaterials, colorSpecular.data(), sizeof(vec4));
+        upload(buffers[2], dirtyMaterials, reflectivity.data(), sizeof(float));
+        upload(buffers[3], dirtyMaterials, emission.data(), sizeof(float));
+        upload(triangleBuffers[0], dirtyTriangles, triangleVertices.data(), sizeof(vec4));
+        if (dirtyLights) {
+            UploadArray(buffers[4], lights);   // 长度可能变化, 整体上传(光源数很少)
+            frame.ranges++;
+            frame.bytes += lights.size() * sizeof(int);
+        }
+        if (rebuilt) {
+            bvh.Upload();
+            frame.ranges += 2;
+            frame.bytes += bvh.nodes.size() * sizeof(BvhNode) + bvh.primIndices.size() * sizeof(int);
+        } else {
+            DirtyRanges nodeRanges;
+            for (int node : refitNodes) nodeRanges.Add(node);
+            upload(bvh.nodeBuffer, nodeRanges, bvh.nodes.data(), sizeof(BvhNode));
+        }
+    }
+
+    dirtyCenterRadius.Clear();
+    dirtyMaterials.Clear();
+    dirtyTriangles.Clear();
+    dirtyLights = false;
+    frame.updateMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    updateStats.Add(frame);
+    return true;
+}
+
+void Scene::Bind() const {
+    for (int i = 0; i < SCENE_BINDING_COUNT; i++) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SCENE_BINDING_CENTER_RADIUS + i, buffers[i]);
+    }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_BINDING_TRIANGLES, triangleBuffers[0]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_BINDING_TRIANGLE_SHADING, triangleBuffers[1]);
+    bvh.Bind();
+}
+
+void Scene::Release() {
+    if (buffers[0]) {
+        glDeleteBuffers(SCENE_BINDING_COUNT, buffers);
+        for (auto& b : buffers) b = 0;
+    }
+    if (triangleBuffers[0]) {
+        glDeleteBuffers(2, triangleBuffers);
+        triangleBuffers[0] = triangleBuffers[1] = 0;
+    }
+    bvh.Release();
+}
+}   // namespace SimpleDrawingDemo
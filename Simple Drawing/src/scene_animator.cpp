@@ -0,0 +1,36 @@
+// src/scene_animator.cpp
+#include "pch.h"
+#include "scene_animator.h"
+#include "scene.h"
+#include "simulation.h"
+
+namespace SimpleDrawingDemo {
+
+SceneAnimator::SceneAnimator(const Scene& scene, float fraction) {
+    for (int i = 0; i < scene.SphereCount(); i++) {
+        const vec4& base = scene.centerRadius[i];
+        if (scene.emission[i] > 0.0f) {
+            m_lights.push_back({ i, base, 0.0f });
+            continue;
+        }
+        if (base.w > kMaxRadius) continue;
+
+        // 按索引的黄金比例序列选取, 浮动的球体在场景中均匀分布
+        float key = std::fmod(i * 0.6180339887f, 1.0f);
+        if (key < fraction) m_spheres.push_back({ i, base, key * 6.2831853f });
+    }
+    std::cout << "[ANIMATE] " << m_spheres.size() << " 个球体浮动, " << m_lights.size() << " 个光源随lightPos移动" << std::endl;
+}
+
+void SceneAnimator::Apply(Scene& scene, float time, const vec3& lightPos) const {
+    // 光源保持与初始位置的相对关系: 偏移量为lightPos相对0时刻的位移
+    vec3 lightOffset = lightPos - Simulation::LightPosition(0.0f);
+    for (const AnimatedSphere& light : m_lights) {
+        scene.SetSphere(light.index, vec3(light.base.x, light.base.y, light.base.z) + lightOffset, light.base.w);
+    }
+    for (const AnimatedSphere& sphere : m_spheres) {
+        vec3 center(sphere.base.x, sphere.base.y + kAmplitude * std::sin(time * 2.0f + sphere.phase), sphere.base.z);
+        scene.SetSphere(sphere.index, center, sphere.base.w);
+    }
+}
+}   // namespace SimpleDrawingDemo
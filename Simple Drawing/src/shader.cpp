@@ -1,11 +1,54 @@
 // src/shader.cpp
 #include "pch.h"
 #include "shader.h"
+#include "shader_cache.h"
 
 using ifs = std::ifstream;
 
 namespace SimpleDrawingDemo {
 
+namespace {
+// 递归展开#include; 源字符串编号(#line的第二个参数)按首次出现的顺序分配, 0为主文件
+string ExpandIncludes(const std::filesystem::path& path, std::vector<string>& files, std::vector<string>* includes) {
+    string source = Shader::Load(path.string());
+    int fileIndex = static_cast<int>(files.size()) - 1;
+
+    string result;
+    std::istringstream stream(source);
+    string line;
+    int lineNumber = 0;
+    while (std::getline(stream, line)) {
+        lineNumber++;
+        size_t begin = line.find_first_not_of(" \t");
+        if (begin == string::npos || line.compare(begin, 8, "#include") != 0) {
+            result += line + '\n';
+            continue;
+        }
+
+        size_t open = line.find('"', begin);
+        size_t close = open == string::npos ? string::npos : line.find('"', open + 1);
+        if (close == string::npos) {
+            std::cerr << "[ERROR_SHADER] 无效的#include (" << path.string() << ":" << lineNumber << ")" << std::endl;
+            result += '\n';
+            continue;
+        }
+
+        // 同一文件只展开一次(等同#pragma once)
+        std::filesystem::path included = (path.parent_path() / line.substr(open + 1, close - open - 1)).lexically_normal();
+        if (std::find(files.begin(), files.end(), included.string()) == files.end()) {
+            files.push_back(included.string());
+            if (includes) includes->push_back(included.string());
+            result += "#line 1 " + std::to_string(files.size() - 1) + '\n';
+            result += ExpandIncludes(included, files, includes);
+            result += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + '\n';
+        } else {
+            result += '\n';
+        }
+    }
+    return result;
+}
+}
+
 /* ------- 静态成员与方法 ------- */
 
 // 解析着色器文件
@@ -25,10 +68,21 @@ string Shader::Load(const string& path) {
     return code;
 }
 
-// 编译着色器
-unsigned int Shader::Compile(const string& path, GLenum type) {
-    string codeStr = Load(path);
-    const char* code = codeStr.c_str();
+// 读取着色器文件并展开#include "相对路径"; includes非空时追加被包含的文件路径
+string Shader::Preprocess(const string& path, std::vector<string>* includes) {
+    std::filesystem::path root = std::filesystem::path(path).lexically_normal();
+    std::vector<string> files = { root.string() };
+    return ExpandIncludes(root, files, includes);
+}
+
+// 编译着色器(defines插入#version之后, 同一源码可编译出不同变体)
+unsigned int Shader::Compile(const string& path, GLenum type, const string& defines) {
+    return CompileSource(InjectDefines(Preprocess(path), defines), path, type);
+}
+
+// 编译着色器源码(path仅用于错误信息)
+unsigned int Shader::CompileSource(const string& source, const string& path, GLenum type) {
+    const char* code = source.c_str();
 
     // 编译着色器
     unsigned int shader = glCreateShader(type);
@@ -47,13 +101,42 @@ unsigned int Shader::Compile(const string& path, GLenum type) {
     return shader;
 }
 
-// 创建计算着色器程序
-unsigned int Shader::CreateComputeShader(const string& path) {
-    unsigned int computeShader = Compile(path, GL_COMPUTE_SHADER);
+// 在#version行之后插入宏定义(#version必须是第一条指令), 之后用#line恢复主文件的行号
+string Shader::InjectDefines(const string& source, const string& defines) {
+    if (defines.empty()) return source;
+
+    size_t version = source.find("#version");
+    size_t insertAt = version == string::npos ? 0 : source.find('\n', version);
+    insertAt = insertAt == string::npos ? source.size() : insertAt + 1;
+    auto nextLine = std::count(source.begin(), source.begin() + insertAt, '\n') + 1;
+    string block = defines;
+    if (block.back() != '\n') block += '\n';
+    block += "#line " + std::to_string(nextLine) + " 0\n";
+    return source.substr(0, insertAt) + block + source.substr(insertAt);
+}
+
+// 构建着色器程序: 优先从程序二进制缓存加载, 未命中时编译链接并写入缓存
+unsigned int Shader::Build(const std::vector<std::pair<GLenum, string>>& stages, const string& defines) {
+    std::vector<std::pair<GLenum, string>> sources;
+    for (const auto& [type, path] : stages) {
+        sources.push_back({ type, InjectDefines(Preprocess(path), defines) });
+    }
+
+    uint64_t key = ShaderCache::Key(sources, defines);
+    if (unsigned int program = ShaderCache::Load(key)) return program;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
     
-    // 创建着色器程序
+    // 编译并附加着色器
     unsigned int program = glCreateProgram();
-    glAttachShader(program, computeShader);
+    std::vector<unsigned int> shaders;
+    for (size_t i = 0; i < stages.size(); i++) {
+        shaders.push_back(CompileSource(sources[i].second, stages[i].second, stages[i].first));
+        glAttachShader(program, shaders.back());
+    }
+    
+    // 链接程序(允许之后取回二进制)
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program);
     
     // 检查链接错误
@@ -62,13 +145,27 @@ unsigned int Shader::CreateComputeShader(const string& path) {
     glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(program, 512, NULL, infoLog);
-        std::cerr << "计算着色器链接错误:\n" << infoLog << std::endl;
+        std::cerr << "着色器程序链接错误 (" << stages.front().second << "):\n" << infoLog << std::endl;
     }
     
-    glDeleteShader(computeShader);
+    // 清理着色器对象
+    for (auto shader : shaders) {
+        glDeleteShader(shader);
+    }
+
+    ShaderCache::s_stats.compileMs += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+
+    // 只缓存链接成功的程序
+    if (success) ShaderCache::Store(key, program);
     return program;
 }
 
+// 创建计算着色器程序
+unsigned int Shader::CreateComputeShader(const string& path, const string& defines) {
+    return Build({ { GL_COMPUTE_SHADER, path } }, defines);
+}
+
 // 创建着色器程序
 unsigned int Shader::Create(
     const string& vsh_path, const string& fsh_path,
@@ -80,39 +177,72 @@ unsigned int Shader::Create(
         return 0;
     }
 
+    // 收集各阶段
+    std::vector<std::pair<GLenum, string>> stages;
+    if(!vsh_path.empty()) stages.push_back({ GL_VERTEX_SHADER, vsh_path });
+    if(!fsh_path.empty()) stages.push_back({ GL_FRAGMENT_SHADER, fsh_path });
+    if(!geo_path.empty()) stages.push_back({ GL_GEOMETRY_SHADER, geo_path });
+    if(!csh_path.empty()) stages.push_back({ GL_COMPUTE_SHADER, csh_path });
+    
     // 创建着色器程序
-    s_programID = glCreateProgram(); 
-    std::vector<unsigned int> shaders;
+    s_programID = Build(stages);
+    return s_programID;
+}
 
-    // 编译着色器
-    if(!vsh_path.empty()) shaders.push_back(Compile(vsh_path, GL_VERTEX_SHADER));
-    if(!fsh_path.empty()) shaders.push_back(Compile(fsh_path, GL_FRAGMENT_SHADER));
-    if(!geo_path.empty()) shaders.push_back(Compile(geo_path, GL_GEOMETRY_SHADER));
-    if(!csh_path.empty()) shaders.push_back(Compile(csh_path, GL_COMPUTE_SHADER));
-    
-    // 附加着色器
-    for(auto shader : shaders) {
-        glAttachShader(s_programID, shader);
-    }
-    
-    // 链接程序
-    glLinkProgram(s_programID);
-    
-    // 检查链接错误
-    int success;
-    char infoLog[512];
-    glGetProgramiv(s_programID, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(s_programID, 512, NULL, infoLog);
-        std::cerr << "着色器程序链接错误:\n" << infoLog << std::endl;
-    }
-    
-    // 清理着色器对象
-    for(auto shader : shaders) {
-        glDeleteShader(shader);
+// 反射程序的活动uniform与接口块
+ProgramReflection Shader::Reflect(unsigned int program) {
+    ProgramReflection result;
+    if (!program) return result;
+
+    auto resourceName = [&](GLenum interface, int index, int length) {
+        string name(length, '\0');
+        glGetProgramResourceName(program, interface, index, length, nullptr, name.data());
+        name.resize(length > 0 ? length - 1 : 0);   // 去掉结尾的'\0'
+        return name;
+    };
+
+    // 普通uniform(块内成员的GL_BLOCK_INDEX不为-1, 跳过)
+    int count = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+    const GLenum uniformProps[] = { GL_NAME_LENGTH, GL_LOCATION, GL_BLOCK_INDEX };
+    for (int i = 0; i < count; i++) {
+        int values[3];
+        glGetProgramResourceiv(program, GL_UNIFORM, i, 3, uniformProps, 3, nullptr, values);
+        if (values[2] != -1) continue;
+
+        string name = resourceName(GL_UNIFORM, i, values[0]);
+        result.uniforms[name] = values[1];
+        // 数组同时登记不带"[0]"的名称, 与glGetUniformLocation行为一致
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            result.uniforms[name.substr(0, name.size() - 3)] = values[1];
+        }
     }
-    
-    return s_programID;
+
+    // 接口块
+    auto reflectBlocks = [&](GLenum interface, std::unordered_map<string, BlockInfo>& blocks) {
+        int blockCount = 0;
+        glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &blockCount);
+        const GLenum blockProps[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+        for (int i = 0; i < blockCount; i++) {
+            int values[3];
+            glGetProgramResourceiv(program, interface, i, 3, blockProps, 3, nullptr, values);
+            blocks[resourceName(interface, i, values[0])] = { i, values[1], values[2] };
+        }
+    };
+    reflectBlocks(GL_UNIFORM_BLOCK, result.uniformBlocks);
+    reflectBlocks(GL_SHADER_STORAGE_BLOCK, result.storageBlocks);
+
+    return result;
+}
+
+int ProgramReflection::Location(const string& name) const {
+    auto it = uniforms.find(name);
+    return it != uniforms.end() ? it->second : -1;
+}
+
+const BlockInfo* ProgramReflection::UniformBlock(const string& name) const {
+    auto it = uniformBlocks.find(name);
+    return it != uniformBlocks.end() ? &it->second : nullptr;
 }
 
 
@@ -124,37 +254,37 @@ void Shader::Use() const {
 
 // uniform int
 void Shader::SetUniform1i(const string& name, int value) const {
-    GLint location = glGetUniformLocation(s_programID, name.c_str());
+    GLint location = reflection.Location(name);
     glUniform1i(location, value);
 }
 
 // uniform float
 void Shader::SetUniform1f(const string& name, float value) const {
-    GLint location = glGetUniformLocation(s_programID, name.c_str());
+    GLint location = reflection.Location(name);
     glUniform1f(location, value);
 }
 
 // uniform vec2
 void Shader::SetUniform2f(const string& name, const vec2& vector) const {
-    GLint location = glGetUniformLocation(s_programID, name.c_str());
+    GLint location = reflection.Location(name);
     glUniform2fv(location, 1, &vector[0]);
 }
 
 // uniform vec3
 void Shader::SetUniform3f(const string& name, const vec3& vector) const {
-    GLint location = glGetUniformLocation(s_programID, name.c_str());
+    GLint location = reflection.Location(name);
     glUniform3fv(location, 1, &vector[0]);
 }
 
 // uniform vec4
 void Shader::SetUniform4f(const string& name, const vec4& vector) const {
-    GLint location = glGetUniformLocation(s_programID, name.c_str());
+    GLint location = reflection.Location(name);
     glUniform4fv(location, 1, &vector[0]);
 }
 
 // uniform Matix 4x4
-void Shader::SetUniformMat4(const string& name, const mat4& matrix) {
-    GLint location = glGetUniformLocation(s_programID, name.c_str());
+void Shader::SetUniformMat4(const string& name, const mat4& matrix) const {
+    GLint location = reflection.Location(name);
     glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]);
 }
 } // namespace SimpleDrawingDemo
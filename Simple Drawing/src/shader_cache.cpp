@@ -0,0 +1,153 @@
+// src/shader_cache.cpp
+#include "pch.h"
+#include "shader_cache.h"
+#include <cstring>
+
+namespace SimpleDrawingDemo {
+
+namespace {
+// 缓存文件头
+struct CacheHeader {
+    char magic[4];       // "SDPB"
+    uint32_t version;    // 文件格式版本
+    uint64_t key;        // 与文件名一致, 防止哈希截断或改名造成误用
+    uint32_t format;     // glGetProgramBinary返回的二进制格式
+    uint32_t length;     // 二进制长度(字节)
+};
+constexpr uint32_t kCacheVersion = 1;
+
+// FNV-1a 64位哈希
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+void HashString(uint64_t& hash, const string& text) {
+    uint64_t length = text.size();
+    HashBytes(hash, &length, sizeof(length));   // 带上长度, 避免拼接歧义
+    HashBytes(hash, text.data(), text.size());
+}
+
+string GLString(GLenum name) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    return value ? value : "";
+}
+}
+
+nlohmann::json ShaderCacheStats::ToJson() const {
+    nlohmann::json json;
+    json["hits"] = hits;
+    json["misses"] = misses;
+    json["rejected"] = rejected;
+    json["compile_ms"] = compileMs;
+    json["load_ms"] = loadMs;
+    return json;
+}
+
+uint64_t ShaderCache::Key(const std::vector<std::pair<GLenum, string>>& stages, const string& defines) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto& [type, source] : stages) {
+        uint32_t stageType = type;
+        HashBytes(hash, &stageType, sizeof(stageType));
+        HashString(hash, source);
+    }
+    HashString(hash, defines);
+    HashString(hash, GLString(GL_VENDOR));
+    HashString(hash, GLString(GL_RENDERER));
+    HashString(hash, GLString(GL_VERSION));
+    HashString(hash, GLString(GL_SHADING_LANGUAGE_VERSION));
+    return hash;
+}
+
+string ShaderCache::PathOf(uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return s_directory + name;
+}
+
+unsigned int ShaderCache::Load(uint64_t key) {
+    if (!s_enabled) return 0;
+
+    std::ifstream file(PathOf(key), std::ios::binary);
+    if (!file) {
+        s_stats.misses++;
+        return 0;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    CacheHeader header = {};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::vector<char> binary;
+    bool valid = file && std::memcmp(header.magic, "SDPB", 4) == 0 &&
+        header.version == kCacheVersion && header.key == key;
+    if (valid) {
+        // 长度字段来自磁盘, 先与剩余文件大小比较, 避免损坏的文件触发超大分配
+        std::streampos body = file.tellg();
+        file.seekg(0, std::ios::end);
+        std::streamoff remaining = file.tellg() - body;
+        file.seekg(body);
+        valid = file && remaining >= 0 && static_cast<uint64_t>(remaining) >= header.length;
+    }
+    if (valid) {
+        binary.resize(header.length);
+        file.read(binary.data(), binary.size());
+        valid = static_cast<bool>(file);
+    }
+    if (!valid) {
+        std::cerr << "[SHADER_CACHE] 缓存文件损坏, 重新编译: " << PathOf(key) << std::endl;
+        s_stats.rejected++;
+        return 0;
+    }
+
+    // 驱动可能拒绝(例如驱动已更新但版本字符串未变), 此时回退编译
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        s_stats.rejected++;
+        return 0;
+    }
+
+    s_stats.hits++;
+    s_stats.loadMs += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    return program;
+}
+
+void ShaderCache::Store(uint64_t key, unsigned int program) {
+    if (!s_enabled) return;
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;   // 驱动不支持程序二进制
+
+    CacheHeader header = { { 'S', 'D', 'P', 'B' }, kCacheVersion, key, 0, 0 };
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    header.format = format;
+    header.length = static_cast<uint32_t>(length);
+
+    // 先写临时文件再改名, 避免中断时留下半个缓存文件
+    std::error_code error;
+    std::filesystem::create_directories(s_directory, error);
+    string path = PathOf(key);
+    string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            std::cerr << "[SHADER_CACHE] 写入失败: " << tempPath << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) std::cerr << "[SHADER_CACHE] 写入失败: " << path << " (" << error.message() << ")" << std::endl;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,264 @@
+// src/shader_reloader.cpp
+#include "pch.h"
+#include "shader_reloader.h"
+#include "shader.h"
+#ifndef _WIN32
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace SimpleDrawingDemo {
+
+namespace {
+// 编辑器保存文件时常产生多次写入事件, 安静一段时间后再编译
+constexpr auto kDebounce = std::chrono::milliseconds(100);
+
+fs::path Normalize(const fs::path& path) {
+    std::error_code error;
+    fs::path result = fs::weakly_canonical(path, error);
+    return error ? path.lexically_normal() : result;
+}
+
+// 程序依赖的全部文件: 各阶段源文件及其#include的文件
+std::vector<fs::path> DependencyFiles(const std::vector<std::pair<GLenum, string>>& stages) {
+    std::vector<fs::path> files;
+    for (const auto& stage : stages) {
+        std::vector<string> includes;
+        Shader::Preprocess(stage.second, &includes);
+        files.push_back(Normalize(stage.second));
+        for (const string& include : includes) files.push_back(Normalize(include));
+    }
+    return files;
+}
+}
+
+ShaderReloader::ShaderReloader(GLFWwindow* mainWindow, const string& directory)
+    : m_directory(directory)
+{
+    // 与主窗口共享对象的隐藏窗口, 仅用作后台编译的上下文
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_context = glfwCreateWindow(1, 1, "shader compiler", NULL, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!m_context) {
+        std::cerr << "[ERROR_SHADER] 热重载共享上下文创建失败, 已禁用热重载" << std::endl;
+        return;
+    }
+
+#ifdef _WIN32
+    m_directoryHandle = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (m_directoryHandle == INVALID_HANDLE_VALUE) {
+        std::cerr << "[ERROR_SHADER] 无法监视着色器目录: " << directory << std::endl;
+    }
+#else
+    m_notifyFd = inotify_init1(IN_CLOEXEC);
+    if (m_notifyFd < 0) {
+        std::cerr << "[ERROR_SHADER] 无法监视着色器目录: " << directory << std::endl;
+    }
+#endif
+
+    m_watchThread = std::thread(&ShaderReloader::WatchThread, this);
+    m_compileThread = std::thread(&ShaderReloader::CompileThread, this);
+    std::cout << "[SHADER_RELOAD] 正在监视 " << directory << std::endl;
+}
+
+ShaderReloader::~ShaderReloader() {
+    m_running = false;
+#ifdef _WIN32
+    // 唤醒阻塞在ReadDirectoryChangesW上的监视线程
+    if (m_directoryHandle != INVALID_HANDLE_VALUE) CancelIoEx(m_directoryHandle, NULL);
+#endif
+    m_changed.notify_all();
+    if (m_watchThread.joinable()) m_watchThread.join();
+    if (m_compileThread.joinable()) m_compileThread.join();
+
+#ifdef _WIN32
+    if (m_directoryHandle != INVALID_HANDLE_VALUE) CloseHandle(m_directoryHandle);
+#else
+    if (m_notifyFd >= 0) close(m_notifyFd);
+#endif
+
+    // 丢弃尚未替换的新程序
+    for (Result& result : m_results) {
+        glDeleteSync(result.fence);
+        glDeleteProgram(result.id);
+    }
+    if (m_context) glfwDestroyWindow(m_context);
+}
+
+void ShaderReloader::Watch(const std::vector<std::pair<GLenum, string>>& stages, unsigned int* target,
+                           ReloadCallback onReload, const string& defines)
+{
+    Program program = { stages, defines, DependencyFiles(stages), target, std::move(onReload) };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_programs.push_back(std::move(program));
+}
+
+int ShaderReloader::Poll() {
+    std::vector<Result> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_results.size();) {
+            // 超时为0: 只查询, 不等待
+            GLenum status = glClientWaitSync(m_results[i].fence, 0, 0);
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                ready.push_back(m_results[i]);
+                m_results.erase(m_results.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    for (const Result& result : ready) {
+        glDeleteSync(result.fence);
+        Program& program = m_programs[result.program];
+
+        // 在两帧之间替换, 旧程序不再被引用后删除
+        unsigned int previous = *program.target;
+        *program.target = result.id;
+        if (previous) glDeleteProgram(previous);
+        if (program.onReload) program.onReload();
+
+        std::cout << "[SHADER_RELOAD] 已重新加载: " << program.stages.front().second << std::endl;
+    }
+    return static_cast<int>(ready.size());
+}
+
+void ShaderReloader::OnFileChanged(const fs::path& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(Normalize(path));
+    m_lastChange = std::chrono::steady_clock::now();
+    m_changed.notify_all();
+}
+
+#ifdef _WIN32
+void ShaderReloader::WatchThread() {
+    if (m_directoryHandle == INVALID_HANDLE_VALUE) return;
+
+    alignas(DWORD) char buffer[16 * 1024];
+    while (m_running) {
+        DWORD bytes = 0;
+        BOOL ok = ReadDirectoryChangesW(m_directoryHandle, buffer, sizeof(buffer), TRUE,
+            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, &bytes, NULL, NULL);
+        if (!ok) break;       // 被CancelIoEx取消或目录失效
+        if (bytes == 0) continue;   // 缓冲区溢出, 事件丢失
+
+        for (char* cursor = buffer;;) {
+            auto* info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(cursor);
+            std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            OnFileChanged(fs::path(m_directory) / name);
+            if (info->NextEntryOffset == 0) break;
+            cursor += info->NextEntryOffset;
+        }
+    }
+}
+#else
+void ShaderReloader::WatchThread() {
+    if (m_notifyFd < 0) return;
+
+    // inotify不递归, 为每个子目录单独添加监视
+    std::unordered_map<int, fs::path> directories;
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+    auto addWatch = [&](const fs::path& directory) {
+        int wd = inotify_add_watch(m_notifyFd, directory.c_str(), mask);
+        if (wd >= 0) directories[wd] = directory;
+    };
+    std::error_code error;
+    addWatch(m_directory);
+    for (const auto& entry : fs::recursive_directory_iterator(m_directory, error)) {
+        if (entry.is_directory()) addWatch(entry.path());
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (m_running) {
+        pollfd descriptor = { m_notifyFd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 200) <= 0) continue;   // 超时后检查m_running
+
+        ssize_t length = read(m_notifyFd, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;) {
+            auto* event = reinterpret_cast<inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if (event->len == 0 || !directories.count(event->wd)) continue;
+
+            fs::path path = directories[event->wd] / event->name;
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & IN_CREATE) addWatch(path);
+            } else {
+                OnFileChanged(path);
+            }
+        }
+    }
+}
+#endif
+
+void ShaderReloader::CompileThread() {
+    glfwMakeContextCurrent(m_context);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        m_changed.wait(lock, [&] { return !m_running || !m_pending.empty(); });
+        if (!m_running) break;
+
+        // 防抖: 等待文件安静下来
+        while (m_running && std::chrono::steady_clock::now() - m_lastChange < kDebounce) {
+            m_changed.wait_until(lock, m_lastChange + kDebounce);
+        }
+        std::vector<fs::path> changed;
+        changed.swap(m_pending);
+
+        // 找出受影响的程序(拷贝阶段信息, 编译时不持锁)
+        struct Job {
+            size_t index;
+            std::vector<std::pair<GLenum, string>> stages;
+            string defines;
+        };
+        std::vector<Job> jobs;
+        for (size_t i = 0; i < m_programs.size(); i++) {
+            const Program& program = m_programs[i];
+            bool affected = std::any_of(changed.begin(), changed.end(), [&](const fs::path& path) {
+                return std::find(program.files.begin(), program.files.end(), path) != program.files.end();
+            });
+            if (affected) jobs.push_back({ i, program.stages, program.defines });
+        }
+        if (jobs.empty()) continue;
+
+        lock.unlock();
+        std::vector<Result> results;
+        std::vector<std::pair<size_t, std::vector<fs::path>>> dependencies;
+        for (const auto& [index, stages, defines] : jobs) {
+            auto startTime = std::chrono::steady_clock::now();
+            unsigned int program = Shader::Build(stages, defines);
+
+            // 编译/链接错误已由Shader::Build输出, 这里只决定是否替换
+            int success = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (!success) {
+                glDeleteProgram(program);
+                std::cerr << "[SHADER_RELOAD] 构建失败, 继续使用旧程序: " << stages.front().second << std::endl;
+                continue;
+            }
+
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            std::cout << "[SHADER_RELOAD] 后台构建完成 (" << ms << " ms): " << stages.front().second << std::endl;
+            results.push_back({ index, program, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+
+            // #include可能增删, 重新收集依赖
+            dependencies.push_back({ index, DependencyFiles(stages) });
+        }
+        glFlush();   // 确保栅栏提交, 渲染线程才能观察到
+        lock.lock();
+
+        for (auto& [index, files] : dependencies) m_programs[index].files = std::move(files);
+
+        m_results.insert(m_results.end(), results.begin(), results.end());
+    }
+
+    glfwMakeContextCurrent(NULL);
+}
+}   // namespace SimpleDrawingDemo
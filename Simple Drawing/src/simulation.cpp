@@ -0,0 +1,266 @@
+// src/simulation.cpp
+#include "pch.h"
+#include "render_data.h"
+#include "defines.h"
+#include "profiler.h"
+#include "simulation.h"
+
+namespace SimpleDrawingDemo {
+
+Simulation::Simulation(GLFWwindow* window, const RenderData* data)
+    : m_window(window), m_worldUp(data->worldUp)
+{
+    m_state.cameraPos = data->cameraPos;
+    m_state.cameraFront = data->cameraFront;
+    m_state.cameraRight = data->cameraRight;
+    m_state.cameraUp = data->cameraUp;
+    m_state.accumulate = data->accumulate;
+    m_state.denoise = data->denoise;
+    m_state.temporal = data->temporal;
+    m_state.framebufferWidth = data->screenWidth;
+    m_state.framebufferHeight = data->screenHeight;
+    m_state.lightPos = LightPosition(0.0f);
+    m_idleEnabled = data->idle;
+
+    // 由初始朝向反推欧拉角, 避免第一次鼠标移动时视角跳变
+    m_yaw = glm::degrees(std::atan2(m_state.cameraFront.z, m_state.cameraFront.x));
+    m_pitch = glm::degrees(std::asin(std::clamp(m_state.cameraFront.y, -1.0f, 1.0f)));
+
+    glfwSetWindowUserPointer(window, this);
+    glfwSetCursorPosCallback(window, MousePosCallback);
+    glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
+    glfwSetWindowRefreshCallback(window, WindowRefreshCallback);
+
+    // 渲染线程启动时即有快照可用
+    Publish(glfwGetTime());
+}
+
+Simulation::~Simulation() {
+    glfwSetCursorPosCallback(m_window, NULL);
+    glfwSetFramebufferSizeCallback(m_window, NULL);
+    glfwSetWindowRefreshCallback(m_window, NULL);
+    glfwSetWindowUserPointer(m_window, NULL);
+}
+
+vec3 Simulation::LightPosition(float time) {
+    return vec3(
+        3.0f * sin(time * 0.5f),
+        4.0f + sin(time * 0.7f),
+        -8.0f + cos(time * 0.5f)
+    );
+}
+
+// 固定步长循环: 等待事件直到下一个步长, 落后时连续补足步长(不超过kMaxCatchUp)
+void Simulation::Run() {
+    const double interval = 1.0 / kTickRate;
+    double next = glfwGetTime();
+
+    while (!glfwWindowShouldClose(m_window)) {
+        double now = glfwGetTime();
+        if (now < next) {
+            // 空闲时只等待输入事件; 醒来后立即运行一个步长(按键状态在步长中查询)
+            bool idle = m_idleEnabled && now - m_lastActivity > kIdleDelay;
+            glfwWaitEventsTimeout(idle ? kIdleWait : next - now);
+            if (idle) {
+                m_idleWaits++;
+                next = glfwGetTime();
+            }
+
+            // 鼠标事件与重绘请求会提前唤醒: 立即发布, 不等下一个步长
+            if (m_state.cameraVersion != m_published.cameraVersion || m_state.refreshRequests != m_published.refreshRequests) {
+                Publish(glfwGetTime());
+            }
+            continue;
+        }
+        glfwPollEvents();
+
+        // 窗口拖动等阻塞后不追赶, 避免相机瞬移
+        if (now - next > kMaxCatchUp) next = now;
+
+        {
+            PROFILE_SCOPE("Simulate");
+            HandleKeys(now);
+            while (next <= now) {
+                Tick(static_cast<float>(interval));
+                next += interval;
+            }
+        }
+        Publish(now);
+    }
+}
+
+// 单个模拟步长: 按键状态 * 速度 * dt
+void Simulation::Tick(float dt) {
+    m_state.tick++;
+    m_state.time = static_cast<float>(m_state.tick / kTickRate);
+    m_state.lightPos = LightPosition(m_state.time);
+
+    // 仅在捕获鼠标时处理移动
+    if (!m_mouseCaptured) return;
+
+    vec3 direction(0.0f);
+    if (glfwGetKey(m_window, GLFW_KEY_W) == GLFW_PRESS) direction += m_state.cameraFront;
+    if (glfwGetKey(m_window, GLFW_KEY_S) == GLFW_PRESS) direction -= m_state.cameraFront;
+    if (glfwGetKey(m_window, GLFW_KEY_A) == GLFW_PRESS) direction -= m_state.cameraRight;
+    if (glfwGetKey(m_window, GLFW_KEY_D) == GLFW_PRESS) direction += m_state.cameraRight;
+    if (glfwGetKey(m_window, GLFW_KEY_SPACE) == GLFW_PRESS) direction += m_worldUp;
+    if (glfwGetKey(m_window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) direction -= m_worldUp;
+
+    // 相机移动, 重新开始累积
+    if (direction != vec3(0.0f)) {
+        m_state.cameraPos += kMoveSpeed * dt * direction;
+        m_state.cameraVersion++;
+    }
+}
+
+// 切换类按键(每批步长处理一次)
+void Simulation::HandleKeys(double now) {
+    // 处理ESC键切换鼠标捕获状态
+    if (glfwGetKey(m_window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+        // 防止重复触发
+        static double lastPressTime = 0.0;
+
+        if (now - lastPressTime > 0.5) { // 0.5秒防抖
+            m_mouseCaptured = !m_mouseCaptured;
+            glfwSetInputMode(m_window, GLFW_CURSOR,
+                m_mouseCaptured ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+
+            if (m_mouseCaptured) {
+                // 重新捕获鼠标时重置firstMouse标志
+                m_firstMouse = true;
+            }
+
+            lastPressTime = now;
+            std::cout << "Mouse capture: " << (m_mouseCaptured ? "ON" : "OFF") << std::endl;
+        }
+    }
+
+    // R键切换渐进累积模式
+    if (glfwGetKey(m_window, GLFW_KEY_R) == GLFW_PRESS) {
+        static double lastPressTime = 0.0;
+
+        if (now - lastPressTime > 0.5) { // 0.5秒防抖
+            m_state.accumulate = !m_state.accumulate;
+            lastPressTime = now;
+            std::cout << "Accumulation: " << (m_state.accumulate ? "ON" : "OFF") << std::endl;
+        }
+    }
+
+    // N键切换降噪
+    if (glfwGetKey(m_window, GLFW_KEY_N) == GLFW_PRESS) {
+        static double lastPressTime = 0.0;
+
+        if (now - lastPressTime > 0.5) { // 0.5秒防抖
+            m_state.denoise = !m_state.denoise;
+            lastPressTime = now;
+            std::cout << "Denoise: " << (m_state.denoise ? "ON" : "OFF") << std::endl;
+        }
+    }
+
+    // T键切换时域重投影
+    if (glfwGetKey(m_window, GLFW_KEY_T) == GLFW_PRESS) {
+        static double lastPressTime = 0.0;
+
+        if (now - lastPressTime > 0.5) { // 0.5秒防抖
+            m_state.temporal = !m_state.temporal;
+            lastPressTime = now;
+            std::cout << "Temporal reprojection: " << (m_state.temporal ? "ON" : "OFF") << std::endl;
+        }
+    }
+
+#if ENABLE_PROFILER
+    // F12导出性能trace并打印各pass统计(在渲染线程执行)
+    if (glfwGetKey(m_window, GLFW_KEY_F12) == GLFW_PRESS) {
+        static double lastPressTime = 0.0;
+
+        if (now - lastPressTime > 0.5) { // 0.5秒防抖
+            m_state.traceRequests++;
+            lastPressTime = now;
+        }
+    }
+#endif
+}
+
+// 根据欧拉角重新计算相机基向量
+void Simulation::UpdateOrientation() {
+    using namespace glm;
+
+    vec3 front;
+    front.x = cos(radians(m_yaw)) * cos(radians(m_pitch));
+    front.y = sin(radians(m_pitch));
+    front.z = sin(radians(m_yaw)) * cos(radians(m_pitch));
+    m_state.cameraFront = normalize(front);
+    m_state.cameraRight = normalize(cross(m_state.cameraFront, m_worldUp));
+    m_state.cameraUp = normalize(cross(m_state.cameraRight, m_state.cameraFront));
+
+    // 视角变化, 重新开始累积
+    m_state.cameraVersion++;
+}
+
+void Simulation::Publish(double now) {
+    // 影响画面或需要渲染线程处理的变化才算输入活动(只推进时间不算)
+    const FrameSnapshot& last = m_published;
+    if (m_state.cameraVersion != last.cameraVersion || m_state.accumulate != last.accumulate
+        || m_state.denoise != last.denoise || m_state.temporal != last.temporal
+        || m_state.framebufferWidth != last.framebufferWidth || m_state.framebufferHeight != last.framebufferHeight
+        || m_state.traceRequests != last.traceRequests || m_state.refreshRequests != last.refreshRequests) {
+        m_lastActivity = now;
+    }
+
+    m_state.sampleTime = now;
+    m_published = m_state;
+    m_snapshots.Publish(m_state);
+
+    // 加锁后再通知, 避免渲染线程检查完条件、尚未开始等待时错过通知
+    { std::lock_guard<std::mutex> lock(m_publishMutex); }
+    m_publishSignal.notify_one();
+}
+
+bool Simulation::WaitForSnapshot(double timeoutSeconds) {
+    std::unique_lock<std::mutex> lock(m_publishMutex);
+    return m_publishSignal.wait_for(lock, std::chrono::duration<double>(timeoutSeconds), [this] { return m_snapshots.Pending(); });
+}
+
+// 鼠标位置回调(在主线程的事件处理中调用)
+void Simulation::MousePosCallback(GLFWwindow* window, double xpos, double ypos) {
+    Simulation* simulation = static_cast<Simulation*>(glfwGetWindowUserPointer(window));
+    if (!simulation || !simulation->m_mouseCaptured) return;
+
+    if (simulation->m_firstMouse) {
+        simulation->m_lastX = xpos;
+        simulation->m_lastY = ypos;
+        simulation->m_firstMouse = false;
+    }
+
+    float xoffset = xpos - simulation->m_lastX;
+    float yoffset = simulation->m_lastY - ypos; // 反转Y轴
+    simulation->m_lastX = xpos;
+    simulation->m_lastY = ypos;
+    if (xoffset == 0.0f && yoffset == 0.0f) return;
+
+    simulation->m_yaw += xoffset * kMouseSensitivity;
+    simulation->m_pitch += yoffset * kMouseSensitivity;
+
+    // 限制俯仰角
+    simulation->m_pitch = std::clamp(simulation->m_pitch, -89.0f, 89.0f);
+
+    simulation->UpdateOrientation();
+}
+
+// 窗口大小变化回调: 只记录尺寸, 视口与渲染目标由渲染线程调整
+void Simulation::FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    Simulation* simulation = static_cast<Simulation*>(glfwGetWindowUserPointer(window));
+
+    // 最小化时尺寸为0, 保持原状
+    if (!simulation || width <= 0 || height <= 0) return;
+
+    simulation->m_state.framebufferWidth = width;
+    simulation->m_state.framebufferHeight = height;
+}
+
+// 窗口需要重绘(在主线程的事件处理中调用): 渲染线程在画面未变时只重新显示上一帧
+void Simulation::WindowRefreshCallback(GLFWwindow* window) {
+    Simulation* simulation = static_cast<Simulation*>(glfwGetWindowUserPointer(window));
+    if (simulation) simulation->m_state.refreshRequests++;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,74 @@
+// src/staging_buffer.cpp
+#include "pch.h"
+#include "staging_buffer.h"
+#include <cstring>
+
+namespace SimpleDrawingDemo {
+
+std::vector<DirtyRanges::Range> DirtyRanges::Coalesce(size_t maxGap) const {
+    std::vector<Range> sorted = m_ranges;
+    std::sort(sorted.begin(), sorted.end(), [](const Range& a, const Range& b) { return a.first < b.first; });
+
+    std::vector<Range> merged;
+    for (const Range& r : sorted) {
+        if (!merged.empty()) {
+            Range& last = merged.back();
+            size_t lastEnd = last.first + last.count;
+            if (r.first <= lastEnd + maxGap) {
+                last.count = std::max(lastEnd, r.first + r.count) - last.first;
+                continue;
+            }
+        }
+        merged.push_back(r);
+    }
+    return merged;
+}
+
+StagingBuffer::StagingBuffer(size_t slotSize) : m_slotSize(slotSize) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_buffer);
+    glNamedBufferStorage(m_buffer, m_slotSize * kSlots, nullptr, flags);
+    m_mapped = static_cast<char*>(glMapNamedBufferRange(m_buffer, 0, m_slotSize * kSlots, flags));
+}
+
+StagingBuffer::~StagingBuffer() {
+    for (GLsync fence : m_fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (m_buffer) {
+        glUnmapNamedBuffer(m_buffer);
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+void StagingBuffer::Upload(unsigned int buffer, size_t offset, const void* data, size_t size) {
+    if (size > m_slotSize - m_used) {
+        glNamedBufferSubData(buffer, offset, size, data);
+        return;
+    }
+
+    // 等待GPU复制完该槽位上一轮的数据(正常情况下三帧前早已完成, 不会阻塞)
+    if (!m_ready) {
+        if (GLsync fence = m_fences[m_slot]) {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+            glDeleteSync(fence);
+            m_fences[m_slot] = nullptr;
+        }
+        m_ready = true;
+    }
+
+    size_t source = m_slotSize * m_slot + m_used;
+    std::memcpy(m_mapped + source, data, size);
+    glCopyNamedBufferSubData(m_buffer, buffer, source, offset, size);
+    m_used += (size + 15) & ~size_t(15);   // 下一段保持16字节对齐
+    m_used = std::min(m_used, m_slotSize);
+}
+
+void StagingBuffer::Advance() {
+    if (!m_ready) return;
+    m_fences[m_slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_slot = (m_slot + 1) % kSlots;
+    m_used = 0;
+    m_ready = false;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,88 @@
+// src/temporal_reprojection.cpp
+#include "pch.h"
+#include "temporal_reprojection.h"
+#include "render_data.h"
+#include "shader.h"
+#include "defines.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+// 与temporal.glsl一致
+constexpr unsigned int kHistoryOutputUnit = 7;
+constexpr unsigned int kPrevHistoryTexture = 1;
+constexpr unsigned int kPrevNormalDepthTexture = 2;
+constexpr unsigned int kPrevAlbedoIdTexture = 3;
+}
+
+TemporalReprojection::TemporalReprojection(const string& defines) {
+    m_program = Shader::CreateComputeShader(ShaderPath(), defines);
+    Reflect();
+}
+
+TemporalReprojection::~TemporalReprojection() {
+    if (m_program) glDeleteProgram(m_program);
+}
+
+string TemporalReprojection::ShaderPath() {
+    return CSH_PATH + string("temporal.glsl");
+}
+
+void TemporalReprojection::Reflect() {
+    ProgramReflection reflection = Shader::Reflect(m_program);
+    m_prevCameraPosLocation = reflection.Location("prevCameraPos");
+    m_prevCameraFrontLocation = reflection.Location("prevCameraFront");
+    m_prevCameraRightLocation = reflection.Location("prevCameraRight");
+    m_prevCameraUpLocation = reflection.Location("prevCameraUp");
+    m_prevRenderSizeLocation = reflection.Location("prevRenderSize");
+    m_maxHistoryLocation = reflection.Location("maxHistory");
+}
+
+void TemporalReprojection::Resize(RenderTargetPool& pool, int width, int height) {
+    for (RenderTarget& target : m_history) pool.Reacquire(target, TargetFormat::RGBA16F, width, height);
+    pool.Reacquire(m_prevNormalDepth, TargetFormat::RGBA32F, width, height);
+    pool.Reacquire(m_prevAlbedoId, TargetFormat::RGBA32F, width, height);
+    Reset();
+}
+
+void TemporalReprojection::Release(RenderTargetPool& pool) {
+    for (RenderTarget& target : m_history) pool.Release(target);
+    pool.Release(m_prevNormalDepth);
+    pool.Release(m_prevAlbedoId);
+}
+
+void TemporalReprojection::Run(const RenderData& data) {
+    const RenderTarget& prevHistory = m_history[m_current];
+    m_current ^= 1;
+
+    glUseProgram(m_program);
+    glUniform3fv(m_prevCameraPosLocation, 1, &m_prevCameraPos[0]);
+    glUniform3fv(m_prevCameraFrontLocation, 1, &m_prevCameraFront[0]);
+    glUniform3fv(m_prevCameraRightLocation, 1, &m_prevCameraRight[0]);
+    glUniform3fv(m_prevCameraUpLocation, 1, &m_prevCameraUp[0]);
+    glUniform2i(m_prevRenderSizeLocation, m_prevWidth, m_prevHeight);
+    glUniform1f(m_maxHistoryLocation, kMaxHistory);
+
+    glBindTextureUnit(kPrevHistoryTexture, prevHistory.texture);
+    glBindTextureUnit(kPrevNormalDepthTexture, m_prevNormalDepth.texture);
+    glBindTextureUnit(kPrevAlbedoIdTexture, m_prevAlbedoId.texture);
+    glBindImageTexture(kHistoryOutputUnit, m_history[m_current].texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    glDispatchCompute((data.renderWidth + 15) / 16, (data.renderHeight + 15) / 16, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void TemporalReprojection::EndFrame(RenderData& data) {
+    std::swap(data.gbufferNormalDepth, m_prevNormalDepth);
+    std::swap(data.gbufferAlbedoId, m_prevAlbedoId);
+    data.BindGBuffer();
+
+    m_prevCameraPos = data.cameraPos;
+    m_prevCameraFront = data.cameraFront;
+    m_prevCameraRight = data.cameraRight;
+    m_prevCameraUp = data.cameraUp;
+    m_prevWidth = data.renderWidth;
+    m_prevHeight = data.renderHeight;
+    m_jitterIndex++;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,88 @@
+// src/thread_pool.cpp
+#include "pch.h"
+#include "thread_pool.h"
+
+namespace SimpleDrawingDemo {
+
+thread_local bool ThreadPool::t_inPool = false;
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    // 调用线程本身也会执行任务, 因此少创建一个
+    for (int i = 0; i < threadCount - 1; i++) {
+        m_threads.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) thread.join();
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::RunIndices(const std::function<void(int)>* job, int count) {
+    int index;
+    while ((index = m_next.fetch_add(1)) < count) {
+        (*job)(index);
+    }
+}
+
+void ThreadPool::WorkerMain() {
+    t_inPool = true;
+    unsigned long long seen = 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+        if (m_stop) return;
+        seen = m_generation;
+        if (!m_job) continue;   // 任务已被其他线程完成
+
+        const std::function<void(int)>* job = m_job;
+        int count = m_count;
+        m_active++;
+        lock.unlock();
+
+        RunIndices(job, count);
+
+        lock.lock();
+        if (--m_active == 0) m_done.notify_all();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) return;
+    if (t_inPool || m_threads.empty() || count == 1) {
+        for (int i = 0; i < count; i++) fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_count = count;
+        m_next = 0;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    t_inPool = true;
+    RunIndices(&fn, count);
+    t_inPool = false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&] { return m_active == 0; });
+    m_job = nullptr;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,78 @@
+// src/tile_binner.cpp
+#include "pch.h"
+#include "tile_binner.h"
+#include "render_data.h"
+#include "scene.h"
+#include "shader.h"
+#include "defines.h"
+
+namespace SimpleDrawingDemo {
+
+TileBinner::TileBinner(const string& defines) {
+    m_program = Shader::CreateComputeShader(ShaderPath(), defines);
+    Reflect();
+}
+
+TileBinner::~TileBinner() {
+    if (m_program) glDeleteProgram(m_program);
+    if (m_counts) {
+        glDeleteBuffers(1, &m_counts);
+        glDeleteBuffers(1, &m_primitives);
+    }
+}
+
+string TileBinner::Defines() {
+    return "#define TILE_BINNING\n#define TILE_CAPACITY " + std::to_string(kTileCapacity) + "\n";
+}
+
+string TileBinner::ShaderPath() {
+    return CSH_PATH + string("tile_binning.glsl");
+}
+
+void TileBinner::Reflect() {
+    ProgramReflection reflection = Shader::Reflect(m_program);
+    m_tileSizeLocation = reflection.Location("tileSize");
+    m_tileCountLocation = reflection.Location("tileCount");
+}
+
+size_t TileBinner::AllocatedBytes() const {
+    return m_capacity * (sizeof(unsigned int) + kTileCapacity * sizeof(int));
+}
+
+// 容量按块数分配, 只增不减(渲染区域变小或工作组变大时块数只会减少)
+void TileBinner::Reserve(size_t tiles) {
+    if (tiles <= m_capacity) return;
+    if (m_counts) {
+        glDeleteBuffers(1, &m_counts);
+        glDeleteBuffers(1, &m_primitives);
+    }
+    m_capacity = tiles;
+
+    glCreateBuffers(1, &m_counts);
+    glNamedBufferStorage(m_counts, m_capacity * sizeof(unsigned int), nullptr, 0);
+    glCreateBuffers(1, &m_primitives);
+    glNamedBufferStorage(m_primitives, m_capacity * kTileCapacity * sizeof(int), nullptr, 0);
+
+    std::cout << "[TILES] " << m_capacity << " 块, 显存 " << AllocatedBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+void TileBinner::Run(const RenderData& data) {
+    int tilesX = data.workgroup.GroupsX(data.renderWidth);
+    int tilesY = data.workgroup.GroupsY(data.renderHeight);
+    Reserve(static_cast<size_t>(tilesX) * tilesY);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_BINDING_COUNTS, m_counts);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_BINDING_PRIMITIVES, m_primitives);
+    glClearNamedBufferSubData(m_counts, GL_R32UI, 0, static_cast<size_t>(tilesX) * tilesY * sizeof(unsigned int),
+        GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    int primitives = data.scene->PrimitiveCount();
+    if (primitives > 0) {
+        glUseProgram(m_program);
+        glUniform2i(m_tileSizeLocation, data.workgroup.x, data.workgroup.y);
+        glUniform2i(m_tileCountLocation, tilesX, tilesY);
+        glDispatchCompute((primitives + kGroupSize - 1) / kGroupSize, 1, 1);
+    }
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,47 @@
+// src/uniform_ring.cpp
+#include "pch.h"
+#include "uniform_ring.h"
+#include <cstring>
+
+namespace SimpleDrawingDemo {
+
+UniformRing::UniformRing(size_t blockSize) : m_blockSize(blockSize) {
+    // 槽位偏移需满足UBO偏移对齐要求
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_stride = (blockSize + alignment - 1) / alignment * alignment;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_buffer);
+    glNamedBufferStorage(m_buffer, m_stride * kSlots, nullptr, flags);
+    m_mapped = static_cast<char*>(glMapNamedBufferRange(m_buffer, 0, m_stride * kSlots, flags));
+}
+
+UniformRing::~UniformRing() {
+    for (GLsync fence : m_fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (m_buffer) {
+        glUnmapNamedBuffer(m_buffer);
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+void UniformRing::Update(const void* data, unsigned int binding) {
+    // 等待GPU用完该槽位(正常情况下三帧前早已完成, 不会阻塞)
+    if (GLsync fence = m_fences[m_slot]) {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+        m_fences[m_slot] = nullptr;
+    }
+
+    size_t offset = m_stride * m_slot;
+    std::memcpy(m_mapped + offset, data, m_blockSize);
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_buffer, offset, m_blockSize);
+}
+
+void UniformRing::Advance() {
+    m_fences[m_slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_slot = (m_slot + 1) % kSlots;
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,157 @@
+// src/wavefront_tracer.cpp
+#include "pch.h"
+#include "wavefront_tracer.h"
+#include "shader.h"
+#include "defines.h"
+#include "profiler.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+// 与common/wavefront.glsl中的结构体大小一致
+constexpr size_t kPathRaySize = 4 * 4 * sizeof(float);
+constexpr size_t kShadowRaySize = 4 * 4 * sizeof(float);
+constexpr size_t kDispatchOffset = 16;
+
+void ClearCount(unsigned int buffer) {
+    glClearNamedBufferSubData(buffer, GL_R32UI, 0, sizeof(unsigned int), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+}
+
+WavefrontTracer::WavefrontTracer(const string& defines, int maxBounces)
+    : m_maxBounces(maxBounces)
+{
+    for (int pass = 0; pass < kPassCount; pass++) {
+        m_programs[pass] = Shader::CreateComputeShader(PassPath(static_cast<Pass>(pass)), defines);
+    }
+    Reflect();
+}
+
+WavefrontTracer::~WavefrontTracer() {
+    for (unsigned int program : m_programs) {
+        if (program) glDeleteProgram(program);
+    }
+    if (m_radiance) {
+        glDeleteBuffers(2, m_rayQueues);
+        glDeleteBuffers(1, &m_shadowQueue);
+        glDeleteBuffers(1, &m_radiance);
+    }
+}
+
+string WavefrontTracer::PassPath(Pass pass) {
+    static const char* const kFiles[kPassCount] = {
+        "generate.glsl", "extend.glsl", "shade.glsl", "dispatch.glsl", "shadow.glsl", "resolve.glsl", "finalize.glsl"
+    };
+    return CSH_PATH + string("wavefront/") + kFiles[pass];
+}
+
+void WavefrontTracer::Reflect() {
+    m_bounceLocation = Shader::Reflect(m_programs[Shade]).Location("bounce");
+}
+
+size_t WavefrontTracer::AllocatedBytes() const {
+    return 2 * (kQueueHeaderSize + m_capacity * kPathRaySize)
+         + kQueueHeaderSize + m_capacity * kShadowRaysPerPath * kShadowRaySize
+         + m_capacity * 4 * sizeof(float);
+}
+
+// 队列容量按像素数分配, 只增不减(渲染区域不超过渲染目标, 只在窗口变大时增长)
+void WavefrontTracer::Reserve(size_t pixels) {
+    if (pixels <= m_capacity) return;
+    if (m_radiance) {
+        glDeleteBuffers(2, m_rayQueues);
+        glDeleteBuffers(1, &m_shadowQueue);
+        glDeleteBuffers(1, &m_radiance);
+    }
+    m_capacity = pixels;
+
+    // 只在GPU端读写, 不需要映射
+    glCreateBuffers(2, m_rayQueues);
+    glCreateBuffers(1, &m_shadowQueue);
+    glCreateBuffers(1, &m_radiance);
+    for (unsigned int queue : m_rayQueues) {
+        glNamedBufferStorage(queue, kQueueHeaderSize + m_capacity * kPathRaySize, nullptr, 0);
+    }
+    glNamedBufferStorage(m_shadowQueue, kQueueHeaderSize + m_capacity * kShadowRaysPerPath * kShadowRaySize, nullptr, 0);
+    glNamedBufferStorage(m_radiance, m_capacity * 4 * sizeof(float), nullptr, 0);
+
+    std::cout << "[WAVEFRONT] 路径容量 " << m_capacity << ", 显存 "
+              << AllocatedBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+void WavefrontTracer::Render(int width, int height) {
+    Reserve(static_cast<size_t>(width) * height);
+
+    // 每个pass之间都依赖上一个pass写入的SSBO
+    const GLbitfield kStorage = GL_SHADER_STORAGE_BARRIER_BIT;
+    unsigned int current = m_rayQueues[0];
+    unsigned int next = m_rayQueues[1];
+
+    for (unsigned int queue : m_rayQueues) ClearCount(queue);
+    ClearCount(m_shadowQueue);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WAVEFRONT_BINDING_SHADOW_RAYS, m_shadowQueue);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WAVEFRONT_BINDING_RADIANCE, m_radiance);
+
+    // 主光线直接写入第一个队列(作为"next"绑定), 再换算分派参数
+    {
+        PROFILE_GPU_SCOPE("WF.Generate");
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WAVEFRONT_BINDING_NEXT_RAYS, current);
+        glUseProgram(m_programs[Generate]);
+        glDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+        glMemoryBarrier(kStorage);
+        glUseProgram(m_programs[Dispatch]);
+        glDispatchCompute(1, 1, 1);
+        glMemoryBarrier(kStorage | GL_COMMAND_BARRIER_BIT);
+    }
+
+    for (int bounce = 0; bounce < m_maxBounces; bounce++) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WAVEFRONT_BINDING_CURRENT_RAYS, current);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WAVEFRONT_BINDING_NEXT_RAYS, next);
+
+        // 本次反弹的三个pass都按current队列的长度分派
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, current);
+        {
+            PROFILE_GPU_SCOPE("WF.Extend");
+            glUseProgram(m_programs[Extend]);
+            glDispatchComputeIndirect(kDispatchOffset);
+            glMemoryBarrier(kStorage);
+        }
+        {
+            PROFILE_GPU_SCOPE("WF.Shade");
+            glUseProgram(m_programs[Shade]);
+            glUniform1i(m_bounceLocation, bounce);
+            glDispatchComputeIndirect(kDispatchOffset);
+            glMemoryBarrier(kStorage);
+            glUseProgram(m_programs[Dispatch]);
+            glDispatchCompute(1, 1, 1);
+            glMemoryBarrier(kStorage | GL_COMMAND_BARRIER_BIT);
+        }
+        {
+            PROFILE_GPU_SCOPE("WF.Shadow");
+            glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_shadowQueue);
+            glUseProgram(m_programs[Shadow]);
+            glDispatchComputeIndirect(kDispatchOffset);
+            glMemoryBarrier(kStorage);
+        }
+        {
+            PROFILE_GPU_SCOPE("WF.Resolve");
+            glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, current);
+            glUseProgram(m_programs[Resolve]);
+            glDispatchComputeIndirect(kDispatchOffset);
+            glMemoryBarrier(kStorage | GL_BUFFER_UPDATE_BARRIER_BIT);
+        }
+
+        // current清空后作为下一次反弹的输出队列
+        ClearCount(current);
+        ClearCount(m_shadowQueue);
+        std::swap(current, next);
+    }
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+
+    {
+        PROFILE_GPU_SCOPE("WF.Finalize");
+        glUseProgram(m_programs[Finalize]);
+        glDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+    }
+}
+}   // namespace SimpleDrawingDemo
@@ -0,0 +1,180 @@
+// src/workgroup_tuner.cpp
+#include "pch.h"
+#include "workgroup_tuner.h"
+#include "render_data.h"
+#include "defines.h"
+#include "main_loop.h"
+#include "gpu_timer.h"
+#include "benchmark.h"
+#include "simulation.h"
+#include "resolution_controller.h"
+
+namespace SimpleDrawingDemo {
+
+namespace {
+constexpr int kWarmupFrames = 4;     // 每个候选的预热帧数(首帧包含驱动的延迟编译)
+constexpr int kMeasuredFrames = 32;  // 每个候选的计时帧数
+
+string GLString(GLenum name) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    return value ? value : "";
+}
+}
+
+/* ------- 工作组形状 ------- */
+
+string WorkgroupSize::Defines() const {
+    return "#define LOCAL_SIZE_X " + std::to_string(x) + "\n"
+         + "#define LOCAL_SIZE_Y " + std::to_string(y) + "\n";
+}
+
+string WorkgroupSize::Name() const {
+    return std::to_string(x) + "x" + std::to_string(y);
+}
+
+bool WorkgroupSize::Supported() const {
+    int maxInvocations = 0, maxX = 0, maxY = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &maxInvocations);
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, 0, &maxX);
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, 1, &maxY);
+    return x > 0 && y > 0 && x <= maxX && y <= maxY && x * y <= maxInvocations;
+}
+
+// 解析"32x8"格式的工作组形状
+bool WorkgroupSize::Parse(const string& text, WorkgroupSize& out) {
+    size_t pos = text.find('x');
+    if (pos == string::npos) return false;
+    WorkgroupSize size;
+    try {
+        size.x = std::stoi(text.substr(0, pos));
+        size.y = std::stoi(text.substr(pos + 1));
+    } catch (...) {
+        return false;
+    }
+    if (size.x <= 0 || size.y <= 0) return false;
+    out = size;
+    return true;
+}
+
+/* ------- 自动调优 ------- */
+
+// 候选形状: 方形、宽条、窄条与一维, 调用数从64到1024
+const std::vector<WorkgroupSize>& WorkgroupTuner::Candidates() {
+    static const std::vector<WorkgroupSize> kCandidates = {
+        { 8, 8 }, { 16, 8 }, { 8, 16 }, { 16, 16 }, { 32, 4 }, { 32, 8 }, { 8, 32 }, { 64, 1 }, { 32, 16 }, { 32, 32 }
+    };
+    return kCandidates;
+}
+
+string WorkgroupTuner::DriverKey() {
+    return GLString(GL_VENDOR) + " | " + GLString(GL_RENDERER) + " | " + GLString(GL_VERSION);
+}
+
+bool WorkgroupTuner::Load(WorkgroupSize& out) {
+    std::ifstream file(AUTOTUNE_PATH);
+    if (!file) return false;
+
+    WorkgroupSize size;
+    try {
+        nlohmann::json root = nlohmann::json::parse(file);
+        if (!root.contains(DriverKey())) return false;
+        const nlohmann::json& localSize = root.at(DriverKey()).at("local_size");
+        size.x = localSize.at(0).get<int>();
+        size.y = localSize.at(1).get<int>();
+    } catch (std::exception& e) {
+        std::cerr << "[AUTOTUNE] 调优结果解析失败: " << AUTOTUNE_PATH << " (" << e.what() << ")" << std::endl;
+        return false;
+    }
+    if (!size.Supported()) return false;
+
+    out = size;
+    return true;
+}
+
+// 合并写入: 文件中其他驱动的结果保持不变
+void WorkgroupTuner::Save(const WorkgroupSize& best, const nlohmann::json& results, int width, int height) {
+    nlohmann::json root = nlohmann::json::object();
+    if (std::ifstream file(AUTOTUNE_PATH); file) {
+        try {
+            root = nlohmann::json::parse(file);
+        } catch (std::exception&) {}
+        if (!root.is_object()) root = nlohmann::json::object();
+    }
+
+    nlohmann::json& entry = root[DriverKey()];
+    entry["local_size"] = { best.x, best.y };
+    entry["width"] = width;
+    entry["height"] = height;
+    entry["median_gpu_ms"] = results;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(AUTOTUNE_PATH).parent_path(), error);
+    std::ofstream file(AUTOTUNE_PATH, std::ios::trunc);
+    file << root.dump(4) << std::endl;
+    if (!file) std::cerr << "[AUTOTUNE] 写入失败: " << AUTOTUNE_PATH << std::endl;
+}
+
+WorkgroupSize WorkgroupTuner::Run(GLFWwindow* window, RenderData* data) {
+    // 离屏计时, 暂停动态分辨率(渲染区域需在各候选之间保持一致)
+    bool presentEnabled = MainLoop::s_presentEnabled;
+    MainLoop::s_presentEnabled = false;
+    ResolutionController* resolution = data->resolution;
+    data->resolution = nullptr;
+
+    WorkgroupSize best = data->workgroup;
+    double bestMs = std::numeric_limits<double>::max();
+    nlohmann::json results = nlohmann::json::object();
+    std::cout << "[AUTOTUNE] " << GLString(GL_RENDERER) << ", " << data->renderWidth << "x" << data->renderHeight
+              << ", 每个候选 " << kMeasuredFrames << " 帧" << std::endl;
+
+    for (const WorkgroupSize& candidate : Candidates()) {
+        if (!candidate.Supported()) {
+            std::cout << "[AUTOTUNE] " << candidate.Name() << " 超出驱动上限, 跳过" << std::endl;
+            continue;
+        }
+        data->workgroup = candidate;
+        data->RebuildComputeShader();
+
+        // 与基准测试相同的固定相机路径, 各候选渲染完全相同的帧序列
+        GpuTimer timer;
+        std::vector<double> gpuTimes;
+        for (int i = 0; i < kWarmupFrames + kMeasuredFrames; i++) {
+            bool measured = i >= kWarmupFrames;
+            Benchmark::ApplyCameraPath(data, "orbit", measured ? float(i - kWarmupFrames) / kMeasuredFrames : 0.0f);
+            data->time = static_cast<float>(i) / 60.0f;
+            data->lightPos = Simulation::LightPosition(data->time);
+
+            if (measured) timer.Begin();
+            MainLoop::RenderLoop(window, data);
+            if (measured) timer.End();
+
+            double ms;
+            while (timer.Poll(ms)) gpuTimes.push_back(ms);
+        }
+        glFinish();
+        timer.Drain(gpuTimes);
+
+        double median = FrameStats::From(gpuTimes).median;
+        results[candidate.Name()] = median;
+        std::cout << "[AUTOTUNE] " << candidate.Name() << ": " << median << " ms" << std::endl;
+        if (!gpuTimes.empty() && median < bestMs) {
+            bestMs = median;
+            best = candidate;
+        }
+    }
+
+    data->workgroup = best;
+    data->RebuildComputeShader();
+    data->ResetAccumulation();
+    data->resolution = resolution;
+    MainLoop::s_presentEnabled = presentEnabled;
+
+    if (results.empty()) {
+        std::cerr << "[AUTOTUNE] 没有可用的候选形状, 保持 " << best.Name() << std::endl;
+        return best;
+    }
+    Save(best, results, data->renderWidth, data->renderHeight);
+    std::cout << "[AUTOTUNE] 选用 " << best.Name() << " (" << bestMs << " ms), 已保存到 " << AUTOTUNE_PATH << std::endl;
+    return best;
+}
+}   // namespace SimpleDrawingDemo